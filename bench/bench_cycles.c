@@ -0,0 +1,201 @@
+/*
+ * Measures the cost of the solver loop itself for cheap functions. Each
+ * method is run many times on each selected function; the latency of every
+ * solve is recorded to report its percentiles, and the hardware counters for
+ * cycles, instructions, and branch misses are read with perf_event_open. The
+ * counts of the timing itself (two roots_monotonic_time calls per solve) are
+ * measured once with an empty loop and subtracted. If the counters are
+ * unavailable (e.g., no permission or no PMU, as in many containers), only
+ * the latencies are reported.
+ *
+ * Methods marked (F) run a fixed number of iterations (see roots_fixed.c).
+ *
+ * Usage: bench_cycles [repetitions] [function indices (1-based) ...]
+ */
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "functions.h"
+#include "roots.h"
+
+#define N_COUNTERS 3
+
+typedef struct {
+  const char *name;
+  roots_method solve;
+} method;
+
+static const method methods[] = {
+  { "Bisection", roots_bisection },
+  { "Secant", roots_secant },
+  { "False position", roots_false_position },
+  { "Illinois", roots_illinois },
+  { "Pegasus", roots_pegasus },
+  { "Anderson-Bjorck", roots_anderson_bjorck },
+  { "Dekker's", roots_dekker },
+  { "Ridder's", roots_ridder },
+  { "Brent's", roots_brent },
+  { "TOMS748", roots_toms748 },
+  { "Steffensen's", roots_steffensen },
+  { "Muller's", roots_muller },
+  { "Multipoint", roots_multipoint },
+  { "Hybrid", roots_hybrid },
+  { "Bisection (F)", roots_bisection_fixed },
+  { "Ridder's (F)", roots_ridder_fixed },
+  { "Chandrupatla (F)", roots_chandrupatla_fixed },
+};
+
+// Group of hardware counters: cycles (leader), instructions, branch misses
+typedef struct {
+  int fd[N_COUNTERS];
+  bool available;
+} counters;
+
+static void counters_open(counters *c) {
+  const unsigned long long config[N_COUNTERS] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES
+  };
+  c->available = true;
+  for(int i = 0; i < N_COUNTERS; i++) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config[i];
+    attr.disabled = i == 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    c->fd[i] = syscall(SYS_perf_event_open, &attr, 0, -1, i ? c->fd[0] : -1, 0);
+    if(c->fd[i] < 0) {
+      c->available = false;
+      for(int j = 0; j < i; j++) {
+        close(c->fd[j]);
+      }
+      return;
+    }
+  }
+}
+
+static void counters_start(counters *c) {
+  if(c->available) {
+    ioctl(c->fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(c->fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+static bool counters_stop(counters *c, double values[N_COUNTERS]) {
+  if(!c->available) {
+    return false;
+  }
+  ioctl(c->fd[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  unsigned long long data[1 + N_COUNTERS];
+  if(read(c->fd[0], data, sizeof(data)) != sizeof(data)) {
+    return false;
+  }
+  for(int i = 0; i < N_COUNTERS; i++) {
+    values[i] = data[1 + i];
+  }
+  return true;
+}
+
+static void counters_close(counters *c) {
+  if(c->available) {
+    for(int i = 0; i < N_COUNTERS; i++) {
+      close(c->fd[i]);
+    }
+  }
+}
+
+static int compare(const void *a, const void *b) {
+  const double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv) {
+
+  // Step 1: Parse the command line
+  const int reps = argc > 1 ? atoi(argv[1]) : 10000;
+  int selected[N_FUNCTIONS], n_selected = 0;
+  for(int i = 2; i < argc; i++) {
+    const int k = atoi(argv[i]);
+    if(k >= 1 && k <= N_FUNCTIONS && n_selected < N_FUNCTIONS) {
+      selected[n_selected++] = k - 1;
+    }
+  }
+  if(!n_selected) {
+    for(int i = 0; i < N_FUNCTIONS; i++) {
+      selected[n_selected++] = i;
+    }
+  }
+  if(reps < 1) {
+    fprintf(stderr, "Usage: %s [repetitions] [function indices ...]\n", argv[0]);
+    return 1;
+  }
+
+  counters c;
+  counters_open(&c);
+  if(!c.available) {
+    printf("Hardware counters unavailable; reporting latencies only.\n");
+  }
+  double *latency = malloc(sizeof(double) * reps);
+  const int n_methods = sizeof(methods) / sizeof(*methods);
+
+  // Step 1.b: Count the timing loop without solves
+  double overhead[N_COUNTERS] = { 0 };
+  counters_start(&c);
+  for(int i = 0; i < reps; i++) {
+    const double t0 = roots_monotonic_time();
+    latency[i] = 1e9 * (roots_monotonic_time() - t0);
+  }
+  counters_stop(&c, overhead);
+
+  // Step 2: Run all methods on all selected functions
+  for(int k = 0; k < n_selected; k++) {
+    const test_function *fn = &functions[selected[k]];
+    printf("\nf%d = %s in [%g, %g], tolerance 1e-12, %d repetitions\n", selected[k] + 1,
+           fn->name, fn->a, fn->b, reps);
+    printf("%-16s %6s %6s %9s %9s %9s %9s %9s %9s %9s\n", "Method", "Iters", "Evals",
+           "p50(ns)", "p99(ns)", "p99.9(ns)", "Cycles", "Instrs", "BrMiss", "Cyc/iter");
+    for(int j = 0; j < n_methods; j++) {
+      roots_params r = { 0 };
+      r.max_iters = 1000;
+      r.tol = 1e-12;
+
+      // Step 2.a: Warm up, then time every solve
+      methods[j].solve(fn->f, NULL, fn->a, fn->b, &r);
+      double values[N_COUNTERS];
+      counters_start(&c);
+      for(int i = 0; i < reps; i++) {
+        const double t0 = roots_monotonic_time();
+        methods[j].solve(fn->f, NULL, fn->a, fn->b, &r);
+        latency[i] = 1e9 * (roots_monotonic_time() - t0);
+      }
+      const bool have_counters = counters_stop(&c, values);
+      for(int i = 0; have_counters && i < N_COUNTERS; i++) {
+        values[i] = fmax(0, values[i] - overhead[i]);
+      }
+
+      // Step 2.b: Report percentiles and counters per solve
+      qsort(latency, reps, sizeof(double), compare);
+      printf("%-16s %6u %6u %9.0f %9.0f %9.0f", methods[j].name, r.n_iters, r.n_evals,
+             latency[reps / 2], latency[(int)(0.99 * (reps - 1))],
+             latency[(int)(0.999 * (reps - 1))]);
+      if(have_counters) {
+        printf(" %9.0f %9.0f %9.2f %9.1f\n", values[0] / reps, values[1] / reps,
+               values[2] / reps, values[0] / reps / (r.n_iters ? r.n_iters : 1));
+      }
+      else {
+        printf(" %9s %9s %9s %9s\n", "-", "-", "-", "-");
+      }
+    }
+  }
+
+  counters_close(&c);
+  free(latency);
+
+  return 0;
+}
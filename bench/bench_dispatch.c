@@ -0,0 +1,80 @@
+/*
+ * Measures the vectorized kernels at the instruction set level selected when
+ * the library is loaded (see roots_isa): the batch methods on a cheap vector
+ * function, so that the bracket updates dominate, and roots_expr_fv on a
+ * polynomial. Run it with ROOTS_ISA=baseline, avx2, or avx512 to compare the
+ * levels, and against a build configured with -Dc_args=-march=native to check
+ * that the dispatched kernels match the native ones.
+ */
+#include "roots.h"
+
+#define N_PROBLEMS 4096
+#define REPS 50
+
+typedef roots_error_t (*batch_method)(
+      roots_vector_function fv,
+      void *restrict params,
+      const unsigned n,
+      const double *restrict a,
+      const double *restrict b,
+      double *restrict root,
+      roots_params *restrict r);
+
+// f(x) = x^3 - 2 at every point
+static void fv(
+      const unsigned n,
+      const double *restrict x,
+      void *restrict params,
+      double *restrict fx) {
+  (void)params;
+  for(unsigned i = 0; i < n; i++) {
+    fx[i] = x[i] * x[i] * x[i] - 2;
+  }
+}
+
+int main() {
+
+  static double a[N_PROBLEMS], b[N_PROBLEMS], root[N_PROBLEMS];
+  for(int i = 0; i < N_PROBLEMS; i++) {
+    a[i] = -1.0 - (double)i / N_PROBLEMS;
+    b[i] = 2.0 + (double)i / N_PROBLEMS;
+  }
+  printf("Instruction set level: %s\n", roots_isa());
+  printf("%-24s %12s\n", "Kernel", "ns/problem");
+
+  // Step 1: Batch methods
+  const batch_method methods[3]
+        = { roots_bisection_batch, roots_ridder_batch, roots_chandrupatla_batch };
+  const char *names[3]
+        = { "Bisection (batch)", "Ridder's (batch)", "Chandrupatla's (batch)" };
+  double sum = 0;
+  for(int k = 0; k < 3; k++) {
+    roots_params r = { 0 };
+    r.max_iters = 60;
+    r.tol = 1e-12;
+    const double t0 = roots_monotonic_time();
+    for(int j = 0; j < REPS; j++) {
+      methods[k](fv, NULL, N_PROBLEMS, a, b, root, &r);
+      sum += root[j];
+    }
+    const double t = roots_monotonic_time() - t0;
+    printf("%-24s %12.2f\n", names[k], 1e9 * t / (REPS * N_PROBLEMS));
+  }
+
+  // Step 2: Expression engine
+  roots_expr *e = roots_expr_compile("((x - 1)*x + 2)*x*x - 3*x + 0.5", 0, NULL, NULL);
+  roots_expr_params ep = { e, NULL };
+  const double t0 = roots_monotonic_time();
+  for(int j = 0; j < 20 * REPS; j++) {
+    roots_expr_fv(N_PROBLEMS, b, &ep, root);
+    sum += root[j];
+  }
+  const double t = roots_monotonic_time() - t0;
+  printf("%-24s %12.2f\n", "Expression (vector)", 1e9 * t / (20 * REPS * N_PROBLEMS));
+  roots_expr_free(e);
+  if(sum == 1234.5) {
+    printf("Unlikely\n");
+  }
+
+  return 0;
+}
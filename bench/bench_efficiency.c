@@ -0,0 +1,139 @@
+/*
+ * Measures the efficiency index achieved by each method on a set of test
+ * functions. The efficiency index of a method with order of convergence p
+ * that uses m function evaluations per iteration is p^(1/m). Empirically,
+ * if E_k is the smallest error after k function evaluations, then
+ * ln(E_k) ~ ln(E_0) EI^k, and we estimate EI from the evaluations made
+ * between the errors (relative to the initial interval width) 1e-2 and 1e-12.
+ */
+#include "functions.h"
+#include "roots.h"
+
+#define MAX_EVALS 4096
+
+typedef struct {
+  const char *name;
+  roots_error_t (*solve)(
+        double f(const double, void *restrict),
+        void *restrict,
+        double,
+        double,
+        roots_params *restrict);
+  double theoretical_ei;
+} method;
+
+typedef struct {
+  double (*f)(const double, void *restrict);
+  unsigned n;
+  double x[MAX_EVALS];
+} counter;
+
+static double counted(const double x, void *restrict p) {
+  counter *c = (counter *)p;
+  if(c->n < MAX_EVALS) {
+    c->x[c->n] = x;
+  }
+  c->n++;
+  return c->f(x, NULL);
+}
+
+static const method methods[] = {
+  { "Bisection", roots_bisection, 1.0 },
+  { "Secant", roots_secant, 1.618 },
+  { "False position", roots_false_position, 1.0 },
+  { "Illinois", roots_illinois, 1.442 },
+  { "Pegasus", roots_pegasus, 1.642 },
+  { "Anderson-Bjorck", roots_anderson_bjorck, 1.7 },
+  { "Dekker's", roots_dekker, 1.618 },
+  { "Ridder's", roots_ridder, 1.414 },
+  { "Brent's", roots_brent, 1.839 },
+  { "TOMS748", roots_toms748, 1.651 },
+  { "Steffensen's", roots_steffensen, 1.414 },
+  { "Muller's", roots_muller, 1.839 },
+  { "Multipoint", roots_multipoint, 1.587 },
+  { "Hybrid", roots_hybrid, 1.839 },
+};
+
+int main() {
+
+  const int n_functions = N_FUNCTIONS;
+  const int n_methods = sizeof(methods) / sizeof(*methods);
+
+  // Step 1: Compute the reference roots to machine precision
+  double roots[N_FUNCTIONS];
+  for(int i = 0; i < n_functions; i++) {
+    roots_params r = { 0 };
+    r.max_iters = 1000;
+    r.tol = 0.0;
+    roots_brent(functions[i].f, NULL, functions[i].a, functions[i].b, &r);
+    roots[i] = r.root;
+  }
+
+  // Step 2: Run all methods on all functions
+  printf("%-16s", "Method");
+  for(int i = 0; i < n_functions; i++) {
+    printf(" %4s%d", "f", i + 1);
+  }
+  printf(" %8s %8s %8s\n", "Evals", "EI", "EI(th)");
+  for(int j = 0; j < n_methods; j++) {
+    double log_ratio = 0;
+    unsigned evals = 0, total = 0;
+    printf("%-16s", methods[j].name);
+    for(int i = 0; i < n_functions; i++) {
+      static counter c;
+      c.f = functions[i].f;
+      c.n = 0;
+      roots_params r = { 0 };
+      r.max_iters = 1000;
+      r.tol = 1e-15;
+      methods[j].solve(counted, &c, functions[i].a, functions[i].b, &r);
+      total += c.n;
+      printf(" %5u", c.n);
+      if(r.error_key != roots_success) {
+        continue;
+      }
+
+      // Step 2.a: Find the evaluations at which the smallest error first
+      //           drops below 1e-2 and 1e-12 (relative to the interval).
+      const double width = fabs(functions[i].b - functions[i].a);
+      double best = 1, e0 = 1, e1 = 1;
+      int k0 = -1, k1 = -1;
+      for(unsigned k = 0; k < c.n && k < MAX_EVALS; k++) {
+        const double err = fabs(c.x[k] - roots[i]) / width;
+        best = err < best ? err : best;
+        if(k0 < 0 && best < 1e-2) {
+          k0 = k;
+          e0 = best;
+        }
+        if(k1 < 0 && best < 1e-12) {
+          k1 = k;
+          e1 = best > 1e-16 ? best : 1e-16;
+        }
+      }
+      if(k0 < 0 || k1 <= k0) {
+        continue;
+      }
+
+      // Step 2.b: Accumulate ln(ln E_k1 / ln E_k0) and the number of
+      //           evaluations between k0 and k1.
+      log_ratio += log(log(e1) / log(e0));
+      evals += k1 - k0;
+    }
+    printf(" %8u", total);
+    if(evals) {
+      printf(" %8.3f", exp(log_ratio / evals));
+    }
+    else {
+      printf(" %8s", "-");
+    }
+    printf(" %8.3f\n", methods[j].theoretical_ei);
+  }
+
+  printf("\nFunctions:\n");
+  for(int i = 0; i < n_functions; i++) {
+    printf("  f%d = %-20s in [%g, %g]\n", i + 1, functions[i].name, functions[i].a,
+           functions[i].b);
+  }
+
+  return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * Measures the cost of evaluating the test functions through the expression
+ * engine, relative to the hand-written callbacks: per point with roots_expr_f,
+ * per point with roots_expr_fv on arrays of points, and per solve with
+ * Brent's method. Note that the callback for x^5-0.5 calls pow, while the
+ * compiled expression uses three products.
+ */
+#include "functions.h"
+#include "roots.h"
+
+#define N_POINTS 4096
+#define REPS 200
+
+int main() {
+
+  double x[N_POINTS], fx[N_POINTS];
+  printf("Time per evaluation (ns) and per solve with Brent's method (us)\n");
+  printf("%-20s %6s %8s %8s %8s %8s %8s\n", "Function", "Instrs", "f", "expr_f",
+         "expr_fv", "Solve f", "Solve e");
+  for(int k = 0; k < N_FUNCTIONS; k++) {
+    const test_function *fn = &functions[k];
+    roots_expr *e = roots_expr_compile(fn->formula, 0, NULL, NULL);
+    roots_expr_params ep = { e, NULL };
+    for(int i = 0; i < N_POINTS; i++) {
+      x[i] = fn->a + (fn->b - fn->a) * (i + 0.5) / N_POINTS;
+    }
+
+    // Step 1: Evaluate with the callback, the scalar and the vector forms
+    double t[5], sum = 0;
+    double t0 = roots_monotonic_time();
+    for(int j = 0; j < REPS; j++) {
+      for(int i = 0; i < N_POINTS; i++) {
+        sum += fn->f(x[i], NULL);
+      }
+    }
+    t[0] = roots_monotonic_time() - t0;
+    t0 = roots_monotonic_time();
+    for(int j = 0; j < REPS; j++) {
+      for(int i = 0; i < N_POINTS; i++) {
+        sum += roots_expr_f(x[i], &ep);
+      }
+    }
+    t[1] = roots_monotonic_time() - t0;
+    t0 = roots_monotonic_time();
+    for(int j = 0; j < REPS; j++) {
+      roots_expr_fv(N_POINTS, x, &ep, fx);
+      sum += fx[j];
+    }
+    t[2] = roots_monotonic_time() - t0;
+
+    // Step 2: Solve with Brent's method
+    roots_params r = { 0 };
+    r.max_iters = 1000;
+    r.tol = 1e-12;
+    for(int m = 0; m < 2; m++) {
+      t0 = roots_monotonic_time();
+      for(int j = 0; j < 10 * REPS; j++) {
+        roots_brent(m ? roots_expr_f : fn->f, m ? (void *)&ep : NULL, fn->a, fn->b, &r);
+        sum += r.root;
+      }
+      t[3 + m] = roots_monotonic_time() - t0;
+    }
+    printf("%-20s %6u %8.2f %8.2f %8.2f %8.3f %8.3f\n", fn->name, roots_expr_size(e),
+           1e9 * t[0] / (REPS * N_POINTS), 1e9 * t[1] / (REPS * N_POINTS),
+           1e9 * t[2] / (REPS * N_POINTS), 1e6 * t[3] / (10 * REPS),
+           1e6 * t[4] / (10 * REPS));
+    roots_expr_free(e);
+    if(sum == 1234.5) {
+      printf("Unlikely\n");
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,69 @@
+/*
+ * Compares the number of iterations needed by the false position method and
+ * its modified variants (Illinois, Pegasus, and Anderson-Bjorck) on the
+ * benchmark functions. All variants use one function evaluation per
+ * iteration, so iterations and function evaluations differ only by the two
+ * evaluations at the end points of the initial interval.
+ */
+#include "functions.h"
+#include "roots.h"
+
+typedef struct {
+  const char *name;
+  roots_error_t (*solve)(
+        double f(const double, void *restrict),
+        void *restrict,
+        double,
+        double,
+        roots_params *restrict);
+} method;
+
+static const method methods[] = {
+  { "False position", roots_false_position },
+  { "Illinois", roots_illinois },
+  { "Pegasus", roots_pegasus },
+  { "Anderson-Bjorck", roots_anderson_bjorck },
+  { "Brent's", roots_brent },
+};
+
+int main() {
+
+  const int n_methods = sizeof(methods) / sizeof(*methods);
+  const double tols[] = { 1e-6, 1e-10, 1e-14 };
+
+  for(int t = 0; t < 3; t++) {
+    printf("Tolerance: %.0e\n", tols[t]);
+    printf("%-16s", "Method");
+    for(int i = 0; i < N_FUNCTIONS; i++) {
+      printf(" %4s%d", "f", i + 1);
+    }
+    printf(" %8s\n", "Total");
+    for(int j = 0; j < n_methods; j++) {
+      unsigned total = 0;
+      printf("%-16s", methods[j].name);
+      for(int i = 0; i < N_FUNCTIONS; i++) {
+        roots_params r = { 0 };
+        r.max_iters = 1000;
+        r.tol = tols[t];
+        methods[j].solve(functions[i].f, NULL, functions[i].a, functions[i].b, &r);
+        total += r.n_iters;
+        if(r.error_key == roots_success) {
+          printf(" %5u", r.n_iters);
+        }
+        else {
+          printf(" %5s", "fail");
+        }
+      }
+      printf(" %8u\n", total);
+    }
+    printf("\n");
+  }
+
+  printf("Functions:\n");
+  for(int i = 0; i < N_FUNCTIONS; i++) {
+    printf("  f%d = %-20s in [%g, %g]\n", i + 1, functions[i].name, functions[i].a,
+           functions[i].b);
+  }
+
+  return 0;
+}
@@ -0,0 +1,113 @@
+/*
+ * Counts the evaluations of g needed to solve x = g(x) to a tolerance of 1e-12
+ * with plain iteration (depth 0) and with Anderson acceleration of increasing
+ * depth. The problems are x = cos(x), Kepler's equation x = 1 + 0.9 sin(x)
+ * (|g'| close to 1 near the solution), and a chain of n coupled unknowns,
+ * x_i = 0.45 (x_{i-1} + x_{i+1}) + 0.05 sin(x_i) + 1, whose plain iteration
+ * contracts by ~0.95 per step. Time per solve is given for the largest chain.
+ */
+#include "roots.h"
+
+#define REPS 2000
+
+static void cosine(
+      const unsigned n,
+      const double *restrict x,
+      void *restrict p,
+      double *restrict gx) {
+  (void)n;
+  (void)p;
+  gx[0] = cos(x[0]);
+}
+
+static void kepler(
+      const unsigned n,
+      const double *restrict x,
+      void *restrict p,
+      double *restrict gx) {
+  (void)n;
+  (void)p;
+  gx[0] = 1 + 0.9 * sin(x[0]);
+}
+
+static void chain(
+      const unsigned n,
+      const double *restrict x,
+      void *restrict p,
+      double *restrict gx) {
+  (void)p;
+  for(unsigned i = 0; i < n; i++) {
+    const double left = i > 0 ? x[i - 1] : 0;
+    const double right = i < n - 1 ? x[i + 1] : 0;
+    gx[i] = 0.45 * (left + right) + 0.05 * sin(x[i]) + 1;
+  }
+}
+
+typedef struct {
+  const char *name;
+  roots_map g;
+  unsigned n;
+} problem;
+
+static const problem problems[] = {
+  { "x = cos(x)", cosine, 1 },
+  { "Kepler", kepler, 1 },
+  { "Chain (n = 8)", chain, 8 },
+  { "Chain (n = 64)", chain, 64 },
+};
+
+#define N_PROBLEMS (int)(sizeof(problems) / sizeof(*problems))
+
+static const unsigned depths[] = { 0, 1, 2, 3, 5, 10 };
+
+#define N_DEPTHS (int)(sizeof(depths) / sizeof(*depths))
+
+int main() {
+
+  printf("Evaluations of g, tolerance 1e-12\n");
+  printf("%-16s", "Depth");
+  for(int d = 0; d < N_DEPTHS; d++) {
+    printf(" %6u", depths[d]);
+  }
+  printf("\n");
+  double x[64];
+  roots_params r = { 0 };
+  r.max_iters = 100000;
+  r.tol = 1e-12;
+  for(int k = 0; k < N_PROBLEMS; k++) {
+    printf("%-16s", problems[k].name);
+    for(int d = 0; d < N_DEPTHS; d++) {
+      for(unsigned i = 0; i < problems[k].n; i++) {
+        x[i] = 0;
+      }
+      roots_fixed_point(problems[k].g, NULL, problems[k].n, depths[d], 1, x, &r);
+      if(r.error_key == roots_success) {
+        printf(" %6u", r.n_evals);
+      }
+      else {
+        printf(" %6s", "-");
+      }
+    }
+    printf("\n");
+  }
+
+  printf("\nTime per solve (us), chain with n = 64\n");
+  double sum = 0;
+  for(int d = 0; d < N_DEPTHS; d++) {
+    const double t0 = roots_monotonic_time();
+    for(int j = 0; j < REPS; j++) {
+      for(unsigned i = 0; i < 64; i++) {
+        x[i] = 0;
+      }
+      roots_fixed_point(chain, NULL, 64, depths[d], 1, x, &r);
+      sum += x[0];
+    }
+    const double t = roots_monotonic_time() - t0;
+    printf("  depth %2u: %10.3f\n", depths[d], 1e6 * t / REPS);
+  }
+  if(sum == 1234.5) {
+    printf("Unlikely\n");
+  }
+
+  return 0;
+}
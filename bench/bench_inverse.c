@@ -0,0 +1,72 @@
+/*
+ * Measures the number of function evaluations needed to invert a monotone
+ * function at many targets with roots_inverse, compared with solving for each
+ * target independently with Brent's method. The function is the cumulative
+ * distribution function of the standard normal distribution and the targets
+ * are equally spaced probabilities.
+ */
+#include "roots.h"
+
+typedef struct {
+  double y;
+  unsigned n_evals;
+} target;
+
+static double cdf(const double x, void *restrict p) {
+  if(p) {
+    ((target *)p)->n_evals++;
+  }
+  return 0.5 * erfc(-x / sqrt(2));
+}
+
+static double shifted_cdf(const double x, void *restrict p) {
+  return cdf(x, p) - ((target *)p)->y;
+}
+
+int main() {
+
+  const int ns[] = { 1, 10, 100, 1000, 10000, 100000 };
+  const int n_max = 100000;
+  double *x = malloc(sizeof(double) * n_max);
+  double *y = malloc(sizeof(double) * n_max);
+
+  printf("Tolerance: 1e-12\n");
+  printf("%8s %12s %12s %12s %12s\n", "Targets", "Brent", "Inverse", "Per target",
+         "Max error");
+  for(unsigned j = 0; j < sizeof(ns) / sizeof(*ns); j++) {
+    const int n = ns[j];
+    for(int i = 0; i < n; i++) {
+      y[i] = (i + 0.5) / n;
+    }
+
+    // Step 1: Solve for each target independently
+    target t = { 0, 0 };
+    for(int i = 0; i < n; i++) {
+      roots_params r = { 0 };
+      r.max_iters = 1000;
+      r.tol = 1e-12;
+      t.y = y[i];
+      roots_brent(shifted_cdf, &t, -10, 10, &r);
+      x[i] = r.root;
+    }
+
+    // Step 2: Solve for all targets at once; compare to the results above
+    double *xi = malloc(sizeof(double) * n);
+    roots_params r = { 0 };
+    r.max_iters = 1000;
+    r.tol = 1e-12;
+    roots_inverse(cdf, NULL, -10, 10, n, y, xi, &r);
+    double err = 0;
+    for(int i = 0; i < n; i++) {
+      err = fmax(err, fabs(xi[i] - x[i]));
+    }
+    free(xi);
+    printf("%8d %12u %12u %12.3f %12.2e\n", n, t.n_evals, r.n_evals,
+           (double)r.n_evals / n, err);
+  }
+
+  free(x);
+  free(y);
+
+  return 0;
+}
@@ -0,0 +1,99 @@
+/*
+ * Measures the latency of parallel k-section against Brent's method. The
+ * latency is counted in sequential function evaluations: every evaluation
+ * made by Brent's method, and every round of k-section (plus the two
+ * evaluations at the end points of the initial interval). The wall time is
+ * then measured for a function that takes about one millisecond to evaluate.
+ */
+#include <time.h>
+
+#include "functions.h"
+#include "roots.h"
+
+static const unsigned ks[] = { 1, 3, 7, 15, 31 };
+#define N_KS (int)(sizeof(ks) / sizeof(*ks))
+
+static double expensive(const double x, void *restrict p) {
+  (void)p;
+  const struct timespec t = { 0, 1000000 };
+  nanosleep(&t, NULL);
+  return kepler(x, NULL);
+}
+
+int main() {
+
+  const double tol = 1e-12;
+
+  // Step 1: Latency in sequential function evaluations
+  printf("Tolerance: %.0e\n", tol);
+  printf("%-16s", "Method");
+  for(int i = 0; i < N_FUNCTIONS; i++) {
+    printf(" %4s%d", "f", i + 1);
+  }
+  printf(" %8s %8s\n", "Total", "Evals");
+  for(int j = -1; j < N_KS; j++) {
+    unsigned total = 0, evals = 0;
+    char name[32];
+    roots_thread_pool *pool = NULL;
+    if(j < 0) {
+      sprintf(name, "Brent's");
+    }
+    else {
+      sprintf(name, "k-section (%u)", ks[j]);
+      pool = roots_thread_pool_create(ks[j] + 1);
+    }
+    printf("%-16s", name);
+    for(int i = 0; i < N_FUNCTIONS; i++) {
+      roots_params r = { 0 };
+      r.max_iters = 1000;
+      r.tol = tol;
+      unsigned latency;
+      if(j < 0) {
+        roots_brent(functions[i].f, NULL, functions[i].a, functions[i].b, &r);
+        latency = r.n_evals;
+      }
+      else {
+        roots_ksection(functions[i].f, NULL, functions[i].a, functions[i].b, ks[j],
+                       pool, &r);
+        latency = r.n_iters + 2;
+      }
+      total += latency;
+      evals += r.n_evals;
+      if(r.error_key == roots_success) {
+        printf(" %5u", latency);
+      }
+      else {
+        printf(" %5s", "fail");
+      }
+    }
+    printf(" %8u %8u\n", total, evals);
+    roots_thread_pool_destroy(pool);
+  }
+
+  // Step 2: Wall time for an expensive function
+  printf("\nWall time for f4 with a 1 ms evaluation cost:\n");
+  for(int j = -1; j < N_KS; j++) {
+    roots_params r = { 0 };
+    r.max_iters = 1000;
+    r.tol = tol;
+    const double t0 = roots_monotonic_time();
+    if(j < 0) {
+      roots_brent(expensive, NULL, functions[3].a, functions[3].b, &r);
+    }
+    else {
+      roots_thread_pool *pool = roots_thread_pool_create(ks[j] + 1);
+      roots_ksection(expensive, NULL, functions[3].a, functions[3].b, ks[j], pool, &r);
+      roots_thread_pool_destroy(pool);
+    }
+    const double t1 = roots_monotonic_time();
+    printf("  %-24s : %7.2f ms\n", r.method, 1e3 * (t1 - t0));
+  }
+
+  printf("\nFunctions:\n");
+  for(int i = 0; i < N_FUNCTIONS; i++) {
+    printf("  f%d = %-20s in [%g, %g]\n", i + 1, functions[i].name, functions[i].a,
+           functions[i].b);
+  }
+
+  return 0;
+}
@@ -0,0 +1,52 @@
+/*
+ * Measures the number of iterations needed to find the roots of
+ * f(x) = (x-1)^m exp(x) for m = 1, 3, 5, 7, and the multiplicity estimated by
+ * each method (see roots_params), on [0,3.3] with tolerance 1e-12. The
+ * factor exp(x) makes the estimates of the multiplicity less accurate far from
+ * the root. False position converges slowly even with the exact multiplicity,
+ * since one end point of the bracket stays fixed (see the modified variants).
+ */
+#include "roots.h"
+
+typedef struct {
+  const char *name;
+  roots_method solve;
+} method;
+
+static const method methods[] = {
+  { "Secant", roots_secant },
+  { "False position", roots_false_position },
+  { "Dekker's", roots_dekker },
+  { "Brent's", roots_brent },
+  { "TOMS748", roots_toms748 },
+  { "Bisection", roots_bisection },
+};
+
+#define N_METHODS (int)(sizeof(methods) / sizeof(*methods))
+
+static double f(const double x, void *restrict p) {
+  return pow(x - 1, *(int *)p) * exp(x);
+}
+
+int main() {
+
+  printf("Iterations (estimated multiplicity) for (x-1)^m exp(x)\n");
+  printf("%-16s", "Method");
+  for(int m = 1; m <= 7; m += 2) {
+    printf("         m=%d", m);
+  }
+  printf("\n");
+  for(int j = 0; j < N_METHODS; j++) {
+    printf("%-16s", methods[j].name);
+    for(int m = 1; m <= 7; m += 2) {
+      roots_params r = { 0 };
+      r.max_iters = 1000;
+      r.tol = 1e-12;
+      methods[j].solve(f, &m, 0, 3.3, &r);
+      printf(" %5u (%4.2f)", r.n_iters, r.multiplicity);
+    }
+    printf("\n");
+  }
+
+  return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * Measures the time per solve of a function whose evaluation is dominated by
+ * work that does not depend on x: interpolating the coefficients of a
+ * polynomial in a table indexed by log(T), and normalizing them by Y^(1/3).
+ * The plain function repeats this work in every evaluation; the prepared one
+ * (see roots_solve_prepared) does it once per solve.
+ */
+#include "roots.h"
+
+#define REPS 20000
+#define N_TABLE 64
+#define DEGREE 5
+
+typedef struct {
+  double T, Y;
+} state;
+
+typedef struct {
+  double c[DEGREE + 1];
+} coefficients;
+
+static double table[N_TABLE][DEGREE + 1];
+
+static void setup(const state *restrict s, coefficients *restrict cf) {
+  const double u = (log(s->T) + 5) / 15 * (N_TABLE - 1);
+  const int i = u < 0 ? 0 : (u >= N_TABLE - 1 ? N_TABLE - 2 : (int)u);
+  const double w = u - i;
+  const double norm = cbrt(s->Y);
+  for(int k = 0; k <= DEGREE; k++) {
+    cf->c[k] = ((1 - w) * table[i][k] + w * table[i + 1][k]) * norm;
+  }
+  cf->c[0] -= 8 * s->Y;
+}
+
+static double polynomial(const double x, const coefficients *restrict cf) {
+  double y = cf->c[DEGREE];
+  for(int k = DEGREE - 1; k >= 0; k--) {
+    y = y * x + cf->c[k];
+  }
+  return y;
+}
+
+static double plain(const double x, void *restrict params) {
+  coefficients cf;
+  setup((const state *)params, &cf);
+  return polynomial(x, &cf);
+}
+
+static void prepare(const void *restrict params, void *restrict scratch) {
+  setup((const state *)params, (coefficients *)scratch);
+}
+
+static double eval(const double x, void *restrict scratch) {
+  return polynomial(x, (const coefficients *)scratch);
+}
+
+int main() {
+
+  for(int i = 0; i < N_TABLE; i++) {
+    for(int k = 0; k <= DEGREE; k++) {
+      table[i][k] = (1 + 0.01 * i) / (1 + k);
+    }
+  }
+  const roots_prepared_function pf = { sizeof(coefficients), prepare, eval };
+  state states[REPS];
+  for(int j = 0; j < REPS; j++) {
+    states[j].T = exp(-5 + 15.0 * j / REPS);
+    states[j].Y = 0.5 + (double)j / REPS;
+  }
+
+  printf("Time per solve (us) and evaluations, Brent's method, tolerance 1e-12\n");
+  roots_params r = { 0 };
+  r.max_iters = 300;
+  r.tol = 1e-12;
+  double sum = 0;
+  unsigned n_evals = 0;
+  double t0 = roots_monotonic_time();
+  for(int j = 0; j < REPS; j++) {
+    roots_brent(plain, &states[j], 0, 2, &r);
+    sum += r.root;
+    n_evals += r.n_evals;
+  }
+  double dt = roots_monotonic_time() - t0;
+  printf("%-20s %10.3f %10.2f\n", "Plain", 1e6 * dt / REPS, (double)n_evals / REPS);
+
+  n_evals = 0;
+  t0 = roots_monotonic_time();
+  for(int j = 0; j < REPS; j++) {
+    roots_solve_prepared(roots_brent, &pf, &states[j], 0, 2, &r);
+    sum += r.root;
+    n_evals += r.n_evals;
+  }
+  dt = roots_monotonic_time() - t0;
+  printf("%-20s %10.3f %10.2f\n", "Prepared", 1e6 * dt / REPS, (double)n_evals / REPS);
+
+  static double a[REPS], b[REPS], root[REPS];
+  for(int j = 0; j < REPS; j++) {
+    a[j] = 0;
+    b[j] = 2;
+  }
+  t0 = roots_monotonic_time();
+  roots_solve_prepared_batch(
+        roots_brent, &pf, states, sizeof(state), REPS, a, b, root, NULL, &r);
+  dt = roots_monotonic_time() - t0;
+  printf("%-20s %10.3f %10.2f\n", "Prepared (batch)", 1e6 * dt / REPS,
+         (double)r.n_evals / REPS);
+  for(int j = 0; j < REPS; j++) {
+    sum += root[j];
+  }
+  if(sum == 1234.5) {
+    printf("Unlikely\n");
+  }
+
+  return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * Measures the number of evaluations of the exact function needed with and
+ * without a surrogate. The surrogate of each test function is the function
+ * itself plus a small constant, so that its root is off by about 1e-4/f'; the
+ * estimated error passed to roots_surrogate is 1e-3 times the width of the
+ * initial interval.
+ */
+#include "functions.h"
+#include "roots.h"
+
+typedef struct {
+  const char *name;
+  roots_method solve;
+} method;
+
+static const method methods[] = {
+  { "Illinois", roots_illinois },
+  { "Ridder's", roots_ridder },
+  { "Brent's", roots_brent },
+  { "TOMS748", roots_toms748 },
+};
+
+#define N_METHODS (int)(sizeof(methods) / sizeof(*methods))
+
+static double surrogate(const double x, void *restrict p) {
+  return ((const test_function *)p)->f(x, NULL) + 1e-4;
+}
+
+int main() {
+
+  printf("Exact function evaluations (without / with surrogate), tolerance 1e-12\n");
+  printf("%-20s", "Function");
+  for(int j = 0; j < N_METHODS; j++) {
+    printf(" %16s", methods[j].name);
+  }
+  printf("\n");
+  unsigned total[N_METHODS][3] = { { 0 } };
+  for(int k = 0; k < N_FUNCTIONS; k++) {
+    const test_function *fn = &functions[k];
+    printf("%-20s", fn->name);
+    for(int j = 0; j < N_METHODS; j++) {
+      roots_params r = { 0 }, t = { 0 };
+      r.max_iters = t.max_iters = 1000;
+      r.tol = t.tol = 1e-12;
+      methods[j].solve(fn->f, NULL, fn->a, fn->b, &r);
+      roots_surrogate(methods[j].solve, fn->f, NULL, surrogate, (void *)fn, fn->a, fn->b,
+                      1e-3 * (fn->b - fn->a), &t);
+      printf("       %4u / %3u", r.n_evals, t.n_evals);
+      total[j][0] += r.n_evals;
+      total[j][1] += t.n_evals;
+      total[j][2] += t.n_surrogate_evals;
+    }
+    printf("\n");
+  }
+  printf("%-20s", "Total");
+  for(int j = 0; j < N_METHODS; j++) {
+    printf("       %4u / %3u", total[j][0], total[j][1]);
+  }
+  printf("\n%-20s", "Surrogate evals");
+  for(int j = 0; j < N_METHODS; j++) {
+    printf(" %16u", total[j][2]);
+  }
+  printf("\n");
+
+  return 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * Measures the number of iterations needed on brackets spanning many orders
+ * of magnitude, [1e-12,1e15], for each bisection mode (see
+ * roots_bisection_mode). The functions are f(x) = x/x0 - 1 and
+ * f(x) = log(x/x0), and the tolerance is relative to the root x0.
+ */
+#include "roots.h"
+
+typedef struct {
+  const char *name;
+  roots_method solve;
+} method;
+
+static const method methods[] = {
+  { "Bisection", roots_bisection },
+  { "Brent's", roots_brent },
+  { "TOMS748", roots_toms748 },
+};
+
+#define N_METHODS (int)(sizeof(methods) / sizeof(*methods))
+
+static const double roots[] = { 1e-10, 1e-5, 1, 1e5, 1e10 };
+
+#define N_ROOTS (int)(sizeof(roots) / sizeof(*roots))
+
+static double linear(const double x, void *restrict p) { return x / *(double *)p - 1; }
+
+static double logarithm(const double x, void *restrict p) {
+  return log(x / *(double *)p);
+}
+
+int main() {
+
+  const char *modes[] = { "linear", "log", "bits" };
+  double (*const fs[])(const double, void *restrict) = { linear, logarithm };
+  const char *names[] = { "x/x0-1", "log(x/x0)" };
+
+  printf("Iterations on [1e-12,1e15], relative tolerance 1e-12\n");
+  printf("%-10s %-10s %-7s", "Method", "Function", "Mode");
+  for(int i = 0; i < N_ROOTS; i++) {
+    printf(" x0=%-7.0e", roots[i]);
+  }
+  printf(" %6s\n", "Total");
+  for(int j = 0; j < N_METHODS; j++) {
+    for(int k = 0; k < 2; k++) {
+      for(int m = 0; m < 3; m++) {
+        printf("%-10s %-10s %-7s", methods[j].name, names[k], modes[m]);
+        unsigned total = 0;
+        for(int i = 0; i < N_ROOTS; i++) {
+          roots_params r;
+          roots_params_init(&r);
+          r.max_iters = 1000;
+          r.tol = 1e-12 * roots[i];
+          r.bisect = m;
+          methods[j].solve(fs[k], (void *)&roots[i], 1e-12, 1e15, &r);
+          printf(" %10u", r.n_iters);
+          total += r.n_iters;
+          if(r.error_key != roots_success || fabs(r.root / roots[i] - 1) > 1e-11) {
+            printf("!");
+          }
+        }
+        printf(" %6u\n", total);
+      }
+    }
+  }
+
+  return 0;
+}
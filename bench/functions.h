@@ -0,0 +1,70 @@
+#ifndef FUNCTIONS_H_
+#define FUNCTIONS_H_
+
+/*
+ * Test functions shared by the benchmarks. Every function has a single
+ * simple root inside the interval [a,b] listed in the table below.
+ */
+#include "roots.h"
+
+typedef struct {
+  const char *name;
+  double (*f)(const double, void *restrict);
+  double a, b;
+  const char *formula; // f in the syntax of roots_expr_compile
+} test_function;
+
+static double quadratic(const double x, void *restrict p) {
+  (void)p;
+  return (x - 1.234) * (x + 111);
+}
+
+static double cubic(const double x, void *restrict p) {
+  (void)p;
+  return x * x * x - 2 * x - 5;
+}
+
+static double exponential(const double x, void *restrict p) {
+  (void)p;
+  return exp(x) - 2;
+}
+
+static double kepler(const double x, void *restrict p) {
+  (void)p;
+  return x - 0.9 * sin(x) - 1;
+}
+
+static double cosine(const double x, void *restrict p) {
+  (void)p;
+  return cos(x) - x;
+}
+
+static double logarithm(const double x, void *restrict p) {
+  (void)p;
+  return log(x);
+}
+
+static double quintic(const double x, void *restrict p) {
+  (void)p;
+  return pow(x, 5) - 0.5;
+}
+
+static double arctan(const double x, void *restrict p) {
+  (void)p;
+  return atan(x - 1);
+}
+
+static const test_function functions[] = {
+  { "(x-1.234)(x+111)", quadratic, 0, 200, "(x-1.234)*(x+111)" },
+  { "x^3-2x-5", cubic, 2, 3, "x^3-2*x-5" },
+  { "exp(x)-2", exponential, 0, 2, "exp(x)-2" },
+  { "x-0.9sin(x)-1", kepler, 0, 3, "x-0.9*sin(x)-1" },
+  { "cos(x)-x", cosine, 0, 1, "cos(x)-x" },
+  { "log(x)", logarithm, 0.5, 5, "log(x)" },
+  { "x^5-0.5", quintic, 0, 2, "pow(x,5)-0.5" },
+  { "atan(x-1)", arctan, -5, 10, "atan(x-1)" },
+};
+
+#define N_FUNCTIONS (int)(sizeof(functions) / sizeof(*functions))
+
+#endif  // FUNCTIONS_H_
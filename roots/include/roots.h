@@ -4,26 +4,113 @@
 #include <math.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "roots_dual.h"
+
+// C++ has no restrict; the keyword is mapped to the common extension within
+// this header only, so that it does not leak into the code that includes it
+#if defined(__cplusplus) && !defined(restrict)
+#define restrict __restrict
+#define ROOTS_UNDEF_RESTRICT_
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef enum {
   roots_continue = -1,
   roots_success,
   roots_error_root_not_bracketed,
-  roots_error_max_iter
+  roots_error_max_iter,
+  roots_error_max_evals,
+  roots_error_deadline,
+  roots_error_alloc
 } roots_error_t;
 
+// How bisection steps split the interval [a,b]: at its midpoint, at the
+// geometric mean of a and b, or at the midpoint of the integer
+// representations of a and b. The last two suit intervals spanning many
+// orders of magnitude.
+typedef enum {
+  roots_bisect_linear,
+  roots_bisect_log,
+  roots_bisect_bits
+} roots_bisection_mode;
+
+// Trace of function evaluations, see roots_trace_open
+typedef struct roots_trace roots_trace;
+
+// Last evaluations of f, from which f'(root) is estimated (see roots_params)
+typedef struct {
+  double x[32], f[32];
+} roots_recent;
+
+// Value of roots_params.init once the struct is set up by roots_params_init
+#define ROOTS_PARAMS_INIT 0x726f6f74u
+
+// Only max_iters and tol must be set before calling a method. The optional
+// inputs max_evals, deadline, bisect, trace, and recent are used only if the struct
+// was set up by roots_params_init, which disables all of them; otherwise, the
+// methods disable them, so that uninitialized values are never used.
 typedef struct roots_params {
   roots_error_t error_key;
   char method[1024];
   unsigned int n_iters, max_iters;
+  unsigned int n_evals, max_evals;
   double a, b;
   double residual, root, tol;
+  double deadline;             // Absolute time, see roots_monotonic_time
+  double bracket_a, bracket_b; // Final interval; best bracket on early stops
+  unsigned int n_surrogate_evals; // See roots_surrogate
+  roots_bisection_mode bisect;    // Used by bisection steps of all methods
+  roots_trace *trace;             // Records evaluations of f if not NULL
+  double multiplicity;            // Estimated multiplicity of the root
+  double dfdx;                    // Estimate of f'(root) if recent is set
+  unsigned int init;              // See roots_params_init
+  roots_recent *recent;           // Keeps the evaluations used for dfdx
 } roots_params;
 
+// Signature shared by all root-finding methods
+typedef roots_error_t (*roots_method)(
+      double f(const double, void *restrict),
+      void *restrict params,
+      double a,
+      double b,
+      roots_params *restrict r);
+
+// Vectorized function: computes fx[i] = f(x[i]) for i = 0, ..., n-1
+typedef void (*roots_vector_function)(
+      const unsigned n,
+      const double *restrict x,
+      void *restrict params,
+      double *restrict fx);
+
+void roots_params_init(roots_params *restrict r);
+
 void roots_info(const roots_params *restrict r);
 
+roots_method roots_method_from_name(const char *name);
+
+double roots_monotonic_time(void);
+
+const char *roots_isa(void);
+
+typedef struct roots_thread_pool roots_thread_pool;
+
+roots_thread_pool *roots_thread_pool_create(const unsigned n_threads);
+
+void roots_thread_pool_run(
+      roots_thread_pool *pool,
+      const unsigned n_tasks,
+      void task(const unsigned, void *restrict),
+      void *restrict arg);
+
+void roots_thread_pool_destroy(roots_thread_pool *pool);
+
 roots_error_t roots_bisection(
       double f(const double, void *restrict),
       void *restrict params,
@@ -45,6 +132,27 @@ roots_error_t roots_false_position(
       double b,
       roots_params *restrict r);
 
+roots_error_t roots_illinois(
+      double f(const double, void *restrict),
+      void *restrict params,
+      double a,
+      double b,
+      roots_params *restrict r);
+
+roots_error_t roots_pegasus(
+      double f(const double, void *restrict),
+      void *restrict params,
+      double a,
+      double b,
+      roots_params *restrict r);
+
+roots_error_t roots_anderson_bjorck(
+      double f(const double, void *restrict),
+      void *restrict params,
+      double a,
+      double b,
+      roots_params *restrict r);
+
 roots_error_t roots_dekker(
       double f(const double, void *restrict),
       void *restrict params,
@@ -73,4 +181,434 @@ roots_error_t roots_toms748(
       double b,
       roots_params *restrict r);
 
+roots_error_t roots_steffensen(
+      double f(const double, void *restrict),
+      void *restrict params,
+      double a,
+      double b,
+      roots_params *restrict r);
+
+// Function returning f(x) and f'(x) for x = roots_dual_var(x), see roots_dual.h
+typedef roots_dual (*roots_dual_function)(const roots_dual, void *restrict);
+
+roots_error_t roots_newton(
+      roots_dual_function f,
+      void *restrict params,
+      double a,
+      double b,
+      roots_params *restrict r);
+
+roots_error_t roots_muller(
+      double f(const double, void *restrict),
+      void *restrict params,
+      double a,
+      double b,
+      roots_params *restrict r);
+
+roots_error_t roots_hybrid(
+      double f(const double, void *restrict),
+      void *restrict params,
+      double a,
+      double b,
+      roots_params *restrict r);
+
+roots_error_t roots_multipoint(
+      double f(const double, void *restrict),
+      void *restrict params,
+      double a,
+      double b,
+      roots_params *restrict r);
+
+roots_error_t roots_ksection(
+      double f(const double, void *restrict),
+      void *restrict params,
+      double a,
+      double b,
+      unsigned k,
+      roots_thread_pool *pool,
+      roots_params *restrict r);
+
+roots_error_t roots_surrogate(
+      roots_method method,
+      double f(const double, void *restrict),
+      void *restrict params,
+      double s(const double, void *restrict),
+      void *restrict sparams,
+      double a,
+      double b,
+      const double error,
+      roots_params *restrict r);
+
+roots_error_t roots_inverse(
+      double f(const double, void *restrict),
+      void *restrict params,
+      double a,
+      double b,
+      const int n,
+      const double *restrict y,
+      double *restrict x,
+      roots_params *restrict r);
+
+unsigned roots_fixed_iterations(const double a, const double b, const double tol);
+
+roots_error_t roots_bisection_fixed(
+      double f(const double, void *restrict),
+      void *restrict params,
+      double a,
+      double b,
+      roots_params *restrict r);
+
+roots_error_t roots_ridder_fixed(
+      double f(const double, void *restrict),
+      void *restrict params,
+      double a,
+      double b,
+      roots_params *restrict r);
+
+roots_error_t roots_chandrupatla_fixed(
+      double f(const double, void *restrict),
+      void *restrict params,
+      double a,
+      double b,
+      roots_params *restrict r);
+
+roots_error_t roots_bisection_batch(
+      roots_vector_function fv,
+      void *restrict params,
+      const unsigned n,
+      const double *restrict a,
+      const double *restrict b,
+      double *restrict root,
+      roots_params *restrict r);
+
+roots_error_t roots_ridder_batch(
+      roots_vector_function fv,
+      void *restrict params,
+      const unsigned n,
+      const double *restrict a,
+      const double *restrict b,
+      double *restrict root,
+      roots_params *restrict r);
+
+roots_error_t roots_chandrupatla_batch(
+      roots_vector_function fv,
+      void *restrict params,
+      const unsigned n,
+      const double *restrict a,
+      const double *restrict b,
+      double *restrict root,
+      roots_params *restrict r);
+
+// Function in two phases: prepare does the work that depends only on the
+// parameters of the problem, once per solve, and stores its results in a
+// scratch area of scratch_size bytes owned by the library; eval computes f(x)
+// from the scratch area alone. See roots_solve_prepared.
+typedef struct {
+  size_t scratch_size;
+  void (*prepare)(const void *restrict params, void *restrict scratch);
+  double (*eval)(const double x, void *restrict scratch);
+} roots_prepared_function;
+
+roots_error_t roots_solve_prepared(
+      roots_method method,
+      const roots_prepared_function *restrict pf,
+      const void *restrict params,
+      const double a,
+      const double b,
+      roots_params *restrict r);
+
+roots_error_t roots_solve_prepared_batch(
+      roots_method method,
+      const roots_prepared_function *restrict pf,
+      const void *restrict params,
+      const size_t stride,
+      const unsigned n,
+      const double *restrict a,
+      const double *restrict b,
+      double *restrict root,
+      roots_thread_pool *pool,
+      roots_params *restrict r);
+
+// Function that also writes auxiliary outputs to aux, see roots_solve_aux
+typedef double (*roots_aux_function)(
+      const double x,
+      void *restrict params,
+      void *restrict aux);
+
+roots_error_t roots_solve_aux(
+      roots_method method,
+      roots_aux_function f,
+      void *restrict params,
+      const double a,
+      const double b,
+      const size_t aux_size,
+      void *restrict aux,
+      roots_params *restrict r);
+
+// Counters of roots_solve_grid
+typedef struct {
+  unsigned long n_cells, n_seeds;
+  unsigned long n_narrow;   // Cells solved with an interval from their neighbors
+  unsigned long n_fallback; // Cells whose predicted interval did not bracket a root
+  unsigned long n_evals, n_evals_seeds;
+  double savings; // Estimated fraction of evaluations saved over independent solves
+} roots_grid_stats;
+
+roots_error_t roots_solve_grid(
+      roots_method method,
+      double f(const double, void *restrict),
+      void *restrict params,
+      const size_t stride,
+      const unsigned nx,
+      const unsigned ny,
+      const unsigned nz,
+      const double *restrict a,
+      const double *restrict b,
+      double *restrict root,
+      roots_thread_pool *pool,
+      roots_grid_stats *restrict st,
+      roots_params *restrict r);
+
+// Derivatives of f(x; p) with respect to its n parameters at x: dfdp[i] = df/dp_i
+typedef void (*roots_parameter_gradient)(
+      const double x,
+      void *restrict params,
+      const unsigned n,
+      double *restrict dfdp);
+
+void roots_sensitivity(
+      const roots_params *restrict r,
+      roots_parameter_gradient dfdp,
+      void *restrict params,
+      const unsigned n,
+      double *restrict dxdp);
+
+void roots_sensitivity_batch(
+      roots_vector_function fv,
+      roots_vector_function dfdx,
+      roots_vector_function dfdp,
+      void *restrict params,
+      const unsigned n,
+      const double *restrict root,
+      double *restrict dxdp);
+
+// Map of n unknowns onto itself: computes gx = g(x)
+typedef void (*roots_map)(
+      const unsigned n,
+      const double *restrict x,
+      void *restrict params,
+      double *restrict gx);
+
+roots_error_t roots_fixed_point(
+      roots_map g,
+      void *restrict params,
+      const unsigned n,
+      const unsigned depth,
+      const double damping,
+      double *restrict x,
+      roots_params *restrict r);
+
+roots_error_t roots_fixed_point_scalar(
+      double g(const double, void *restrict),
+      void *restrict params,
+      double x,
+      const unsigned depth,
+      const double damping,
+      roots_params *restrict r);
+
+typedef struct roots_expr roots_expr;
+
+// Parameters of roots_expr_f and roots_expr_fv: expression and the values of
+// its parameters
+typedef struct {
+  const roots_expr *expr;
+  const double *p;
+} roots_expr_params;
+
+roots_expr *roots_expr_compile(
+      const char *formula,
+      const unsigned n_params,
+      const char *const *names,
+      int *error_pos);
+
+void roots_expr_free(roots_expr *e);
+
+unsigned roots_expr_size(const roots_expr *e);
+
+double roots_expr_f(const double x, void *restrict params);
+
+void roots_expr_fv(
+      const unsigned n,
+      const double *restrict x,
+      void *restrict params,
+      double *restrict fx);
+
+typedef struct roots_service roots_service;
+
+// Request to the asynchronous solver service
+typedef struct roots_request {
+  roots_method method;
+  double (*f)(const double, void *restrict);
+  void *fparams;
+  double a, b;
+  roots_params r; // Tolerance and limits on input, results on output
+  void (*callback)(struct roots_request *req, void *arg); // Optional
+  void *callback_arg;
+  bool done;       // Set by the service
+  double t_submit; // Set by the service
+} roots_request;
+
+// Counters of the asynchronous solver service
+typedef struct {
+  uint64_t n_submitted, n_completed, n_rejected;
+  uint64_t queue_depth, max_queue_depth;
+  double mean_submit_latency, max_submit_latency; // Time in roots_service_submit
+  double mean_queue_wait;                         // From submission to solve
+  double utilization; // Fraction of worker time spent solving
+} roots_service_stats;
+
+// Range of the base 2 logarithm of the capacity of the service queue
+#define ROOTS_SERVICE_MIN_LOG2_CAPACITY 1
+#define ROOTS_SERVICE_MAX_LOG2_CAPACITY 30
+
+roots_service *roots_service_create(
+      const unsigned n_threads,
+      const unsigned log2_capacity);
+
+bool roots_service_submit(roots_service *s, roots_request *req);
+
+bool roots_service_done(const roots_request *req);
+
+roots_error_t roots_service_wait(roots_service *s, roots_request *req);
+
+void roots_service_get_stats(roots_service *s, roots_service_stats *st);
+
+void roots_service_destroy(roots_service *s);
+
+typedef struct roots_shm_server roots_shm_server;
+typedef struct roots_shm_client roots_shm_client;
+
+// Batch of problems in the shared memory of a solver server, see
+// roots_shm_acquire. The arrays hold up to capacity problems.
+typedef struct {
+  unsigned n, capacity;
+  double *a, *b;              // Initial intervals
+  double *params;             // n_params parameters per problem
+  double *root;               // Roots (output); NAN if not bracketed
+  roots_error_t *error_key;   // Error keys (output)
+  unsigned slot;              // Set by the library
+} roots_shm_batch;
+
+// Counters of a client of the solver server
+typedef struct {
+  bool connected;
+  uint64_t n_batches, n_problems, n_evals;
+  double busy;       // Time the server spent solving the client's problems
+  double throughput; // Problems solved per second while the client was connected
+} roots_shm_stats;
+
+roots_shm_server *roots_shm_server_create(
+      const char *path,
+      const unsigned n_clients,
+      const unsigned n_slots,
+      const unsigned capacity,
+      const unsigned n_params,
+      const unsigned n_threads,
+      roots_method method,
+      double f(const double, void *restrict),
+      const roots_params *restrict r);
+
+bool roots_shm_server_get_stats(
+      roots_shm_server *s,
+      const unsigned client,
+      roots_shm_stats *st);
+
+void roots_shm_server_destroy(roots_shm_server *s);
+
+roots_shm_client *roots_shm_connect(const char *path);
+
+bool roots_shm_acquire(roots_shm_client *c, roots_shm_batch *batch);
+
+void roots_shm_submit(roots_shm_client *c, roots_shm_batch *batch);
+
+roots_error_t roots_shm_wait(roots_shm_client *c, roots_shm_batch *batch);
+
+void roots_shm_release(roots_shm_client *c, roots_shm_batch *batch);
+
+void roots_shm_get_stats(roots_shm_client *c, roots_shm_stats *st);
+
+void roots_shm_disconnect(roots_shm_client *c);
+
+typedef struct roots_cache roots_cache;
+
+uint64_t roots_cache_key(
+      const int n,
+      const double *restrict p,
+      const double *restrict quantum);
+
+// Largest base 2 logarithm of the capacity of a new cache
+#define ROOTS_CACHE_MAX_LOG2_CAPACITY 32
+
+roots_cache *roots_cache_open(const char *path, const unsigned log2_capacity);
+
+void roots_cache_sync(roots_cache *cache);
+
+void roots_cache_close(roots_cache *cache);
+
+bool roots_cache_lookup(
+      roots_cache *cache,
+      const uint64_t key,
+      double *restrict root,
+      double *restrict a,
+      double *restrict b);
+
+void roots_cache_store(
+      roots_cache *cache,
+      const uint64_t key,
+      const double root,
+      const double a,
+      const double b);
+
+roots_error_t roots_cached(
+      roots_method method,
+      double f(const double, void *restrict),
+      void *restrict params,
+      double a,
+      double b,
+      roots_cache *cache,
+      const uint64_t key,
+      roots_params *restrict r);
+
+// A recorded solve: method, parameters, and the evaluations of f sorted by x
+typedef struct {
+  char method[1024];
+  double a, b, tol;
+  unsigned int max_iters;
+  roots_bisection_mode bisect;
+  unsigned int n_evals;  // Number of recorded evaluations
+  unsigned int n_points; // Number of distinct points
+  double *x, *fx;
+  unsigned long n_replayed;     // Evaluations served by roots_trace_replay
+  unsigned long n_interpolated; // Those of them that were interpolated
+} roots_trace_solve;
+
+roots_trace *roots_trace_open(const char *path);
+
+bool roots_trace_close(roots_trace *t);
+
+roots_trace_solve *roots_trace_load(const char *path, unsigned *n_solves);
+
+void roots_trace_free(roots_trace_solve *solves, const unsigned n_solves);
+
+double roots_trace_replay(const double x, void *restrict solve);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef ROOTS_UNDEF_RESTRICT_
+#undef restrict
+#undef ROOTS_UNDEF_RESTRICT_
+#endif
+
 #endif  // ROOTS_H_
@@ -0,0 +1,225 @@
+#ifndef ROOTS_DUAL_H_
+#define ROOTS_DUAL_H_
+
+/*
+ * Dual numbers for forward-mode automatic differentiation. A dual number
+ * v + d e, with e^2 = 0, carries a value and a derivative; evaluating a
+ * function at roots_dual_var(x) gives f(x) and f'(x) in a single pass, which
+ * is how roots_newton obtains its derivatives. In C, write f with the
+ * functions below, e.g., f(x) = x - 0.9 sin(x) - 1 is
+ *
+ *   roots_dual f(const roots_dual x, void *restrict params) {
+ *     const roots_dual s = roots_dual_scale(0.9, roots_dual_sin(x));
+ *     return roots_dual_shift(roots_dual_sub(x, s), -1);
+ *   }
+ *
+ * In C++ the arithmetic operators and the math functions are overloaded, so
+ * that the same template, e.g.,
+ *
+ *   template<typename T> T f(const T x) { using std::sin; return x - 0.9 * sin(x) - 1; }
+ *
+ * can be evaluated at doubles and at dual numbers; roots_newton is then called
+ * with a function that returns f(x) for x of type roots_dual.
+ */
+#include <math.h>
+
+typedef struct {
+  double v; // Value
+  double d; // Derivative
+} roots_dual;
+
+// Independent variable x, i.e., dx/dx = 1
+static inline roots_dual roots_dual_var(const double x) {
+  const roots_dual z = { x, 1 };
+  return z;
+}
+
+// Constant c, i.e., dc/dx = 0
+static inline roots_dual roots_dual_const(const double c) {
+  const roots_dual z = { c, 0 };
+  return z;
+}
+
+// Chain rule: z = g(u) and dz/dx = g'(u) du/dx
+static inline roots_dual roots_dual_chain(
+      const roots_dual u,
+      const double g,
+      const double dg) {
+  const roots_dual z = { g, dg * u.d };
+  return z;
+}
+
+static inline roots_dual roots_dual_add(const roots_dual u, const roots_dual w) {
+  const roots_dual z = { u.v + w.v, u.d + w.d };
+  return z;
+}
+
+static inline roots_dual roots_dual_sub(const roots_dual u, const roots_dual w) {
+  const roots_dual z = { u.v - w.v, u.d - w.d };
+  return z;
+}
+
+static inline roots_dual roots_dual_mul(const roots_dual u, const roots_dual w) {
+  const roots_dual z = { u.v * w.v, u.d * w.v + u.v * w.d };
+  return z;
+}
+
+static inline roots_dual roots_dual_div(const roots_dual u, const roots_dual w) {
+  const double q = u.v / w.v;
+  const roots_dual z = { q, (u.d - q * w.d) / w.v };
+  return z;
+}
+
+static inline roots_dual roots_dual_neg(const roots_dual u) {
+  const roots_dual z = { -u.v, -u.d };
+  return z;
+}
+
+// c u for a constant c
+static inline roots_dual roots_dual_scale(const double c, const roots_dual u) {
+  const roots_dual z = { c * u.v, c * u.d };
+  return z;
+}
+
+// u + c for a constant c
+static inline roots_dual roots_dual_shift(const roots_dual u, const double c) {
+  const roots_dual z = { u.v + c, u.d };
+  return z;
+}
+
+static inline roots_dual roots_dual_sqrt(const roots_dual u) {
+  const double s = sqrt(u.v);
+  return roots_dual_chain(u, s, 0.5 / s);
+}
+
+static inline roots_dual roots_dual_cbrt(const roots_dual u) {
+  const double s = cbrt(u.v);
+  return roots_dual_chain(u, s, 1.0 / (3 * s * s));
+}
+
+static inline roots_dual roots_dual_exp(const roots_dual u) {
+  const double e = exp(u.v);
+  return roots_dual_chain(u, e, e);
+}
+
+static inline roots_dual roots_dual_log(const roots_dual u) {
+  return roots_dual_chain(u, log(u.v), 1 / u.v);
+}
+
+// u^p for a constant exponent p; the value is pow(u, p) also where u^(p-1) is
+// not finite, e.g., at u = 0 for p < 1
+static inline roots_dual roots_dual_pow(const roots_dual u, const double p) {
+  return roots_dual_chain(u, pow(u.v, p), p == 0 ? 0 : p * pow(u.v, p - 1));
+}
+
+static inline roots_dual roots_dual_sin(const roots_dual u) {
+  return roots_dual_chain(u, sin(u.v), cos(u.v));
+}
+
+static inline roots_dual roots_dual_cos(const roots_dual u) {
+  return roots_dual_chain(u, cos(u.v), -sin(u.v));
+}
+
+static inline roots_dual roots_dual_tan(const roots_dual u) {
+  const double t = tan(u.v);
+  return roots_dual_chain(u, t, 1 + t * t);
+}
+
+static inline roots_dual roots_dual_atan(const roots_dual u) {
+  return roots_dual_chain(u, atan(u.v), 1 / (1 + u.v * u.v));
+}
+
+static inline roots_dual roots_dual_sinh(const roots_dual u) {
+  return roots_dual_chain(u, sinh(u.v), cosh(u.v));
+}
+
+static inline roots_dual roots_dual_cosh(const roots_dual u) {
+  return roots_dual_chain(u, cosh(u.v), sinh(u.v));
+}
+
+static inline roots_dual roots_dual_tanh(const roots_dual u) {
+  const double t = tanh(u.v);
+  return roots_dual_chain(u, t, 1 - t * t);
+}
+
+static inline roots_dual roots_dual_fabs(const roots_dual u) {
+  return roots_dual_chain(u, fabs(u.v), u.v < 0 ? -1 : 1);
+}
+
+#ifdef __cplusplus
+#include <cmath>
+
+// Arithmetic with dual numbers and doubles
+inline roots_dual operator+(const roots_dual u, const roots_dual w) {
+  return roots_dual_add(u, w);
+}
+inline roots_dual operator-(const roots_dual u, const roots_dual w) {
+  return roots_dual_sub(u, w);
+}
+inline roots_dual operator*(const roots_dual u, const roots_dual w) {
+  return roots_dual_mul(u, w);
+}
+inline roots_dual operator/(const roots_dual u, const roots_dual w) {
+  return roots_dual_div(u, w);
+}
+inline roots_dual operator-(const roots_dual u) { return roots_dual_neg(u); }
+inline roots_dual operator+(const roots_dual u) { return u; }
+inline roots_dual operator+(const roots_dual u, const double c) {
+  return roots_dual_shift(u, c);
+}
+inline roots_dual operator+(const double c, const roots_dual u) {
+  return roots_dual_shift(u, c);
+}
+inline roots_dual operator-(const roots_dual u, const double c) {
+  return roots_dual_shift(u, -c);
+}
+inline roots_dual operator-(const double c, const roots_dual u) {
+  return roots_dual_shift(roots_dual_neg(u), c);
+}
+inline roots_dual operator*(const roots_dual u, const double c) {
+  return roots_dual_scale(c, u);
+}
+inline roots_dual operator*(const double c, const roots_dual u) {
+  return roots_dual_scale(c, u);
+}
+inline roots_dual operator/(const roots_dual u, const double c) {
+  return roots_dual_scale(1 / c, u);
+}
+inline roots_dual operator/(const double c, const roots_dual u) {
+  return roots_dual_div(roots_dual_const(c), u);
+}
+inline roots_dual &operator+=(roots_dual &u, const roots_dual w) { return u = u + w; }
+inline roots_dual &operator-=(roots_dual &u, const roots_dual w) { return u = u - w; }
+inline roots_dual &operator*=(roots_dual &u, const roots_dual w) { return u = u * w; }
+inline roots_dual &operator/=(roots_dual &u, const roots_dual w) { return u = u / w; }
+
+// Comparisons use the values, so that branches in f work as for doubles
+inline bool operator<(const roots_dual u, const roots_dual w) { return u.v < w.v; }
+inline bool operator>(const roots_dual u, const roots_dual w) { return u.v > w.v; }
+inline bool operator<=(const roots_dual u, const roots_dual w) { return u.v <= w.v; }
+inline bool operator>=(const roots_dual u, const roots_dual w) { return u.v >= w.v; }
+inline bool operator<(const roots_dual u, const double c) { return u.v < c; }
+inline bool operator>(const roots_dual u, const double c) { return u.v > c; }
+inline bool operator<=(const roots_dual u, const double c) { return u.v <= c; }
+inline bool operator>=(const roots_dual u, const double c) { return u.v >= c; }
+
+// Math functions, found by argument-dependent lookup after using std::name
+inline roots_dual sqrt(const roots_dual u) { return roots_dual_sqrt(u); }
+inline roots_dual cbrt(const roots_dual u) { return roots_dual_cbrt(u); }
+inline roots_dual exp(const roots_dual u) { return roots_dual_exp(u); }
+inline roots_dual log(const roots_dual u) { return roots_dual_log(u); }
+inline roots_dual pow(const roots_dual u, const double p) {
+  return roots_dual_pow(u, p);
+}
+inline roots_dual sin(const roots_dual u) { return roots_dual_sin(u); }
+inline roots_dual cos(const roots_dual u) { return roots_dual_cos(u); }
+inline roots_dual tan(const roots_dual u) { return roots_dual_tan(u); }
+inline roots_dual atan(const roots_dual u) { return roots_dual_atan(u); }
+inline roots_dual sinh(const roots_dual u) { return roots_dual_sinh(u); }
+inline roots_dual cosh(const roots_dual u) { return roots_dual_cosh(u); }
+inline roots_dual tanh(const roots_dual u) { return roots_dual_tanh(u); }
+inline roots_dual fabs(const roots_dual u) { return roots_dual_fabs(u); }
+inline roots_dual abs(const roots_dual u) { return roots_dual_fabs(u); }
+#endif
+
+#endif  // ROOTS_DUAL_H_
@@ -12,6 +12,11 @@
  *   2. Check if the root is in the interval [a,b];
  *   3. Ensure |f(b)| < |f(a)| by swapping a and b if necessary.
  *
+ * It also prepares r for the solve (see start_solve) and resets the
+ * evaluation counter. The two evaluations at
+ * the end points of the initial interval are always performed, regardless
+ * of the limits set in r.
+ *
  * Parameters : f        - Function for which the root is computed.
  *            : fparams  - Object containing all parameters needed by the
  *                         function f other than the variable x.
@@ -37,20 +42,20 @@ roots_error_t check_a_b_compute_fa_fb(
       double *restrict fb,
       roots_params *restrict r) {
 
+  // Step 0: Reset the counters and the outputs (see start_solve)
+  start_solve(r);
+  r->n_evals = 0;
+
   // Step 1: Compute fa; check if a is the root.
-  *fa = f(*a, fparams);
+  *fa = evaluate(f, fparams, *a, r);
   if(*fa == 0.0) {
-    r->root = *a;
-    r->residual = *fa;
-    return (r->error_key = roots_success);
+    return set_root(r, roots_success, *a, *fa, *a, *a);
   }
 
   // Step 2: Compute fb; check if b is the root.
-  *fb = f(*b, fparams);
+  *fb = evaluate(f, fparams, *b, r);
   if(*fb == 0.0) {
-    r->root = *b;
-    r->residual = *fb;
-    return (r->error_key = roots_success);
+    return set_root(r, roots_success, *b, *fb, *b, *b);
   }
 
   // Step 3: Ensure the root is in [a,b]
@@ -63,9 +68,7 @@ roots_error_t check_a_b_compute_fa_fb(
 
   // Step 5: If [a,b] is too small, return b
   if(fabs(*a - *b) < r->tol) {
-    r->root = *b;
-    r->residual = *fb;
-    return (r->error_key = roots_success);
+    return set_root(r, roots_success, *b, *fb, *a, *b);
   }
 
   // Step 6: Root not found.
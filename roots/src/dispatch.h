@@ -0,0 +1,38 @@
+#ifndef DISPATCH_H_
+#define DISPATCH_H_
+
+/*
+ * Runtime dispatch of vectorized kernels. The library is built for the
+ * baseline of the target architecture; kernels that benefit from wider
+ * vectors are also compiled for the instruction set levels below, and the
+ * best level supported by the processor is selected when the library is
+ * loaded (see roots_isa.c). A kernel is written once, as an always_inline
+ * function name##_kernel, and DISPATCH_KERNEL defines a copy of it per level
+ * and the table name##_table; calls go through DISPATCH(name)(...).
+ */
+typedef enum { isa_baseline, isa_avx2, isa_avx512, n_isa_levels } isa_level;
+
+// Level selected when the library is loaded, see roots_isa.c
+extern isa_level roots_isa_level;
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define TARGET_AVX512 __attribute__((target("avx512f,avx512dq,avx512vl,avx2,fma")))
+#else
+#define TARGET_AVX2
+#define TARGET_AVX512
+#endif
+
+#define KERNEL static inline __attribute__((always_inline))
+
+// params and args are the parenthesized parameter and argument lists
+#define DISPATCH_KERNEL(name, params, args)                           \
+  static void name##_baseline params { name##_kernel args; }          \
+  TARGET_AVX2 static void name##_avx2 params { name##_kernel args; }  \
+  TARGET_AVX512 static void name##_avx512 params { name##_kernel args; } \
+  static void(*const name##_table[n_isa_levels]) params = {            \
+    name##_baseline, name##_avx2, name##_avx512 }
+
+#define DISPATCH(name) (name##_table[roots_isa_level])
+
+#endif  // DISPATCH_H_
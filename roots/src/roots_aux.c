@@ -0,0 +1,108 @@
+#include <string.h>
+
+#include "roots.h"
+
+// Number of evaluations whose auxiliary outputs are kept during a solve
+#define N_SLOTS 3
+
+typedef struct {
+  roots_aux_function f;
+  void *fparams;
+  size_t size;
+  unsigned char *slots;
+  double x[N_SLOTS], fx[N_SLOTS];
+} aux_params;
+
+/*
+ * Function   : aux_evaluate
+ * Author     : Leo Werneck
+ *
+ * Evaluates f(x), letting f write its auxiliary outputs to one of the slots.
+ * The slot used is an empty one (or one where f was NAN), or else the one
+ * holding the evaluation with the largest |f|, so that the slots always hold
+ * the newest evaluation and the two previous ones closest to the root; the
+ * root returned by a method is almost always one of them.
+ *
+ * Parameters : x        - Point at which the function is evaluated.
+ *            : p        - Pointer to an aux_params struct.
+ *
+ * Returns    : f(x).
+ */
+static double aux_evaluate(const double x, void *restrict p) {
+  aux_params *a = (aux_params *)p;
+  unsigned k = 0;
+  for(unsigned i = 0; i < N_SLOTS; i++) {
+    if(isnan(a->fx[i])) {
+      k = i;
+      break;
+    }
+    if(fabs(a->fx[i]) > fabs(a->fx[k])) {
+      k = i;
+    }
+  }
+  const double fx = a->f(x, a->fparams, a->slots + k * a->size);
+  a->x[k] = x;
+  a->fx[k] = fx;
+  return fx;
+}
+
+/*
+ * Function   : roots_solve_aux
+ * Author     : Leo Werneck
+ *
+ * Find the root of f(x) in the interval [a,b] using the given method, where f
+ * also writes auxiliary outputs, e.g., quantities computed along with f(x),
+ * to a buffer (see roots_aux_function). On return, aux holds the outputs of f
+ * at the root, so that f need not be evaluated at the root again.
+ *
+ * The outputs of the three evaluations most likely to be returned as the
+ * root are kept in slots owned by the library (see aux_evaluate), and the
+ * one of the root is copied to aux. If the root is none of them, which is
+ * rare, f is evaluated once more at the root; this evaluation is counted in
+ * r->n_evals. Methods that evaluate f concurrently (roots_ksection with a
+ * thread pool) cannot be used.
+ *
+ * Parameters : method   - Root-finding method, e.g., roots_brent.
+ *            : f        - Function for which the root is computed.
+ *            : fparams  - Object containing all parameters needed by the
+ *                         function f other than the variable x.
+ *            : a        - Lower limit of the initial interval.
+ *            : b        - Upper limit of the initial interval.
+ *            : aux_size - Size of the auxiliary outputs, in bytes.
+ *            : aux      - Auxiliary outputs at the root (output). Not set if
+ *                         the interval does not bracket a root.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         The root is stored in r->root.
+ *
+ * Returns    : The error key returned by the method.
+ */
+roots_error_t roots_solve_aux(
+      roots_method method,
+      roots_aux_function f,
+      void *restrict fparams,
+      const double a,
+      const double b,
+      const size_t aux_size,
+      void *restrict aux,
+      roots_params *restrict r) {
+
+  // Step 1: Solve, keeping the auxiliary outputs in slots on the stack
+  const size_t size = (aux_size + 63) / 64 * 64;
+  unsigned char slots[N_SLOTS * size + 1] __attribute__((aligned(64)));
+  aux_params p = { f, fparams, size, slots, { NAN, NAN, NAN }, { NAN, NAN, NAN } };
+  method(aux_evaluate, &p, a, b, r);
+  if(r->error_key == roots_error_root_not_bracketed) {
+    return r->error_key;
+  }
+
+  // Step 2: Hand back the outputs of the root, evaluating f again if needed
+  for(unsigned i = 0; i < N_SLOTS; i++) {
+    if(p.x[i] == r->root) {
+      memcpy(aux, slots + i * size, aux_size);
+      return r->error_key;
+    }
+  }
+  f(r->root, fparams, aux);
+  r->n_evals++;
+  return r->error_key;
+}
@@ -21,6 +21,9 @@
  *                   does not bracket a root of f(x)
  *                 - roots_error_max_iter if the maximum allowed number of
  *                   iterations is exceeded
+ *                 - roots_error_max_evals if the maximum allowed number of
+ *                   function evaluations is exceeded
+ *                 - roots_error_deadline if the deadline has passed
  *
  * References : https://en.wikipedia.org/wiki/Bisection_method
  */
@@ -44,11 +47,16 @@ roots_error_t roots_bisection(
 
   // Step 2: Bisection algorithm
   for(r->n_iters = 1; r->n_iters <= r->max_iters; r->n_iters++) {
-    // Step 2.a: Compute the mid point and the function at the midpoint
-    const double c = (a + b) / 2;
-    const double fc = f(c, fparams);
+    // Step 2.a: Check whether we can afford another function evaluation
+    if(budget_exhausted(r, a, b, fa, fb)) {
+      return r->error_key;
+    }
+
+    // Step 2.b: Compute the mid point and the function at the midpoint
+    const double c = midpoint(a, b, r);
+    const double fc = evaluate(f, fparams, c, r);
 
-    // Step 2.b: Adjust the limits of the interval
+    // Step 2.c: Adjust the limits of the interval
     if(fa * fc < 0) {
       b = c;
       fb = fc;
@@ -58,15 +66,13 @@ roots_error_t roots_bisection(
       fa = fc;
     }
 
-    // Step 2.c: Check for convergence
+    // Step 2.d: Check for convergence
     if(fabs(b - a) < r->tol || fc == 0.0) {
-      r->root = c;
-      r->residual = fc;
-      return (r->error_key = roots_success);
+      return set_root(r, roots_success, c, fc, a, b);
     }
   }
 
   // Step 3: The only way to get here is if we have exceeded the maximum number
   //         of iterations allowed.
-  return (r->error_key = roots_error_max_iter);
+  return set_best(r, roots_error_max_iter, a, b, fa, fb);
 }
@@ -23,6 +23,9 @@
  *                   does not bracket a root of f(x)
  *                 - roots_error_max_iter if the maximum allowed number of
  *                   iterations is exceeded
+ *                 - roots_error_max_evals if the maximum allowed number of
+ *                   function evaluations is exceeded
+ *                 - roots_error_deadline if the deadline has passed
  *
  * References : Press et al., Numerical Recipes, Ch. 9.3
  *              Freely available at: http://numerical.recipes/book/book.html
@@ -46,24 +49,61 @@ roots_error_t roots_brent(
     return r->error_key;
   }
 
-  // Step 2: Declare auxiliary variables
+  // Step 2: Brent's algorithm
+  return roots_brent_core(f, fparams, a, b, fa, fb, r);
+}
+
+/*
+ * Function   : roots_brent_core
+ * Author     : Leo Werneck
+ *
+ * Brent's algorithm for an interval [a,b] at which f(a) and f(b) are known,
+ * f(a)f(b) < 0, and |f(b)| <= |f(a)| (see check_a_b_compute_fa_fb). This is
+ * used by roots_brent and by methods that finish with Brent's method.
+ *
+ * Parameters : f        - Function for which the root is computed.
+ *            : fparams  - Object containing all parameters needed by the
+ *                         function f other than the variable x.
+ *            : a        - Contrapoint.
+ *            : b        - Best approximation to the root.
+ *            : fa       - f(a).
+ *            : fb       - f(b).
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *
+ * Returns    : See roots_brent.
+ */
+roots_error_t roots_brent_core(
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      double a,
+      double b,
+      double fa,
+      double fb,
+      roots_params *restrict r) {
+
+  // Step 0: Reset the multiplicity and the iteration counter; evaluations
+  //         keep counting from the caller's (see start_solve)
+  start_solve(r);
+
+  // Step 1: Declare auxiliary variables
   double c = b;
   double fc = fb;
   double d = b - a;
   double e = d;
   double tol, m, P, Q, R, S;
+  iterates it = { 0 };
 
-  // Step 3: Brent's algorithm
+  // Step 2: Brent's algorithm
   for(r->n_iters = 1; r->n_iters <= r->max_iters; r->n_iters++) {
 
-    // Step 3.a: Keep the bracket in [b,c]
+    // Step 2.a: Keep the bracket in [b,c]
     if(fb * fc > 0) {
       c = a;
       fc = fa;
       d = e = b - a;
     }
 
-    // Step 3.b: Keep the best guess in b
+    // Step 2.b: Keep the best guess in b
     if(fabs(fc) < fabs(fb)) {
       swap(&b, &c);
       swap(&fb, &fc);
@@ -71,35 +111,43 @@ roots_error_t roots_brent(
       fa = fc;
     }
 
-    // Step 3.c: Set the tolerance for this iteration
+    // Step 2.c: Set the tolerance for this iteration
     tol = 2 * DBL_EPSILON * fabs(b) + 0.5 * r->tol;
 
-    // Step 3.e: Compute midpoint
+    // Step 2.e: Compute midpoint
     m = 0.5 * (c - b);
 
-    // Step 3.f: Check for convergence
-    if(fabs(b - a) < tol || fb == 0.0) {
-      r->root = b;
-      r->residual = fb;
-      return (r->error_key = roots_success);
+    // Step 2.f: Check for convergence
+    if(fabs(m) <= tol || fb == 0.0) {
+      return set_root(r, roots_success, b, fb, b, c);
     }
 
-    // Step 3.g: Check whether to bisect or interpolate
+    // Step 2.g: Check whether we can afford another function evaluation
+    if(budget_exhausted(r, b, c, fb, fc)) {
+      return r->error_key;
+    }
+
+    // Step 2.h: Check whether to bisect or interpolate
+    bool interpolated = false;
     if(fabs(e) < tol || fabs(fa) <= fabs(fb)) {
-      e = d = m; // bisect
+      e = d = midpoint(b, c, r) - b; // bisect
     }
     else {
-      // Attempt interpolation
-      S = fb / fa;
+      // Attempt interpolation, with the deflated function values near
+      // multiple roots (see track_root)
+      const double ga = deflate(fa, r->multiplicity);
+      const double gb = deflate(fb, r->multiplicity);
+      const double gc = deflate(fc, r->multiplicity);
+      S = gb / ga;
       if(a == c) {
-        // Step 3.g.1: Linear interpolation
+        // Step 2.h.1: Linear interpolation
         P = 2 * m * S;
         Q = 1 - S;
       }
       else {
-        // Step 3.g.2: Inverse quadratic interpolation
-        Q = fa / fc;
-        R = fb / fc;
+        // Step 2.h.2: Inverse quadratic interpolation
+        Q = ga / gc;
+        R = gb / gc;
         P = S * (2 * m * Q * (Q - R) - (b - a) * (R - 1));
         Q = (Q - 1) * (R - 1) * (S - 1);
       }
@@ -110,14 +158,15 @@ roots_error_t roots_brent(
         P = -P;
       }
 
-      // Step 3.g.3: Accept interpolation?
+      // Step 2.h.3: Accept interpolation?
       if(2 * P < 3 * m * Q - fabs(tol * Q) && 2 * P < fabs(e * Q)) {
         // Yes
         e = d;
         d = P / Q;
+        interpolated = true;
       }
       else {
-        e = d = m; // Interpolation failed; do a bisection
+        e = d = midpoint(b, c, r) - b; // Interpolation failed; do a bisection
       }
     }
     a = b;
@@ -128,10 +177,14 @@ roots_error_t roots_brent(
     else {
       b += m > 0 ? tol : -tol;
     }
-    fb = f(b, fparams);
+    fb = evaluate(f, fparams, b, r);
+    track_root(&it, b, fb, interpolated, r);
   }
 
-  // Step 4: The only way to get here is if we have exceeded the maximum number
-  //         of iterations allowed.
-  return (r->error_key = roots_error_max_iter);
+  // Step 3: The only way to get here is if we have exceeded the maximum number
+  //         of iterations allowed. The root is in [a,b] or [b,c].
+  if(fb * fc > 0) {
+    return set_best(r, roots_error_max_iter, a, b, fa, fb);
+  }
+  return set_best(r, roots_error_max_iter, b, c, fb, fc);
 }
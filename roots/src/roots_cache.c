@@ -0,0 +1,394 @@
+#include <fcntl.h>
+#include <float.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "roots.h"
+#include "utils.h"
+
+#define CACHE_MAGIC "ROOTSC1"
+#define CACHE_MAX_PROBES 16
+
+// Entries are protected by a sequence lock: writers make seq odd while they
+// update the entry, and readers retry if seq changed while they read it. The
+// key is claimed with a compare-and-swap; a key of zero marks an empty entry.
+typedef struct {
+  uint64_t key;
+  uint64_t seq;
+  double root, a, b;
+} cache_entry;
+
+// Layout of the (possibly memory-mapped) table
+typedef struct {
+  char magic[8];
+  uint64_t capacity;
+  cache_entry entries[];
+} cache_table;
+
+struct roots_cache {
+  cache_table *table;
+  size_t size;
+  int fd;
+};
+
+/*
+ * Function   : mix
+ * Author     : Leo Werneck
+ *
+ * Mixes the bits of a 64-bit integer (splitmix64 finalizer).
+ *
+ * Parameters : x        - Integer.
+ *
+ * Returns    : The mixed integer.
+ */
+static inline uint64_t mix(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/*
+ * Function   : quantize
+ * Author     : Leo Werneck
+ *
+ * Quantizes a parameter according to the quantization policy q: if q = 0 the
+ * parameter is used exactly, if q > 0 it is rounded to a multiple of q, and
+ * if q < 0 it is rounded to a relative precision |q|.
+ *
+ * Parameters : p        - Parameter.
+ *            : q        - Quantum.
+ *
+ * Returns    : A 64-bit integer identifying the quantized parameter.
+ */
+static inline uint64_t quantize(const double p, const double q) {
+
+  if(q > 0) {
+    return (uint64_t)llround(p / q);
+  }
+  if(q < 0 && p != 0) {
+    const int64_t k = llround(log(fabs(p)) / log1p(-q));
+    return (uint64_t)(2 * k + (p < 0));
+  }
+  uint64_t bits;
+  const double x = p == 0 ? 0.0 : p; // -0 and +0 have the same key
+  memcpy(&bits, &x, sizeof(bits));
+  return bits;
+}
+
+/*
+ * Function   : roots_cache_key
+ * Author     : Leo Werneck
+ *
+ * Computes the cache key of a problem from its (quantized) parameters.
+ *
+ * Parameters : n        - Number of parameters.
+ *            : p        - Parameters.
+ *            : quantum  - Quantization policy for each parameter (see
+ *                         quantize); if NULL, parameters are used exactly.
+ *
+ * Returns    : The cache key, which is never zero.
+ */
+uint64_t roots_cache_key(
+      const int n,
+      const double *restrict p,
+      const double *restrict quantum) {
+
+  uint64_t h = 0x9e3779b97f4a7c15ULL;
+  for(int i = 0; i < n; i++) {
+    h = mix(h ^ quantize(p[i], quantum ? quantum[i] : 0));
+  }
+  return h ? h : 1;
+}
+
+/*
+ * Function   : roots_cache_open
+ * Author     : Leo Werneck
+ *
+ * Creates a root cache. If a path is given, the cache is backed by a
+ * memory-mapped file: an existing cache file is reused (with its own
+ * capacity), and a new or empty file is made a new cache. Any other file is
+ * left untouched and the cache is not opened. The cache can be shared by
+ * threads and, through the file, by processes.
+ *
+ * Parameters : path     - Path to the cache file, or NULL for a cache that
+ *                         lives in memory only.
+ *            : log2_capacity - Log2 of the number of entries of a new cache, at
+ *                              most ROOTS_CACHE_MAX_LOG2_CAPACITY.
+ *
+ * Returns    : Pointer to the cache, or NULL on failure (including a capacity
+ *              out of range).
+ */
+roots_cache *roots_cache_open(const char *path, const unsigned log2_capacity) {
+
+  if(log2_capacity > ROOTS_CACHE_MAX_LOG2_CAPACITY
+     || (1ULL << log2_capacity)
+              > (SIZE_MAX - sizeof(cache_table)) / sizeof(cache_entry)) {
+    return NULL;
+  }
+  roots_cache *cache = calloc(1, sizeof(*cache));
+  if(!cache) {
+    return NULL;
+  }
+  uint64_t capacity = 1ULL << log2_capacity;
+  cache->size = sizeof(cache_table) + capacity * sizeof(cache_entry);
+  cache->fd = -1;
+
+  // Step 1: Map the table, either anonymously or from the file
+  bool initialize = true;
+  if(!path) {
+    cache->table = mmap(NULL, cache->size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  }
+  else {
+    cache->fd = open(path, O_RDWR | O_CREAT, 0644);
+    struct stat st;
+    if(cache->fd < 0 || fstat(cache->fd, &st)) {
+      goto fail;
+    }
+    if(st.st_size == 0) {
+      if(ftruncate(cache->fd, cache->size)) {
+        goto fail;
+      }
+    }
+    else {
+      // The file must be a cache with a capacity that is a nonzero power of
+      // two and matches its size
+      cache_table header;
+      const size_t entry = sizeof(cache_entry);
+      if((size_t)st.st_size < sizeof(header)
+         || pread(cache->fd, &header, sizeof(header), 0) != sizeof(header)
+         || memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) || !header.capacity
+         || (header.capacity & (header.capacity - 1))
+         || header.capacity > (SIZE_MAX - sizeof(cache_table)) / entry
+         || (size_t)st.st_size != sizeof(cache_table) + header.capacity * entry) {
+        goto fail;
+      }
+      capacity = header.capacity;
+      cache->size = st.st_size;
+      initialize = false;
+    }
+    cache->table
+          = mmap(NULL, cache->size, PROT_READ | PROT_WRITE, MAP_SHARED, cache->fd, 0);
+  }
+  if(cache->table == MAP_FAILED) {
+    goto fail;
+  }
+
+  // Step 2: Initialize new tables. Mapped memory is zero, i.e., all entries
+  //         are empty.
+  if(initialize) {
+    memcpy(cache->table->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    cache->table->capacity = capacity;
+  }
+  return cache;
+
+fail:
+  if(cache->fd >= 0) {
+    close(cache->fd);
+  }
+  free(cache);
+  return NULL;
+}
+
+/*
+ * Function   : roots_cache_sync
+ * Author     : Leo Werneck
+ *
+ * Writes the cache to its file (no-op for caches that live in memory only).
+ *
+ * Parameters : cache    - Root cache.
+ *
+ * Returns    : Nothing.
+ */
+void roots_cache_sync(roots_cache *cache) {
+  if(cache && cache->fd >= 0) {
+    msync(cache->table, cache->size, MS_SYNC);
+  }
+}
+
+/*
+ * Function   : roots_cache_close
+ * Author     : Leo Werneck
+ *
+ * Writes the cache to its file and frees it.
+ *
+ * Parameters : cache    - Root cache (may be NULL).
+ *
+ * Returns    : Nothing.
+ */
+void roots_cache_close(roots_cache *cache) {
+
+  if(!cache) {
+    return;
+  }
+  roots_cache_sync(cache);
+  munmap(cache->table, cache->size);
+  if(cache->fd >= 0) {
+    close(cache->fd);
+  }
+  free(cache);
+}
+
+/*
+ * Function   : roots_cache_lookup
+ * Author     : Leo Werneck
+ *
+ * Looks up a key in the cache.
+ *
+ * Parameters : cache    - Root cache.
+ *            : key      - Key (see roots_cache_key).
+ *            : root     - Cached root (output).
+ *            : a        - Lower end of the cached bracket (output).
+ *            : b        - Upper end of the cached bracket (output).
+ *
+ * Returns    : true if the key was found, false otherwise.
+ */
+bool roots_cache_lookup(
+      roots_cache *cache,
+      const uint64_t key,
+      double *restrict root,
+      double *restrict a,
+      double *restrict b) {
+
+  const uint64_t mask = cache->table->capacity - 1;
+  for(uint64_t i = 0; i < CACHE_MAX_PROBES && i <= mask; i++) {
+    cache_entry *e = &cache->table->entries[(key + i) & mask];
+    const uint64_t k = __atomic_load_n(&e->key, __ATOMIC_ACQUIRE);
+    if(!k) {
+      return false;
+    }
+    if(k != key) {
+      continue;
+    }
+    while(true) {
+      const uint64_t s0 = __atomic_load_n(&e->seq, __ATOMIC_ACQUIRE);
+      if(s0 & 1) {
+        return false; // Being updated; treat as a miss
+      }
+      __atomic_load(&e->root, root, __ATOMIC_RELAXED);
+      __atomic_load(&e->a, a, __ATOMIC_RELAXED);
+      __atomic_load(&e->b, b, __ATOMIC_RELAXED);
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      if(__atomic_load_n(&e->seq, __ATOMIC_RELAXED) == s0) {
+        return s0 != 0; // seq = 0: claimed but not yet written
+      }
+    }
+  }
+  return false;
+}
+
+/*
+ * Function   : roots_cache_store
+ * Author     : Leo Werneck
+ *
+ * Stores a root and its bracket in the cache. If the key is not in the
+ * cache and all entries it may occupy are taken, nothing is stored.
+ *
+ * Parameters : cache    - Root cache.
+ *            : key      - Key (see roots_cache_key).
+ *            : root     - Root.
+ *            : a        - Lower end of the bracket.
+ *            : b        - Upper end of the bracket.
+ *
+ * Returns    : Nothing.
+ */
+void roots_cache_store(
+      roots_cache *cache,
+      const uint64_t key,
+      const double root,
+      const double a,
+      const double b) {
+
+  const uint64_t mask = cache->table->capacity - 1;
+  for(uint64_t i = 0; i < CACHE_MAX_PROBES && i <= mask; i++) {
+    cache_entry *e = &cache->table->entries[(key + i) & mask];
+
+    // Step 1: Claim the entry if it is empty; skip it if it has another key
+    uint64_t k = 0;
+    if(!__atomic_compare_exchange_n(&e->key, &k, key, false, __ATOMIC_ACQ_REL,
+                                    __ATOMIC_ACQUIRE)
+       && k != key) {
+      continue;
+    }
+
+    // Step 2: Lock the entry (make seq odd), update it, and unlock it. If
+    //         another thread is updating it, let it win.
+    uint64_t s = __atomic_load_n(&e->seq, __ATOMIC_RELAXED);
+    if((s & 1)
+       || !__atomic_compare_exchange_n(&e->seq, &s, s + 1, false, __ATOMIC_ACQUIRE,
+                                       __ATOMIC_RELAXED)) {
+      return;
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store(&e->root, (double *)&root, __ATOMIC_RELAXED);
+    __atomic_store(&e->a, (double *)&a, __ATOMIC_RELAXED);
+    __atomic_store(&e->b, (double *)&b, __ATOMIC_RELAXED);
+    __atomic_store_n(&e->seq, s + 2, __ATOMIC_RELEASE);
+    return;
+  }
+}
+
+/*
+ * Function   : roots_cached
+ * Author     : Leo Werneck
+ *
+ * Find the root of f(x) in the interval [a,b] using the given method and a
+ * root cache.
+ *
+ * On a cache hit, f is evaluated at the end points of a small interval around
+ * the cached root, of half-width equal to the width of the cached bracket
+ * (but at least r->tol). If the interval brackets the root, the method is
+ * applied to it, reusing these two evaluations. Otherwise, the interval is
+ * moved to the secant estimate of the root computed from them and widened,
+ * and the process is repeated until the interval covers [a,b]. On a cache
+ * miss, the method is applied to [a,b]. Successful results are stored in the
+ * cache.
+ *
+ * Parameters : method   - Root-finding method, e.g., roots_brent.
+ *            : f        - Function for which the root is computed.
+ *            : fparams  - Object containing all parameters needed by the
+ *                         function f other than the variable x.
+ *            : a        - Lower limit of the initial interval.
+ *            : b        - Upper limit of the initial interval.
+ *            : cache    - Root cache (see roots_cache_open).
+ *            : key      - Key identifying the problem, typically computed
+ *                         from fparams with roots_cache_key.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         The root is stored in r->root; r->n_evals counts
+ *                         all evaluations of f.
+ *
+ * Returns    : The error key returned by the method.
+ */
+roots_error_t roots_cached(
+      roots_method method,
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      double a,
+      double b,
+      roots_cache *cache,
+      const uint64_t key,
+      roots_params *restrict r) {
+
+  // Step 1: Look up the key
+  if(a > b) {
+    swap(&a, &b);
+  }
+  double x, lo, hi;
+  if(!roots_cache_lookup(cache, key, &x, &lo, &hi) || !(x >= a && x <= b)) {
+    if(method(f, fparams, a, b, r) == roots_success) {
+      roots_cache_store(cache, key, r->root, r->bracket_a, r->bracket_b);
+    }
+    return r->error_key;
+  }
+
+  // Step 2: Solve near the cached root
+  solve_near(method, f, fparams, a, b, x, fmax(hi - lo, r->tol), r);
+
+  // Step 3: Update the cache
+  if(r->error_key == roots_success) {
+    roots_cache_store(cache, key, r->root, r->bracket_a, r->bracket_b);
+  }
+  return r->error_key;
+}
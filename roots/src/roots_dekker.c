@@ -21,6 +21,9 @@
  *                   does not bracket a root of f(x)
  *                 - roots_error_max_iter if the maximum allowed number of
  *                   iterations is exceeded
+ *                 - roots_error_max_evals if the maximum allowed number of
+ *                   function evaluations is exceeded
+ *                 - roots_error_deadline if the deadline has passed
  *
  * References : https://en.wikipedia.org/wiki/Brent%27s_method
  */
@@ -42,46 +45,57 @@ roots_error_t roots_dekker(
     return r->error_key;
   }
 
-  // Step 2: Define d, such that f(d) * f(b) < 0 (initially a).
+  // Step 2: Define the contrapoint d, such that f(d) * f(b) < 0 (initially
+  //         a); a holds the previous iterate. Near multiple roots the secant
+  //         line is drawn through the deflated function values (see
+  //         track_root).
   double d = a;
+  double fd = fa;
+  iterates it = { 0 };
 
   // Step 3: Dekker's algorithm
   for(r->n_iters = 1; r->n_iters <= r->max_iters; r->n_iters++) {
-    // Step 3.a: Compute the midpoint
-    const double m = (b + d) / 2;
+    // Step 3.a: Check whether we can afford another function evaluation
+    if(budget_exhausted(r, d, b, fd, fb)) {
+      return r->error_key;
+    }
 
-    // Step 3.b: Compute the secant method
-    const double s = fa != fb ? b - fb * (b - a) / (fb - fa) : m;
+    // Step 3.b: Compute the midpoint
+    const double m = midpoint(b, d, r);
 
-    // Step 3.c: Set the next guess for the root
-    const double c = (s > b && s < m) ? s : m;
+    // Step 3.c: Compute the secant method
+    const double ga = deflate(fa, r->multiplicity);
+    const double gb = deflate(fb, r->multiplicity);
+    const double s = ga != gb ? b - gb * (b - a) / (gb - ga) : m;
 
-    // Step 3.d: Compute the next function value
-    const double fc = f(c, fparams);
+    // Step 3.d: Set the next guess for the root
+    const double c = is_inside(s, b, m) ? s : m;
 
-    // Step 3.e: Cicle the values of a, b, fa, fb
-    if(fa * fb < 0) {
-      b = c;
-      fb = fc;
-    }
-    else {
+    // Step 3.e: Compute the next function value
+    const double fc = evaluate(f, fparams, c, r);
+    track_root(&it, c, fc, c == s, r);
+
+    // Step 3.f: Cicle the values: a <- b <- c, fa <- fb <- fc. If f changes
+    //           sign between b and c, b becomes the contrapoint.
+    if(fc * fd > 0) {
       d = b;
-      a = c;
-      fa = fc;
+      fd = fb;
     }
+    a = b;
+    fa = fb;
+    b = c;
+    fb = fc;
 
-    // Step 3.f: Keep best root in b
-    ensure_b_is_closest_to_root(&a, &b, &fa, &fb);
+    // Step 3.g: Keep best root in b
+    ensure_b_is_closest_to_root(&d, &b, &fd, &fb);
 
     // Step 3.h: Check for convergence
-    if(fabs(b - a) < r->tol || fb == 0.0) {
-      r->root = b;
-      r->residual = fb;
-      return (r->error_key = roots_success);
+    if(fabs(b - d) < r->tol || fb == 0.0) {
+      return set_root(r, roots_success, b, fb, d, b);
     }
   }
 
   // Step 4: The only way to get here is if we have exceeded the maximum number
   //         of iterations allowed.
-  return (r->error_key = roots_error_max_iter);
+  return set_best(r, roots_error_max_iter, d, b, fd, fb);
 }
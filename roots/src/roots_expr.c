@@ -0,0 +1,948 @@
+#include <ctype.h>
+#include <string.h>
+
+#include "roots.h"
+#include "dispatch.h"
+
+// Number of points processed by each instruction of the vectorized
+// interpreter; large enough to amortize the dispatch, small enough for the
+// registers to stay in the L1 cache.
+#define BLOCK 128
+
+// Maximum nesting depth of parentheses and unary operators
+#define MAX_DEPTH 256
+
+// Expressions with up to STACK_SLOTS slots are evaluated with workspaces on
+// the stack; larger ones allocate them on the heap for every call, since an
+// expression may be evaluated by several threads at once
+#define STACK_SLOTS 32
+
+// Operations; those from op_add onwards take two arguments
+typedef enum {
+  op_x,
+  op_const,
+  op_param,
+  op_copy,
+  op_neg,
+  op_sqrt,
+  op_cbrt,
+  op_exp,
+  op_log,
+  op_sin,
+  op_cos,
+  op_tan,
+  op_asin,
+  op_acos,
+  op_atan,
+  op_sinh,
+  op_cosh,
+  op_tanh,
+  op_abs,
+  op_erf,
+  op_erfc,
+  op_add,
+  op_sub,
+  op_mul,
+  op_div,
+  op_pow,
+  op_atan2,
+  op_hypot,
+  op_min,
+  op_max
+} expr_op;
+
+static const struct {
+  const char *name;
+  expr_op op;
+} functions[] = {
+  { "sqrt", op_sqrt },   { "cbrt", op_cbrt },   { "exp", op_exp },
+  { "log", op_log },     { "sin", op_sin },     { "cos", op_cos },
+  { "tan", op_tan },     { "asin", op_asin },   { "acos", op_acos },
+  { "atan", op_atan },   { "sinh", op_sinh },   { "cosh", op_cosh },
+  { "tanh", op_tanh },   { "abs", op_abs },     { "erf", op_erf },
+  { "erfc", op_erfc },   { "pow", op_pow },     { "atan2", op_atan2 },
+  { "hypot", op_hypot }, { "min", op_min },     { "max", op_max },
+};
+
+// Node of the expression graph. Leaves are x, constants (value), and
+// parameters (index a); the other nodes apply op to the nodes a and b.
+typedef struct {
+  expr_op op;
+  unsigned a, b;
+  double value;
+} expr_node;
+
+typedef struct {
+  expr_op op;
+  unsigned d, a, b;
+} expr_instr;
+
+typedef struct {
+  bool param;
+  unsigned index;
+  double value;
+} expr_leaf;
+
+// Compiled expression. Instructions read and write slots: slot 0 holds x,
+// slots 1 to n_leaves hold the constants and parameters, the next n_temps
+// slots hold intermediate results, and the last slot holds the result.
+struct roots_expr {
+  unsigned n_leaves, n_temps, n_instrs, n_params;
+  expr_leaf *leaves;
+  expr_instr *instrs;
+};
+
+typedef struct {
+  const char *s, *error_at;
+  unsigned n_params;
+  const char *const *names;
+  expr_node *nodes;
+  unsigned n_nodes;
+  unsigned *table, table_size;
+  unsigned depth;
+  bool error;
+} builder;
+
+/*
+ * Function   : apply
+ * Author     : Leo Werneck
+ *
+ * Applies an operation to one or two numbers.
+ *
+ * Parameters : op       - Operation (neither a leaf nor a copy).
+ *            : a, b     - Arguments; b is ignored by unary operations.
+ *
+ * Returns    : The result.
+ */
+static inline double apply(const expr_op op, const double a, const double b) {
+
+  switch(op) {
+    case op_neg:
+      return -a;
+    case op_sqrt:
+      return sqrt(a);
+    case op_cbrt:
+      return cbrt(a);
+    case op_exp:
+      return exp(a);
+    case op_log:
+      return log(a);
+    case op_sin:
+      return sin(a);
+    case op_cos:
+      return cos(a);
+    case op_tan:
+      return tan(a);
+    case op_asin:
+      return asin(a);
+    case op_acos:
+      return acos(a);
+    case op_atan:
+      return atan(a);
+    case op_sinh:
+      return sinh(a);
+    case op_cosh:
+      return cosh(a);
+    case op_tanh:
+      return tanh(a);
+    case op_abs:
+      return fabs(a);
+    case op_erf:
+      return erf(a);
+    case op_erfc:
+      return erfc(a);
+    case op_add:
+      return a + b;
+    case op_sub:
+      return a - b;
+    case op_mul:
+      return a * b;
+    case op_div:
+      return a / b;
+    case op_pow:
+      return pow(a, b);
+    case op_atan2:
+      return atan2(a, b);
+    case op_hypot:
+      return hypot(a, b);
+    case op_min:
+      return fmin(a, b);
+    case op_max:
+      return fmax(a, b);
+    default:
+      return a;
+  }
+}
+
+// Loop over a block; the restrict qualifiers let compilers vectorize it
+#define LOOP(expr)                  \
+  for(unsigned i = 0; i < m; i++) { \
+    d[i] = expr;                    \
+  }                                 \
+  return
+
+/*
+ * Function   : apply_block
+ * Author     : Leo Werneck
+ *
+ * Applies an operation to a block of points.
+ *
+ * Parameters : op       - Operation (not a leaf).
+ *            : m        - Number of points.
+ *            : d        - Results (output).
+ *            : a, b     - Arguments; b is ignored by unary operations.
+ *
+ * Returns    : Nothing.
+ */
+KERNEL void apply_block_kernel(
+      const expr_op op,
+      const unsigned m,
+      double *restrict d,
+      const double *restrict a,
+      const double *restrict b) {
+
+  switch(op) {
+    case op_neg:
+      LOOP(-a[i]);
+    case op_sqrt:
+      LOOP(sqrt(a[i]));
+    case op_cbrt:
+      LOOP(cbrt(a[i]));
+    case op_exp:
+      LOOP(exp(a[i]));
+    case op_log:
+      LOOP(log(a[i]));
+    case op_sin:
+      LOOP(sin(a[i]));
+    case op_cos:
+      LOOP(cos(a[i]));
+    case op_tan:
+      LOOP(tan(a[i]));
+    case op_asin:
+      LOOP(asin(a[i]));
+    case op_acos:
+      LOOP(acos(a[i]));
+    case op_atan:
+      LOOP(atan(a[i]));
+    case op_sinh:
+      LOOP(sinh(a[i]));
+    case op_cosh:
+      LOOP(cosh(a[i]));
+    case op_tanh:
+      LOOP(tanh(a[i]));
+    case op_abs:
+      LOOP(fabs(a[i]));
+    case op_erf:
+      LOOP(erf(a[i]));
+    case op_erfc:
+      LOOP(erfc(a[i]));
+    case op_add:
+      LOOP(a[i] + b[i]);
+    case op_sub:
+      LOOP(a[i] - b[i]);
+    case op_mul:
+      LOOP(a[i] * b[i]);
+    case op_div:
+      LOOP(a[i] / b[i]);
+    case op_pow:
+      LOOP(pow(a[i], b[i]));
+    case op_atan2:
+      LOOP(atan2(a[i], b[i]));
+    case op_hypot:
+      LOOP(hypot(a[i], b[i]));
+    case op_min:
+      LOOP(fmin(a[i], b[i]));
+    case op_max:
+      LOOP(fmax(a[i], b[i]));
+    default:
+      LOOP(a[i]);
+  }
+}
+
+#undef LOOP
+
+DISPATCH_KERNEL(apply_block,
+                (const expr_op op,
+                 const unsigned m,
+                 double *restrict d,
+                 const double *restrict a,
+                 const double *restrict b),
+                (op, m, d, a, b));
+
+/*
+ * Function   : fail
+ * Author     : Leo Werneck
+ *
+ * Flags a syntax error at the current position; later errors are ignored.
+ *
+ * Parameters : bd       - Builder.
+ *
+ * Returns    : 0, a placeholder node index.
+ */
+static unsigned fail(builder *bd) {
+
+  if(!bd->error) {
+    bd->error = true;
+    bd->error_at = bd->s;
+  }
+  return 0;
+}
+
+/*
+ * Function   : hash_node
+ * Author     : Leo Werneck
+ *
+ * Hashes the operation, arguments, and value of a node.
+ *
+ * Parameters : n        - Node.
+ *
+ * Returns    : The hash.
+ */
+static uint64_t hash_node(const expr_node *n) {
+
+  uint64_t v;
+  memcpy(&v, &n->value, sizeof(v));
+  uint64_t h = ((uint64_t)n->op << 48) ^ ((uint64_t)n->a << 24) ^ n->b;
+  h = (h ^ v) * 0x9e3779b97f4a7c15ULL;
+  return h ^ (h >> 29);
+}
+
+/*
+ * Function   : intern
+ * Author     : Leo Werneck
+ *
+ * Returns the index of a node equal to n, adding n to the graph if there is
+ * none (hash-consing). Equal subexpressions thus share a single node, which
+ * eliminates common subexpressions.
+ *
+ * Parameters : bd       - Builder.
+ *            : n        - Node.
+ *
+ * Returns    : The index of the node.
+ */
+static unsigned intern(builder *bd, const expr_node n) {
+
+  // Step 1: Grow the hash table at half load
+  if(2 * (bd->n_nodes + 1) > bd->table_size) {
+    const unsigned size = bd->table_size ? 2 * bd->table_size : 64;
+    unsigned *table = calloc(size, sizeof(unsigned));
+    expr_node *nodes = realloc(bd->nodes, sizeof(expr_node) * size / 2);
+    if(!table || !nodes) {
+      free(table);
+      bd->nodes = nodes ? nodes : bd->nodes;
+      return fail(bd);
+    }
+    bd->nodes = nodes;
+    for(unsigned i = 0; i < bd->n_nodes; i++) {
+      unsigned h = hash_node(&bd->nodes[i]) & (size - 1);
+      while(table[h]) {
+        h = (h + 1) & (size - 1);
+      }
+      table[h] = i + 1;
+    }
+    free(bd->table);
+    bd->table = table;
+    bd->table_size = size;
+  }
+
+  // Step 2: Look for the node; add it if not found
+  unsigned h = hash_node(&n) & (bd->table_size - 1);
+  while(bd->table[h]) {
+    const expr_node *m = &bd->nodes[bd->table[h] - 1];
+    if(m->op == n.op && m->a == n.a && m->b == n.b
+       && !memcmp(&m->value, &n.value, sizeof(double))) {
+      return bd->table[h] - 1;
+    }
+    h = (h + 1) & (bd->table_size - 1);
+  }
+  bd->nodes[bd->n_nodes] = n;
+  bd->table[h] = ++bd->n_nodes;
+  return bd->n_nodes - 1;
+}
+
+static unsigned constant(builder *bd, const double value) {
+  return intern(bd, (expr_node){ op_const, 0, 0, value });
+}
+
+static bool is_constant(const builder *bd, const unsigned i, const double value) {
+  return bd->nodes[i].op == op_const && bd->nodes[i].value == value;
+}
+
+/*
+ * Function   : node
+ * Author     : Leo Werneck
+ *
+ * Adds an operation to the graph, simplifying it first: operations on
+ * constants are folded, the arguments of commutative operations are sorted
+ * so that, e.g., x*y and y*x are the same node, and trivial operations
+ * (x+0, x*1, x^1, -(-x), ...) are removed. Powers with small integer
+ * exponents become products, whose factors are shared.
+ *
+ * Parameters : bd       - Builder.
+ *            : op       - Operation.
+ *            : a, b     - Arguments; b is ignored by unary operations.
+ *
+ * Returns    : The index of the node.
+ */
+static unsigned node(builder *bd, const expr_op op, unsigned a, unsigned b) {
+
+  if(bd->error) {
+    return 0;
+  }
+  const bool binary = op >= op_add;
+  b = binary ? b : 0;
+
+  // Step 1: Constant folding
+  if(bd->nodes[a].op == op_const && (!binary || bd->nodes[b].op == op_const)) {
+    return constant(bd, apply(op, bd->nodes[a].value, bd->nodes[b].value));
+  }
+
+  // Step 2: Canonical order of the arguments of commutative operations
+  const bool commutative
+        = op == op_add || op == op_mul || op == op_hypot || op == op_min || op == op_max;
+  if(commutative && a > b) {
+    const unsigned c = a;
+    a = b;
+    b = c;
+  }
+
+  // Step 3: Algebraic simplifications
+  switch(op) {
+    case op_neg:
+      if(bd->nodes[a].op == op_neg) {
+        return bd->nodes[a].a;
+      }
+      break;
+    case op_add:
+      if(is_constant(bd, a, 0) || is_constant(bd, b, 0)) {
+        return is_constant(bd, a, 0) ? b : a;
+      }
+      break;
+    case op_sub:
+      if(is_constant(bd, b, 0)) {
+        return a;
+      }
+      if(is_constant(bd, a, 0)) {
+        return node(bd, op_neg, b, 0);
+      }
+      break;
+    case op_mul:
+      if(is_constant(bd, a, 1) || is_constant(bd, b, 1)) {
+        return is_constant(bd, a, 1) ? b : a;
+      }
+      if(is_constant(bd, a, -1) || is_constant(bd, b, -1)) {
+        return node(bd, op_neg, is_constant(bd, a, -1) ? b : a, 0);
+      }
+      break;
+    case op_div:
+      if(is_constant(bd, b, 1)) {
+        return a;
+      }
+      break;
+    case op_pow:
+      if(bd->nodes[b].op == op_const) {
+        const double p = bd->nodes[b].value;
+        if(p == 0.5) {
+          return node(bd, op_sqrt, a, 0);
+        }
+        if(p == rint(p) && fabs(p) >= 1 && fabs(p) <= 64) {
+          // Binary exponentiation: x^|p| is a product of repeated squares
+          unsigned res = a, sq = a;
+          bool first = true;
+          for(unsigned n = fabs(p); n; n >>= 1) {
+            if(n & 1) {
+              res = first ? sq : node(bd, op_mul, res, sq);
+              first = false;
+            }
+            sq = n > 1 ? node(bd, op_mul, sq, sq) : sq;
+          }
+          return p > 0 ? res : node(bd, op_div, constant(bd, 1), res);
+        }
+      }
+      break;
+    default:
+      break;
+  }
+  return intern(bd, (expr_node){ op, a, b, 0 });
+}
+
+static void skip_spaces(builder *bd) {
+  while(isspace((unsigned char)*bd->s)) {
+    bd->s++;
+  }
+}
+
+static bool accept(builder *bd, const char c) {
+  skip_spaces(bd);
+  if(*bd->s == c) {
+    bd->s++;
+    return true;
+  }
+  return false;
+}
+
+static unsigned parse_sum(builder *bd);
+static unsigned parse_unary(builder *bd);
+
+/*
+ * Function   : parse_primary
+ * Author     : Leo Werneck
+ *
+ * Parses a number, a name (x, a parameter, pi, or e), a function call, or an
+ * expression in parentheses.
+ *
+ * Parameters : bd       - Builder.
+ *
+ * Returns    : The index of the node.
+ */
+static unsigned parse_primary(builder *bd) {
+
+  skip_spaces(bd);
+  const char *s = bd->s;
+
+  // Step 1: Parenthesized expression
+  if(accept(bd, '(')) {
+    const unsigned n = parse_sum(bd);
+    return accept(bd, ')') ? n : fail(bd);
+  }
+
+  // Step 2: Number
+  if(isdigit((unsigned char)*s) || (*s == '.' && isdigit((unsigned char)s[1]))) {
+    char *end;
+    const double v = strtod(s, &end);
+    bd->s = end;
+    return constant(bd, v);
+  }
+
+  // Step 3: Name
+  if(!isalpha((unsigned char)*s) && *s != '_') {
+    return fail(bd);
+  }
+  while(isalnum((unsigned char)*bd->s) || *bd->s == '_') {
+    bd->s++;
+  }
+  const size_t len = bd->s - s;
+
+  // Step 3.a: Function call
+  if(accept(bd, '(')) {
+    for(unsigned i = 0; i < sizeof(functions) / sizeof(*functions); i++) {
+      if(strlen(functions[i].name) == len && !strncmp(s, functions[i].name, len)) {
+        const unsigned a = parse_sum(bd);
+        const unsigned b = functions[i].op >= op_add && accept(bd, ',') ? parse_sum(bd)
+                           : functions[i].op >= op_add                  ? fail(bd)
+                                                                         : 0;
+        return accept(bd, ')') ? node(bd, functions[i].op, a, b) : fail(bd);
+      }
+    }
+    bd->s = s;
+    return fail(bd);
+  }
+
+  // Step 3.b: Variable, parameter, or constant
+  if(len == 1 && *s == 'x') {
+    return intern(bd, (expr_node){ op_x, 0, 0, 0 });
+  }
+  for(unsigned i = 0; i < bd->n_params; i++) {
+    char name[16];
+    const char *p = bd->names ? bd->names[i] : name;
+    if(!bd->names) {
+      sprintf(name, "p%u", i + 1);
+    }
+    if(strlen(p) == len && !strncmp(s, p, len)) {
+      return intern(bd, (expr_node){ op_param, i, 0, 0 });
+    }
+  }
+  if(len == 2 && !strncmp(s, "pi", 2)) {
+    return constant(bd, M_PI);
+  }
+  if(len == 1 && *s == 'e') {
+    return constant(bd, M_E);
+  }
+  bd->s = s;
+  return fail(bd);
+}
+
+/*
+ * Function   : parse_power
+ * Author     : Leo Werneck
+ *
+ * Parses a power, a^b or a**b, which is right associative and binds tighter
+ * than unary minus on its left: -x^2 = -(x^2), and x^-2 = x^(-2).
+ *
+ * Parameters : bd       - Builder.
+ *
+ * Returns    : The index of the node.
+ */
+static unsigned parse_power(builder *bd) {
+
+  const unsigned a = parse_primary(bd);
+  skip_spaces(bd);
+  if(*bd->s == '^' || (bd->s[0] == '*' && bd->s[1] == '*')) {
+    bd->s += *bd->s == '^' ? 1 : 2;
+    return node(bd, op_pow, a, parse_unary(bd));
+  }
+  return a;
+}
+
+static unsigned parse_unary(builder *bd) {
+
+  if(++bd->depth > MAX_DEPTH) {
+    return fail(bd);
+  }
+  unsigned n;
+  if(accept(bd, '-')) {
+    n = node(bd, op_neg, parse_unary(bd), 0);
+  }
+  else if(accept(bd, '+')) {
+    n = parse_unary(bd);
+  }
+  else {
+    n = parse_power(bd);
+  }
+  bd->depth--;
+  return n;
+}
+
+static unsigned parse_product(builder *bd) {
+
+  unsigned n = parse_unary(bd);
+  while(!bd->error) {
+    skip_spaces(bd);
+    if(bd->s[0] == '*' && bd->s[1] != '*') {
+      bd->s++;
+      n = node(bd, op_mul, n, parse_unary(bd));
+    }
+    else if(accept(bd, '/')) {
+      n = node(bd, op_div, n, parse_unary(bd));
+    }
+    else {
+      break;
+    }
+  }
+  return n;
+}
+
+static unsigned parse_sum(builder *bd) {
+
+  if(++bd->depth > MAX_DEPTH) {
+    return fail(bd);
+  }
+  unsigned n = parse_product(bd);
+  while(!bd->error) {
+    if(accept(bd, '+')) {
+      n = node(bd, op_add, n, parse_product(bd));
+    }
+    else if(accept(bd, '-')) {
+      n = node(bd, op_sub, n, parse_product(bd));
+    }
+    else {
+      break;
+    }
+  }
+  bd->depth--;
+  return n;
+}
+
+/*
+ * Function   : generate
+ * Author     : Leo Werneck
+ *
+ * Generates the instructions that evaluate the graph rooted at the given
+ * node. The nodes are already in topological order (arguments are created
+ * before the operations that use them); slots of intermediate results are
+ * reused once their last user has been generated.
+ *
+ * Parameters : bd       - Builder.
+ *            : root     - Root of the graph.
+ *            : e        - Expression (output).
+ *
+ * Returns    : true on success, false if out of memory.
+ */
+static bool generate(const builder *bd, const unsigned root, roots_expr *e) {
+
+  const unsigned n = bd->n_nodes;
+  const expr_node *nodes = bd->nodes;
+  unsigned *last = malloc(sizeof(unsigned) * n);
+  unsigned *slot = malloc(sizeof(unsigned) * n);
+  unsigned *free_slots = malloc(sizeof(unsigned) * n);
+  bool *live = calloc(n, sizeof(bool));
+  e->leaves = malloc(sizeof(expr_leaf) * n);
+  e->instrs = malloc(sizeof(expr_instr) * (n + 1));
+  if(!last || !slot || !free_slots || !live || !e->leaves || !e->instrs) {
+    free(last);
+    free(slot);
+    free(free_slots);
+    free(live);
+    return false;
+  }
+
+  // Step 1: Find the nodes the root depends on, and the last user of each
+  live[root] = true;
+  for(unsigned i = root + 1; i-- > 0;) {
+    if(live[i] && nodes[i].op > op_copy) {
+      live[nodes[i].a] = true;
+      live[nodes[i].b] = nodes[i].op >= op_add || live[nodes[i].b];
+    }
+  }
+  for(unsigned i = 0; i <= root; i++) {
+    if(live[i] && nodes[i].op > op_copy) {
+      last[nodes[i].a] = i;
+      last[nodes[i].b] = nodes[i].op >= op_add ? i : last[nodes[i].b];
+    }
+  }
+
+  // Step 2: Assign slots to the leaves
+  for(unsigned i = 0; i <= root; i++) {
+    if(live[i] && nodes[i].op == op_x) {
+      slot[i] = 0;
+    }
+    else if(live[i] && nodes[i].op <= op_param) {
+      expr_leaf *l = &e->leaves[e->n_leaves++];
+      l->param = nodes[i].op == op_param;
+      l->index = nodes[i].a;
+      l->value = nodes[i].value;
+      slot[i] = e->n_leaves;
+    }
+  }
+
+  // Step 3: Generate the instructions. The slots of intermediate results are
+  //         numbered from zero here and offset at the end.
+  const unsigned temp = 1u << 31;
+  unsigned n_free = 0;
+  for(unsigned i = 0; i <= root; i++) {
+    if(!live[i] || nodes[i].op <= op_param) {
+      continue;
+    }
+    slot[i] = i == root ? ~0u : temp + (n_free ? free_slots[--n_free] : e->n_temps++);
+    const unsigned b = nodes[i].op >= op_add ? nodes[i].b : nodes[i].a;
+    e->instrs[e->n_instrs++]
+          = (expr_instr){ nodes[i].op, slot[i], slot[nodes[i].a], slot[b] };
+    for(int k = 0; k < 1 + (nodes[i].op >= op_add); k++) {
+      const unsigned c = k ? nodes[i].b : nodes[i].a;
+      if(last[c] == i && slot[c] >= temp && slot[c] != ~0u
+         && (k == 0 || c != nodes[i].a)) {
+        free_slots[n_free++] = slot[c] - temp;
+      }
+    }
+  }
+  if(nodes[root].op <= op_param) {
+    e->instrs[e->n_instrs++] = (expr_instr){ op_copy, ~0u, slot[root], slot[root] };
+  }
+
+  // Step 4: Final slot numbers
+  const unsigned out = 1 + e->n_leaves + e->n_temps;
+  for(unsigned i = 0; i < e->n_instrs; i++) {
+    expr_instr *in = &e->instrs[i];
+    unsigned *s[3] = { &in->d, &in->a, &in->b };
+    for(int k = 0; k < 3; k++) {
+      *s[k] = *s[k] == ~0u ? out
+                           : (*s[k] >= temp ? *s[k] - temp + 1 + e->n_leaves : *s[k]);
+    }
+  }
+
+  free(last);
+  free(slot);
+  free(free_slots);
+  free(live);
+  return true;
+}
+
+/*
+ * Function   : roots_expr_compile
+ * Author     : Leo Werneck
+ *
+ * Compiles a formula f(x) into bytecode for roots_expr_f and roots_expr_fv.
+ * Formulas use numbers, x, parameters, the constants pi and e, the operators
+ * + - * / and ^ (or **), and the functions sqrt, cbrt, exp, log, sin, cos,
+ * tan, asin, acos, atan, sinh, cosh, tanh, abs, erf, erfc, pow, atan2, hypot,
+ * min, and max, e.g., "x - e*sin(x) - M" with the parameters e and M.
+ *
+ * The formula is compiled into a graph in which equal subexpressions share a
+ * single node, operations on constants are folded, and small integer powers
+ * become products. Each node of the graph then becomes one instruction.
+ *
+ * Parameters : formula   - Formula.
+ *            : n_params  - Number of parameters.
+ *            : names     - Names of the parameters. If NULL, the parameters
+ *                          are named p1, ..., pn.
+ *            : error_pos - If not NULL, set to the position of the first
+ *                          syntax error in the formula, or to -1 on success.
+ *
+ * Returns    : The compiled expression, or NULL on errors. It must be freed
+ *              with roots_expr_free.
+ */
+roots_expr *roots_expr_compile(
+      const char *formula,
+      const unsigned n_params,
+      const char *const *names,
+      int *error_pos) {
+
+  // Step 1: Parse the formula into a graph
+  builder bd = { formula, NULL, n_params, names, NULL, 0, NULL, 0, 0, false };
+  const unsigned root = parse_sum(&bd);
+  skip_spaces(&bd);
+  if(*bd.s != '\0') {
+    fail(&bd);
+  }
+  if(error_pos) {
+    *error_pos = bd.error ? (int)(bd.error_at - formula) : -1;
+  }
+
+  // Step 2: Generate the bytecode
+  roots_expr *e = bd.error ? NULL : calloc(1, sizeof(roots_expr));
+  if(e) {
+    e->n_params = n_params;
+    if(!generate(&bd, root, e)) {
+      roots_expr_free(e);
+      e = NULL;
+    }
+  }
+  free(bd.nodes);
+  free(bd.table);
+  return e;
+}
+
+/*
+ * Function   : roots_expr_free
+ * Author     : Leo Werneck
+ *
+ * Frees a compiled expression.
+ *
+ * Parameters : e        - Expression (may be NULL).
+ *
+ * Returns    : Nothing.
+ */
+void roots_expr_free(roots_expr *e) {
+
+  if(e) {
+    free(e->leaves);
+    free(e->instrs);
+    free(e);
+  }
+}
+
+/*
+ * Function   : roots_expr_size
+ * Author     : Leo Werneck
+ *
+ * Returns the number of instructions of a compiled expression, i.e., the
+ * number of operations left after folding and sharing.
+ *
+ * Parameters : e        - Expression.
+ *
+ * Returns    : The number of instructions.
+ */
+unsigned roots_expr_size(const roots_expr *e) { return e->n_instrs; }
+
+/*
+ * Function   : roots_expr_f
+ * Author     : Leo Werneck
+ *
+ * Evaluates a compiled expression at a single point. Has the signature of
+ * the functions passed to the root-finding methods, e.g.,
+ *   roots_expr_params p = { e, values };
+ *   roots_brent(roots_expr_f, &p, a, b, &r);
+ *
+ * Parameters : x        - Point at which the expression is evaluated.
+ *            : params   - Pointer to a roots_expr_params struct.
+ *
+ * Returns    : The value of the expression, or NAN if a large expression
+ *              cannot allocate its workspace.
+ */
+double roots_expr_f(const double x, void *restrict params) {
+
+  const roots_expr_params *p = (const roots_expr_params *)params;
+  const roots_expr *e = p->expr;
+  const unsigned n_slots = 2 + e->n_leaves + e->n_temps;
+  double stack[STACK_SLOTS];
+  double *v = n_slots <= STACK_SLOTS ? stack : malloc(sizeof(double) * n_slots);
+  if(!v) {
+    return NAN;
+  }
+  v[0] = x;
+  for(unsigned k = 0; k < e->n_leaves; k++) {
+    v[1 + k] = e->leaves[k].param ? p->p[e->leaves[k].index] : e->leaves[k].value;
+  }
+  for(unsigned i = 0; i < e->n_instrs; i++) {
+    const expr_instr *in = &e->instrs[i];
+    v[in->d] = apply(in->op, v[in->a], v[in->b]);
+  }
+  const double fx = v[n_slots - 1];
+  if(v != stack) {
+    free(v);
+  }
+  return fx;
+}
+
+/*
+ * Function   : roots_expr_fv
+ * Author     : Leo Werneck
+ *
+ * Evaluates a compiled expression at many points (see roots_vector_function).
+ * The points are processed in blocks, and each instruction is applied to a
+ * whole block at a time, so that the cost of decoding the instructions is
+ * shared by all points of the block and the arithmetic vectorizes.
+ *
+ * Parameters : n        - Number of points.
+ *            : x        - Points at which the expression is evaluated.
+ *            : params   - Pointer to a roots_expr_params struct.
+ *            : fx       - Values of the expression (output); NAN if a large
+ *                         expression cannot allocate its workspace.
+ *
+ * Returns    : Nothing.
+ */
+void roots_expr_fv(
+      const unsigned n,
+      const double *restrict x,
+      void *restrict params,
+      double *restrict fx) {
+
+  const roots_expr_params *p = (const roots_expr_params *)params;
+  const roots_expr *e = p->expr;
+  const unsigned n_slots = 2 + e->n_leaves + e->n_temps;
+
+  // Step 1: Set up the workspace: the slots, and the blocks of all slots
+  //         but the input and the output
+  double *reg_stack[STACK_SLOTS], blocks_stack[BLOCK * (STACK_SLOTS - 2)];
+  double **reg = reg_stack, *blocks = blocks_stack;
+  if(n_slots > STACK_SLOTS) {
+    reg = malloc(sizeof(double *) * n_slots);
+    blocks = malloc(sizeof(double) * BLOCK * (n_slots - 2));
+    if(!reg || !blocks) {
+      free(reg);
+      free(blocks);
+      for(unsigned i = 0; i < n; i++) {
+        fx[i] = NAN;
+      }
+      return;
+    }
+  }
+
+  // Step 2: Broadcast the leaves; point the slots at their blocks
+  for(unsigned k = 0; k < e->n_leaves; k++) {
+    const double v = e->leaves[k].param ? p->p[e->leaves[k].index] : e->leaves[k].value;
+    reg[1 + k] = blocks + k * BLOCK;
+    for(unsigned i = 0; i < BLOCK; i++) {
+      reg[1 + k][i] = v;
+    }
+  }
+  for(unsigned k = 1 + e->n_leaves; k < n_slots - 1; k++) {
+    reg[k] = blocks + (k - 1) * BLOCK;
+  }
+
+  // Step 3: Run the instructions block by block. The input and the output
+  //         slots point directly into x and fx.
+  for(unsigned j = 0; j < n; j += BLOCK) {
+    const unsigned m = n - j < BLOCK ? n - j : BLOCK;
+    reg[0] = (double *)x + j;
+    reg[n_slots - 1] = fx + j;
+    for(unsigned i = 0; i < e->n_instrs; i++) {
+      const expr_instr *in = &e->instrs[i];
+      DISPATCH(apply_block)(in->op, m, reg[in->d], reg[in->a], reg[in->b]);
+    }
+  }
+  if(reg != reg_stack) {
+    free(reg);
+    free(blocks);
+  }
+}
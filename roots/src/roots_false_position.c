@@ -21,6 +21,9 @@
  *                   does not bracket a root of f(x)
  *                 - roots_error_max_iter if the maximum allowed number of
  *                   iterations is exceeded
+ *                 - roots_error_max_evals if the maximum allowed number of
+ *                   function evaluations is exceeded
+ *                 - roots_error_deadline if the deadline has passed
  *
  * References : https://en.wikipedia.org/wiki/Regula_falsi
  */
@@ -42,20 +45,28 @@ roots_error_t roots_false_position(
     return r->error_key;
   }
 
-  // Step 2: False-position algorithm
+  // Step 2: False-position algorithm. Near multiple roots the secant line is
+  //         drawn through the deflated function values (see track_root).
+  iterates it = { 0 };
   for(r->n_iters = 1; r->n_iters <= r->max_iters; r->n_iters++) {
-    // Step 2.a: Compute the new point
-    const double c = (a * fb - b * fa) / (fb - fa);
-    const double fc = f(c, fparams);
+    // Step 2.a: Check whether we can afford another function evaluation
+    if(budget_exhausted(r, a, b, fa, fb)) {
+      return r->error_key;
+    }
+
+    // Step 2.b: Compute the new point
+    const double ga = deflate(fa, r->multiplicity);
+    const double gb = deflate(fb, r->multiplicity);
+    const double c = (a * gb - b * ga) / (gb - ga);
+    const double fc = evaluate(f, fparams, c, r);
+    track_root(&it, c, fc, true, r);
 
-    // Step 2.b: Check for convergence
+    // Step 2.c: Check for convergence
     if(fabs(c - b) < r->tol || fc == 0.0) {
-      r->root = c;
-      r->residual = fc;
-      return (r->error_key = roots_success);
+      return set_root(r, roots_success, c, fc, a, b);
     }
 
-    // Step 2.c: Adjust the interval, making sure the root is still in [a,b]
+    // Step 2.d: Adjust the interval, making sure the root is still in [a,b]
     if(fa * fc < 0) {
       b = c;
       fb = fc;
@@ -68,5 +79,193 @@ roots_error_t roots_false_position(
 
   // Step 3: The only way to get here is if we have exceeded the maximum number
   //         of iterations allowed.
-  return (r->error_key = roots_error_max_iter);
+  return set_best(r, roots_error_max_iter, a, b, fa, fb);
+}
+
+/*
+ * The modified false position methods differ only in the factor by which
+ * f(a) is scaled when the same end point a is retained twice in a row.
+ */
+typedef enum {
+  illinois,
+  pegasus,
+  anderson_bjorck
+} false_position_variant_t;
+
+/*
+ * Function   : modified_false_position
+ * Author     : Leo Werneck
+ *
+ * Find the root of f(x) in the interval [a,b] using a modified false
+ * position method. In this formulation b is always the latest iterate and a
+ * is the retained end point of the bracket. Whenever the new iterate c falls
+ * on the same side of the root as b, the end point a is retained once more
+ * and f(a) is scaled down, which prevents a from remaining fixed for the rest
+ * of the iteration and restores superlinear convergence.
+ *
+ * Parameters : f        - Function for which the root is computed.
+ *            : fparams  - Object containing all parameters needed by the
+ *                         function f other than the variable x.
+ *            : a        - Lower limit of the initial interval.
+ *            : b        - Upper limit of the initial interval.
+ *            : variant  - Which modification of the method to use.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         The root is stored in r->root.
+ *
+ * Returns    : One the following error keys:
+ *                 - roots_success if the root is found
+ *                 - roots_error_root_not_bracketed if the interval [a,b]
+ *                   does not bracket a root of f(x)
+ *                 - roots_error_max_iter if the maximum allowed number of
+ *                   iterations is exceeded
+ *                 - roots_error_max_evals if the maximum allowed number of
+ *                   function evaluations is exceeded
+ *                 - roots_error_deadline if the deadline has passed
+ *
+ * References : Dowell & Jarratt, BIT 11, 168 (1971)
+ *            : Dowell & Jarratt, BIT 12, 503 (1972)
+ *            : Anderson & Bjorck, BIT 13, 253 (1973)
+ */
+static roots_error_t modified_false_position(
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      double a,
+      double b,
+      const false_position_variant_t variant,
+      roots_params *restrict r) {
+
+  // Step 0: Set basic info to the roots_params struct
+  switch(variant) {
+    case illinois:
+      sprintf(r->method, "Illinois");
+      break;
+    case pegasus:
+      sprintf(r->method, "Pegasus");
+      break;
+    case anderson_bjorck:
+      sprintf(r->method, "Anderson-Bjorck");
+      break;
+  }
+  r->a = a;
+  r->b = b;
+
+  // Step 1: Check whether a or b is the root; compute fa and fb
+  double fa, fb;
+  if(check_a_b_compute_fa_fb(f, fparams, &a, &b, &fa, &fb, r) >= roots_success) {
+    return r->error_key;
+  }
+
+  // Step 2: Modified false-position algorithm. The scaled value of f(a) used
+  //         in the interpolation is stored in ga.
+  double ga = fa;
+  for(r->n_iters = 1; r->n_iters <= r->max_iters; r->n_iters++) {
+    // Step 2.a: Check whether we can afford another function evaluation
+    if(budget_exhausted(r, a, b, fa, fb)) {
+      return r->error_key;
+    }
+
+    // Step 2.b: Compute the new point
+    const double c = (a * fb - b * ga) / (fb - ga);
+    const double fc = evaluate(f, fparams, c, r);
+
+    // Step 2.c: Check for convergence
+    if(fabs(c - b) < r->tol || fc == 0.0) {
+      return set_root(r, roots_success, c, fc, a, b);
+    }
+
+    // Step 2.d: Adjust the interval, making sure the root is still in [a,b]
+    if(fb * fc < 0) {
+      // Step 2.d.1: The root is between b and c; b becomes the end point
+      a = b;
+      fa = ga = fb;
+    }
+    else {
+      // Step 2.d.2: The end point a is retained; scale f(a)
+      double m = 0.5;
+      if(variant == pegasus) {
+        m = fb / (fb + fc);
+      }
+      else if(variant == anderson_bjorck) {
+        m = 1 - fc / fb;
+        m = m > 0 ? m : 0.5;
+      }
+      ga *= m;
+    }
+    b = c;
+    fb = fc;
+  }
+
+  // Step 3: The only way to get here is if we have exceeded the maximum number
+  //         of iterations allowed.
+  return set_best(r, roots_error_max_iter, a, b, fa, fb);
+}
+
+/*
+ * Function   : roots_illinois
+ * Author     : Leo Werneck
+ *
+ * Find the root of f(x) in the interval [a,b] using the Illinois variant of
+ * the false position method, in which f(a) is halved whenever the end point a
+ * is retained twice in a row.
+ *
+ * Parameters : See roots_false_position.
+ *
+ * Returns    : See roots_false_position.
+ *
+ * References : https://en.wikipedia.org/wiki/Regula_falsi#The_Illinois_algorithm
+ */
+roots_error_t roots_illinois(
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      double a,
+      double b,
+      roots_params *restrict r) {
+  return modified_false_position(f, fparams, a, b, illinois, r);
+}
+
+/*
+ * Function   : roots_pegasus
+ * Author     : Leo Werneck
+ *
+ * Find the root of f(x) in the interval [a,b] using the Pegasus variant of
+ * the false position method, in which f(a) is scaled by f(b)/(f(b)+f(c))
+ * whenever the end point a is retained twice in a row.
+ *
+ * Parameters : See roots_false_position.
+ *
+ * Returns    : See roots_false_position.
+ *
+ * References : Dowell & Jarratt, BIT 12, 503 (1972)
+ */
+roots_error_t roots_pegasus(
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      double a,
+      double b,
+      roots_params *restrict r) {
+  return modified_false_position(f, fparams, a, b, pegasus, r);
+}
+
+/*
+ * Function   : roots_anderson_bjorck
+ * Author     : Leo Werneck
+ *
+ * Find the root of f(x) in the interval [a,b] using the Anderson-Bjorck
+ * variant of the false position method, in which f(a) is scaled by
+ * 1 - f(c)/f(b) (or 1/2 if that is not positive) whenever the end point a is
+ * retained twice in a row.
+ *
+ * Parameters : See roots_false_position.
+ *
+ * Returns    : See roots_false_position.
+ *
+ * References : Anderson & Bjorck, BIT 13, 253 (1973)
+ */
+roots_error_t roots_anderson_bjorck(
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      double a,
+      double b,
+      roots_params *restrict r) {
+  return modified_false_position(f, fparams, a, b, anderson_bjorck, r);
 }
@@ -0,0 +1,846 @@
+#include <float.h>
+
+#include "roots.h"
+#include "utils.h"
+#include "dispatch.h"
+
+/*
+ * Fixed-iteration, branch-free solvers. These run a number of iterations that
+ * depends only on the width of the initial interval and on the tolerance (see
+ * roots_fixed_iterations), and make all decisions with selects rather than
+ * branches, so that every solve takes the same time regardless of f. The
+ * only exception is the estimate of f'(root) made at the end if r->recent is
+ * set (see set_root), which depends on the evaluations. Every iteration at
+ * least halves the bracket, so the final bracket is always narrower than the
+ * tolerance. The limits r->max_iters, r->max_evals, and r->deadline are
+ * ignored.
+ *
+ * The batch versions solve many independent problems at once using a
+ * vectorized function (see roots_vector_function). All problems run the same
+ * number of iterations, and the update of the brackets is written so that
+ * compilers can vectorize it. Every call to the vectorized function evaluates
+ * all problems once, so r->n_evals, which counts the calls, is also the
+ * number of evaluations of each problem; like the number of iterations, it
+ * is fixed by the intervals and the tolerance.
+ */
+
+/*
+ * Function   : roots_fixed_iterations
+ * Author     : Leo Werneck
+ *
+ * Computes the number of halvings of the interval [a,b] needed for its width
+ * to drop below tol.
+ *
+ * Parameters : a        - One end of the interval.
+ *            : b        - Other end of the interval.
+ *            : tol      - Tolerance. A relative tolerance of 2 DBL_EPSILON
+ *                         is always added to it.
+ *
+ * Returns    : The number of iterations.
+ */
+unsigned roots_fixed_iterations(const double a, const double b, const double tol) {
+  const double t = fmax(tol, 0) + 2 * DBL_EPSILON * fmax(fabs(a), fabs(b));
+  const double n = ceil(log2(fabs(b - a) / t));
+  return n > 0 && t > 0 ? (unsigned)n : 0;
+}
+
+/*
+ * Function   : bisection_update
+ * Author     : Leo Werneck
+ *
+ * Branch-free bisection update: replaces the end point of [a,b] that has the
+ * same sign as f(m) by m.
+ *
+ * Parameters : m        - Midpoint.
+ *            : fm       - f(m).
+ *            : a, b     - Bracket (updated).
+ *            : fa, fb   - f(a) and f(b) (updated).
+ *
+ * Returns    : Nothing.
+ */
+static inline void bisection_update(
+      const double m,
+      const double fm,
+      double *restrict a,
+      double *restrict b,
+      double *restrict fa,
+      double *restrict fb) {
+
+  const bool left = *fa * fm <= 0;
+  *b = left ? m : *b;
+  *fb = left ? fm : *fb;
+  *a = left ? *a : m;
+  *fa = left ? *fa : fm;
+}
+
+/*
+ * Function   : ridder_point
+ * Author     : Leo Werneck
+ *
+ * Computes Ridder's exponential interpolation point (see roots_ridder.c).
+ *
+ * Parameters : a, m     - End point and midpoint of the bracket.
+ *            : fa, fb, fm - f at the end points and at the midpoint.
+ *
+ * Returns    : The new point, which lies in the bracket.
+ */
+static inline double ridder_point(
+      const double a,
+      const double m,
+      const double fa,
+      const double fb,
+      const double fm) {
+
+  const double s = sqrt(fm * fm - fa * fb);
+  const double d = (m - a) * copysign(1.0, fa - fb) * fm / (s > 0 ? s : 1);
+  return s > 0 ? m + d : m;
+}
+
+/*
+ * Function   : ridder_update
+ * Author     : Leo Werneck
+ *
+ * Branch-free update of Ridder's bracket, given the midpoint m and Ridder's
+ * point x. The new bracket is [m,x], [a,x], or [x,b], and is never wider than
+ * half of the old one.
+ *
+ * Parameters : m, x     - Midpoint and Ridder's point.
+ *            : fm, fx   - f(m) and f(x).
+ *            : a, b     - Bracket (updated).
+ *            : fa, fb   - f(a) and f(b) (updated).
+ *
+ * Returns    : Nothing.
+ */
+static inline void ridder_update(
+      const double m,
+      const double x,
+      const double fm,
+      const double fx,
+      double *restrict a,
+      double *restrict b,
+      double *restrict fa,
+      double *restrict fb) {
+
+  const bool mx = fm * fx <= 0;
+  const bool ax = *fa * fx <= 0;
+  *a = mx ? m : (ax ? *a : x);
+  *fa = mx ? fm : (ax ? *fa : fx);
+  *b = mx | ax ? x : *b;
+  *fb = mx | ax ? fx : *fb;
+}
+
+/*
+ * Function   : chandrupatla_update
+ * Author     : Leo Werneck
+ *
+ * Branch-free step of Chandrupatla's method: given the new point x in the
+ * bracket [a,b], where a is the newest point, updates a, b, and the point c
+ * discarded from the bracket, and computes the relative position t of the
+ * next point, x = a + t(b-a). Inverse quadratic interpolation is used if the
+ * three points are well behaved, and bisection otherwise.
+ *
+ * Parameters : x        - New point.
+ *            : fx       - f(x).
+ *            : tol      - Tolerance.
+ *            : a, b, c  - Points (updated).
+ *            : fa, fb, fc - f at these points (updated).
+ *
+ * Returns    : The relative position t of the next point.
+ *
+ * References : Chandrupatla, Adv. Eng. Software 28, 145 (1997)
+ */
+static inline double chandrupatla_update(
+      const double x,
+      const double fx,
+      const double tol,
+      double *restrict a,
+      double *restrict b,
+      double *restrict c,
+      double *restrict fa,
+      double *restrict fb,
+      double *restrict fc) {
+
+  // Step 1: Update the points
+  const bool same = fx * *fa > 0;
+  *c = same ? *a : *b;
+  *fc = same ? *fa : *fb;
+  *b = same ? *b : *a;
+  *fb = same ? *fb : *fa;
+  *a = x;
+  *fa = fx;
+
+  // Step 2: Inverse quadratic interpolation, if the points allow it
+  const double xi = (*a - *b) / (*c - *b);
+  const double phi = (*fa - *fb) / (*fc - *fb);
+  const bool iqi = (phi * phi < xi) & ((1 - phi) * (1 - phi) < 1 - xi);
+  const double t = *fa / (*fb - *fa) * *fc / (*fb - *fc)
+                   + (*c - *a) / (*b - *a) * *fa / (*fc - *fa) * *fb / (*fc - *fb);
+
+  // Step 3: Keep the new point at least tol away from a and b. Comparisons
+  //         are used instead of fmin and fmax so that loops vectorize.
+  const double d = tol / fabs(*b - *a);
+  const double tl = d < 0.5 ? d : 0.5;
+  const double u = iqi ? t : 0.5;
+  return u < tl ? tl : (u > 1 - tl ? 1 - tl : u);
+}
+
+/*
+ * Function   : fixed_start
+ * Author     : Leo Werneck
+ *
+ * Common set up of the scalar fixed-iteration solvers: computes f at the end
+ * points, checks that they bracket the root, and computes the number of
+ * iterations.
+ *
+ * Parameters : f        - Function for which the root is computed.
+ *            : fparams  - Object containing all parameters needed by the
+ *                         function f other than the variable x.
+ *            : a        - One end of the interval.
+ *            : b        - Other end of the interval.
+ *            : fa, fb   - f(a) and f(b) (output).
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *
+ * Returns    : roots_continue or roots_error_root_not_bracketed.
+ */
+static roots_error_t fixed_start(
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      const double a,
+      const double b,
+      double *restrict fa,
+      double *restrict fb,
+      roots_params *restrict r) {
+
+  r->a = a;
+  r->b = b;
+  start_solve(r);
+  r->n_evals = 0;
+  r->n_iters = roots_fixed_iterations(a, b, r->tol);
+  *fa = evaluate(f, fparams, a, r);
+  *fb = evaluate(f, fparams, b, r);
+  if(*fa * *fb > 0) {
+    return (r->error_key = roots_error_root_not_bracketed);
+  }
+  return roots_continue;
+}
+
+/*
+ * Function   : fixed_finish
+ * Author     : Leo Werneck
+ *
+ * Stores the end point of the final bracket with the smallest |f| as the root.
+ *
+ * Parameters : r        - Pointer to roots library parameters (see roots.h).
+ *            : a, b     - Final bracket.
+ *            : fa, fb   - f(a) and f(b).
+ *
+ * Returns    : roots_success.
+ */
+static inline roots_error_t fixed_finish(
+      roots_params *restrict r,
+      const double a,
+      const double b,
+      const double fa,
+      const double fb) {
+
+  const bool use_a = fabs(fa) < fabs(fb);
+  return set_root(r, roots_success, use_a ? a : b, use_a ? fa : fb, a, b);
+}
+
+/*
+ * Function   : roots_bisection_fixed
+ * Author     : Leo Werneck
+ *
+ * Find the root of f(x) in the interval [a,b] using the bisection method with
+ * a fixed number of iterations and no data-dependent branches. One function
+ * evaluation per iteration.
+ *
+ * Parameters : f        - Function for which the root is computed.
+ *            : fparams  - Object containing all parameters needed by the
+ *                         function f other than the variable x.
+ *            : a        - Lower limit of the initial interval.
+ *            : b        - Upper limit of the initial interval.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         The root is stored in r->root.
+ *
+ * Returns    : One the following error keys:
+ *                 - roots_success if the root is found
+ *                 - roots_error_root_not_bracketed if the interval [a,b]
+ *                   does not bracket a root of f(x)
+ */
+roots_error_t roots_bisection_fixed(
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      double a,
+      double b,
+      roots_params *restrict r) {
+
+  // Step 0: Set basic info to the roots_params struct
+  sprintf(r->method, "Bisection (fixed iterations)");
+
+  // Step 1: Compute fa and fb and the number of iterations
+  double fa, fb;
+  if(fixed_start(f, fparams, a, b, &fa, &fb, r) >= roots_success) {
+    return r->error_key;
+  }
+
+  // Step 2: Bisection algorithm
+  for(unsigned i = 0; i < r->n_iters; i++) {
+    const double m = 0.5 * (a + b);
+    const double fm = evaluate(f, fparams, m, r);
+    bisection_update(m, fm, &a, &b, &fa, &fb);
+  }
+
+  // Step 3: Store the results
+  return fixed_finish(r, a, b, fa, fb);
+}
+
+/*
+ * Function   : roots_ridder_fixed
+ * Author     : Leo Werneck
+ *
+ * Find the root of f(x) in the interval [a,b] using Ridder's method with a
+ * fixed number of iterations and no data-dependent branches. Two function
+ * evaluations per iteration; the final bracket is usually much narrower than
+ * the tolerance.
+ *
+ * Parameters : f        - Function for which the root is computed.
+ *            : fparams  - Object containing all parameters needed by the
+ *                         function f other than the variable x.
+ *            : a        - Lower limit of the initial interval.
+ *            : b        - Upper limit of the initial interval.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         The root is stored in r->root.
+ *
+ * Returns    : One the following error keys:
+ *                 - roots_success if the root is found
+ *                 - roots_error_root_not_bracketed if the interval [a,b]
+ *                   does not bracket a root of f(x)
+ */
+roots_error_t roots_ridder_fixed(
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      double a,
+      double b,
+      roots_params *restrict r) {
+
+  // Step 0: Set basic info to the roots_params struct
+  sprintf(r->method, "Ridder's (fixed iterations)");
+
+  // Step 1: Compute fa and fb and the number of iterations
+  double fa, fb;
+  if(fixed_start(f, fparams, a, b, &fa, &fb, r) >= roots_success) {
+    return r->error_key;
+  }
+
+  // Step 2: Ridder's algorithm
+  for(unsigned i = 0; i < r->n_iters; i++) {
+    const double m = 0.5 * (a + b);
+    const double fm = evaluate(f, fparams, m, r);
+    const double x = ridder_point(a, m, fa, fb, fm);
+    const double fx = evaluate(f, fparams, x, r);
+    ridder_update(m, x, fm, fx, &a, &b, &fa, &fb);
+  }
+
+  // Step 3: Store the results
+  return fixed_finish(r, a, b, fa, fb);
+}
+
+/*
+ * Function   : roots_chandrupatla_fixed
+ * Author     : Leo Werneck
+ *
+ * Find the root of f(x) in the interval [a,b] using Chandrupatla's method
+ * with a fixed number of iterations and no data-dependent branches. Each
+ * iteration is a bisection step followed by a Chandrupatla (inverse
+ * quadratic interpolation) step, so the bracket is at least halved while
+ * converging superlinearly for smooth functions. Two function evaluations
+ * per iteration.
+ *
+ * Parameters : f        - Function for which the root is computed.
+ *            : fparams  - Object containing all parameters needed by the
+ *                         function f other than the variable x.
+ *            : a        - Lower limit of the initial interval.
+ *            : b        - Upper limit of the initial interval.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         The root is stored in r->root.
+ *
+ * Returns    : One the following error keys:
+ *                 - roots_success if the root is found
+ *                 - roots_error_root_not_bracketed if the interval [a,b]
+ *                   does not bracket a root of f(x)
+ *
+ * References : Chandrupatla, Adv. Eng. Software 28, 145 (1997)
+ */
+roots_error_t roots_chandrupatla_fixed(
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      double a,
+      double b,
+      roots_params *restrict r) {
+
+  // Step 0: Set basic info to the roots_params struct
+  sprintf(r->method, "Chandrupatla's (fixed iterations)");
+
+  // Step 1: Compute fa and fb and the number of iterations
+  double fa, fb;
+  if(fixed_start(f, fparams, a, b, &fa, &fb, r) >= roots_success) {
+    return r->error_key;
+  }
+
+  // Step 2: Chandrupatla's algorithm
+  const double tol = 0.5 * r->tol;
+  double c = a, fc = fa;
+  for(unsigned i = 0; i < r->n_iters; i++) {
+    const double m = 0.5 * (a + b);
+    const double fm = evaluate(f, fparams, m, r);
+    const double t = chandrupatla_update(m, fm, tol, &a, &b, &c, &fa, &fb, &fc);
+    const double x = a + t * (b - a);
+    const double fx = evaluate(f, fparams, x, r);
+    chandrupatla_update(x, fx, tol, &a, &b, &c, &fa, &fb, &fc);
+  }
+
+  // Step 3: Store the results
+  return fixed_finish(r, a, b, fa, fb);
+}
+
+/*
+ * Function   : batch_start
+ * Author     : Leo Werneck
+ *
+ * Common set up of the batch solvers: copies the intervals, evaluates f at
+ * their end points, and computes the number of iterations, which is the same
+ * for all problems.
+ *
+ * Parameters : fv       - Vectorized function.
+ *            : fparams  - Parameters of fv.
+ *            : n        - Number of problems.
+ *            : a0, b0   - Initial intervals.
+ *            : a, b     - Copies of the initial intervals (output).
+ *            : fa, fb   - f at the end points of the intervals (output).
+ *            : ok       - Whether the intervals bracket a root (output).
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *
+ * Returns    : roots_success if all intervals bracket a root, and
+ *              roots_error_root_not_bracketed otherwise.
+ */
+static roots_error_t batch_start(
+      roots_vector_function fv,
+      void *restrict fparams,
+      const unsigned n,
+      const double *restrict a0,
+      const double *restrict b0,
+      double *restrict a,
+      double *restrict b,
+      double *restrict fa,
+      double *restrict fb,
+      bool *restrict ok,
+      roots_params *restrict r) {
+
+  start_solve(r);
+  r->n_evals = 2;
+  r->error_key = roots_success;
+  for(unsigned i = 0; i < n; i++) {
+    a[i] = a0[i];
+    b[i] = b0[i];
+    const unsigned k = roots_fixed_iterations(a[i], b[i], r->tol);
+    r->n_iters = k > r->n_iters ? k : r->n_iters;
+  }
+  fv(n, a, fparams, fa);
+  fv(n, b, fparams, fb);
+  for(unsigned i = 0; i < n; i++) {
+    ok[i] = fa[i] * fb[i] <= 0;
+    if(!ok[i]) {
+      r->error_key = roots_error_root_not_bracketed;
+    }
+  }
+  return r->error_key;
+}
+
+/*
+ * Function   : batch_alloc_failed
+ * Author     : Leo Werneck
+ *
+ * Frees the buffers of a batch solver of which at least one could not be
+ * allocated, and reports the failure. Callers check n first, since malloc
+ * may return NULL for n = 0.
+ *
+ * Parameters : buf      - Buffer of the brackets (may be NULL).
+ *            : ok       - Buffer of the flags (may be NULL).
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *
+ * Returns    : roots_error_alloc.
+ */
+static roots_error_t batch_alloc_failed(void *buf, void *ok, roots_params *restrict r) {
+
+  free(ok);
+  free(buf);
+  start_solve(r);
+  r->n_evals = 0;
+  return (r->error_key = roots_error_alloc);
+}
+
+/*
+ * Function   : batch_finish
+ * Author     : Leo Werneck
+ *
+ * Stores the end point of each final bracket with the smallest |f| as the
+ * root. Problems whose initial interval did not bracket a root get NAN.
+ *
+ * Parameters : n        - Number of problems.
+ *            : a, b     - Final brackets.
+ *            : fa, fb   - f at the end points of the brackets.
+ *            : ok       - Whether the initial intervals bracket a root.
+ *            : root     - Roots (output).
+ *
+ * Returns    : Nothing.
+ */
+static void batch_finish(
+      const unsigned n,
+      const double *restrict a,
+      const double *restrict b,
+      const double *restrict fa,
+      const double *restrict fb,
+      const bool *restrict ok,
+      double *restrict root) {
+
+  for(unsigned i = 0; i < n; i++) {
+    const double x = fabs(fa[i]) < fabs(fb[i]) ? a[i] : b[i];
+    root[i] = ok[i] ? x : NAN;
+  }
+}
+
+/*
+ * Function   : midpoints
+ * Author     : Leo Werneck
+ *
+ * Computes the midpoints of n brackets.
+ *
+ * Parameters : n        - Number of problems.
+ *            : a, b     - Brackets.
+ *            : m        - Midpoints (output).
+ *
+ * Returns    : Nothing.
+ */
+KERNEL void midpoints_kernel(
+      const unsigned n,
+      const double *restrict a,
+      const double *restrict b,
+      double *restrict m) {
+
+  for(unsigned i = 0; i < n; i++) {
+    m[i] = 0.5 * (a[i] + b[i]);
+  }
+}
+
+DISPATCH_KERNEL(midpoints,
+                (const unsigned n,
+                 const double *restrict a,
+                 const double *restrict b,
+                 double *restrict m),
+                (n, a, b, m));
+
+/*
+ * Function   : bisection_batch_update
+ * Author     : Leo Werneck
+ *
+ * Applies bisection_update to n brackets. The arrays must not overlap, which
+ * lets compilers vectorize the loop.
+ *
+ * Parameters : See bisection_update; all are arrays of length n.
+ *
+ * Returns    : Nothing.
+ */
+KERNEL void bisection_batch_update_kernel(
+      const unsigned n,
+      const double *restrict m,
+      const double *restrict fm,
+      double *restrict a,
+      double *restrict b,
+      double *restrict fa,
+      double *restrict fb) {
+
+  for(unsigned i = 0; i < n; i++) {
+    double ai = a[i], bi = b[i], fai = fa[i], fbi = fb[i];
+    bisection_update(m[i], fm[i], &ai, &bi, &fai, &fbi);
+    a[i] = ai;
+    b[i] = bi;
+    fa[i] = fai;
+    fb[i] = fbi;
+  }
+}
+
+DISPATCH_KERNEL(bisection_batch_update,
+                (const unsigned n,
+                 const double *restrict m,
+                 const double *restrict fm,
+                 double *restrict a,
+                 double *restrict b,
+                 double *restrict fa,
+                 double *restrict fb),
+                (n, m, fm, a, b, fa, fb));
+
+/*
+ * Function   : ridder_batch_update
+ * Author     : Leo Werneck
+ *
+ * Applies ridder_update to n brackets. The arrays must not overlap.
+ *
+ * Parameters : See ridder_update; all are arrays of length n.
+ *
+ * Returns    : Nothing.
+ */
+KERNEL void ridder_batch_update_kernel(
+      const unsigned n,
+      const double *restrict m,
+      const double *restrict x,
+      const double *restrict fm,
+      const double *restrict fx,
+      double *restrict a,
+      double *restrict b,
+      double *restrict fa,
+      double *restrict fb) {
+
+  for(unsigned i = 0; i < n; i++) {
+    double ai = a[i], bi = b[i], fai = fa[i], fbi = fb[i];
+    ridder_update(m[i], x[i], fm[i], fx[i], &ai, &bi, &fai, &fbi);
+    a[i] = ai;
+    b[i] = bi;
+    fa[i] = fai;
+    fb[i] = fbi;
+  }
+}
+
+DISPATCH_KERNEL(ridder_batch_update,
+                (const unsigned n,
+                 const double *restrict m,
+                 const double *restrict x,
+                 const double *restrict fm,
+                 const double *restrict fx,
+                 double *restrict a,
+                 double *restrict b,
+                 double *restrict fa,
+                 double *restrict fb),
+                (n, m, x, fm, fx, a, b, fa, fb));
+
+/*
+ * Function   : chandrupatla_batch_update
+ * Author     : Leo Werneck
+ *
+ * Applies chandrupatla_update to n brackets and overwrites x with the next
+ * points. The arrays must not overlap.
+ *
+ * Parameters : See chandrupatla_update; all but tol are arrays of length n.
+ *
+ * Returns    : Nothing.
+ */
+KERNEL void chandrupatla_batch_update_kernel(
+      const unsigned n,
+      double *restrict x,
+      const double *restrict fx,
+      const double tol,
+      double *restrict a,
+      double *restrict b,
+      double *restrict c,
+      double *restrict fa,
+      double *restrict fb,
+      double *restrict fc) {
+
+  for(unsigned i = 0; i < n; i++) {
+    double ai = a[i], bi = b[i], ci = c[i], fai = fa[i], fbi = fb[i], fci = fc[i];
+    const double t
+          = chandrupatla_update(x[i], fx[i], tol, &ai, &bi, &ci, &fai, &fbi, &fci);
+    a[i] = ai;
+    b[i] = bi;
+    c[i] = ci;
+    fa[i] = fai;
+    fb[i] = fbi;
+    fc[i] = fci;
+    x[i] = ai + t * (bi - ai);
+  }
+}
+
+DISPATCH_KERNEL(chandrupatla_batch_update,
+                (const unsigned n,
+                 double *restrict x,
+                 const double *restrict fx,
+                 const double tol,
+                 double *restrict a,
+                 double *restrict b,
+                 double *restrict c,
+                 double *restrict fa,
+                 double *restrict fb,
+                 double *restrict fc),
+                (n, x, fx, tol, a, b, c, fa, fb, fc));
+
+/*
+ * Function   : roots_bisection_batch
+ * Author     : Leo Werneck
+ *
+ * Solves n independent problems with the fixed-iteration bisection method
+ * (see roots_bisection_fixed).
+ *
+ * Parameters : fv       - Vectorized function (see roots_vector_function).
+ *            : fparams  - Object containing all parameters needed by fv
+ *                         other than the points x.
+ *            : n        - Number of problems.
+ *            : a        - Lower limits of the initial intervals.
+ *            : b        - Upper limits of the initial intervals.
+ *            : root     - Roots (output); NAN for intervals that do not
+ *                         bracket a root.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         r->n_iters and r->n_evals count the iterations and
+ *                         the calls to fv. Each call evaluates every problem
+ *                         once, so r->n_evals is also the number of
+ *                         evaluations of each problem, which is fixed by the
+ *                         intervals and the tolerance.
+ *
+ * Returns    : roots_success if all intervals bracket a root,
+ *              roots_error_root_not_bracketed otherwise, and
+ *              roots_error_alloc if memory cannot be allocated.
+ */
+roots_error_t roots_bisection_batch(
+      roots_vector_function fv,
+      void *restrict fparams,
+      const unsigned n,
+      const double *restrict a,
+      const double *restrict b,
+      double *restrict root,
+      roots_params *restrict r) {
+
+  // Step 0: Set basic info to the roots_params struct
+  sprintf(r->method, "Bisection (batch)");
+
+  // Step 1: Allocate memory; compute fa and fb and the number of iterations
+  double *buf = malloc(sizeof(double) * 6 * n);
+  bool *ok = malloc(sizeof(bool) * n);
+  if(n && (!buf || !ok)) {
+    return batch_alloc_failed(buf, ok, r);
+  }
+  double *xa = buf, *xb = buf + n, *fa = buf + 2 * n, *fb = buf + 3 * n;
+  double *m = buf + 4 * n, *fm = buf + 5 * n;
+  batch_start(fv, fparams, n, a, b, xa, xb, fa, fb, ok, r);
+
+  // Step 2: Bisection algorithm
+  for(unsigned k = 0; k < r->n_iters; k++) {
+    DISPATCH(midpoints)(n, xa, xb, m);
+    fv(n, m, fparams, fm);
+    DISPATCH(bisection_batch_update)(n, m, fm, xa, xb, fa, fb);
+  }
+  r->n_evals += r->n_iters;
+
+  // Step 3: Store the results and free memory
+  batch_finish(n, xa, xb, fa, fb, ok, root);
+  free(ok);
+  free(buf);
+  return r->error_key;
+}
+
+/*
+ * Function   : roots_ridder_batch
+ * Author     : Leo Werneck
+ *
+ * Solves n independent problems with the fixed-iteration Ridder's method
+ * (see roots_ridder_fixed).
+ *
+ * Parameters : See roots_bisection_batch.
+ *
+ * Returns    : See roots_bisection_batch.
+ */
+roots_error_t roots_ridder_batch(
+      roots_vector_function fv,
+      void *restrict fparams,
+      const unsigned n,
+      const double *restrict a,
+      const double *restrict b,
+      double *restrict root,
+      roots_params *restrict r) {
+
+  // Step 0: Set basic info to the roots_params struct
+  sprintf(r->method, "Ridder's (batch)");
+
+  // Step 1: Allocate memory; compute fa and fb and the number of iterations
+  double *buf = malloc(sizeof(double) * 8 * n);
+  bool *ok = malloc(sizeof(bool) * n);
+  if(n && (!buf || !ok)) {
+    return batch_alloc_failed(buf, ok, r);
+  }
+  double *xa = buf, *xb = buf + n, *fa = buf + 2 * n, *fb = buf + 3 * n;
+  double *m = buf + 4 * n, *fm = buf + 5 * n, *x = buf + 6 * n, *fx = buf + 7 * n;
+  batch_start(fv, fparams, n, a, b, xa, xb, fa, fb, ok, r);
+
+  // Step 2: Ridder's algorithm
+  for(unsigned k = 0; k < r->n_iters; k++) {
+    DISPATCH(midpoints)(n, xa, xb, m);
+    fv(n, m, fparams, fm);
+    for(unsigned i = 0; i < n; i++) {
+      x[i] = ridder_point(xa[i], m[i], fa[i], fb[i], fm[i]);
+    }
+    fv(n, x, fparams, fx);
+    DISPATCH(ridder_batch_update)(n, m, x, fm, fx, xa, xb, fa, fb);
+  }
+  r->n_evals += 2 * r->n_iters;
+
+  // Step 3: Store the results and free memory
+  batch_finish(n, xa, xb, fa, fb, ok, root);
+  free(ok);
+  free(buf);
+  return r->error_key;
+}
+
+/*
+ * Function   : roots_chandrupatla_batch
+ * Author     : Leo Werneck
+ *
+ * Solves n independent problems with the fixed-iteration Chandrupatla's
+ * method (see roots_chandrupatla_fixed).
+ *
+ * Parameters : See roots_bisection_batch.
+ *
+ * Returns    : See roots_bisection_batch.
+ */
+roots_error_t roots_chandrupatla_batch(
+      roots_vector_function fv,
+      void *restrict fparams,
+      const unsigned n,
+      const double *restrict a,
+      const double *restrict b,
+      double *restrict root,
+      roots_params *restrict r) {
+
+  // Step 0: Set basic info to the roots_params struct
+  sprintf(r->method, "Chandrupatla's (batch)");
+
+  // Step 1: Allocate memory; compute fa and fb and the number of iterations
+  double *buf = malloc(sizeof(double) * 8 * n);
+  bool *ok = malloc(sizeof(bool) * n);
+  if(n && (!buf || !ok)) {
+    return batch_alloc_failed(buf, ok, r);
+  }
+  double *xa = buf, *xb = buf + n, *fa = buf + 2 * n, *fb = buf + 3 * n;
+  double *xc = buf + 4 * n, *fc = buf + 5 * n, *x = buf + 6 * n, *fx = buf + 7 * n;
+  batch_start(fv, fparams, n, a, b, xa, xb, fa, fb, ok, r);
+  for(unsigned i = 0; i < n; i++) {
+    xc[i] = xa[i];
+    fc[i] = fa[i];
+  }
+
+  // Step 2: Chandrupatla's algorithm. The first update of each iteration
+  //         computes the interpolation points; the second one discards them,
+  //         as the next points are always the midpoints.
+  const double tol = 0.5 * r->tol;
+  for(unsigned k = 0; k < r->n_iters; k++) {
+    DISPATCH(midpoints)(n, xa, xb, x);
+    fv(n, x, fparams, fx);
+    DISPATCH(chandrupatla_batch_update)(n, x, fx, tol, xa, xb, xc, fa, fb, fc);
+    fv(n, x, fparams, fx);
+    DISPATCH(chandrupatla_batch_update)(n, x, fx, tol, xa, xb, xc, fa, fb, fc);
+  }
+  r->n_evals += 2 * r->n_iters;
+
+  // Step 3: Store the results and free memory
+  batch_finish(n, xa, xb, fa, fb, ok, root);
+  free(ok);
+  free(buf);
+  return r->error_key;
+}
@@ -0,0 +1,329 @@
+#include <float.h>
+#include <string.h>
+
+#include "roots.h"
+#include "utils.h"
+
+/*
+ * Function   : max_norm
+ * Author     : Leo Werneck
+ *
+ * Computes the maximum norm of a vector.
+ *
+ * Parameters : n        - Length of the vector.
+ *            : v        - Vector.
+ *
+ * Returns    : max_i |v[i]|.
+ */
+static inline double max_norm(const unsigned n, const double *restrict v) {
+  double norm = 0;
+  for(unsigned i = 0; i < n; i++) {
+    norm = fmax(norm, fabs(v[i]));
+  }
+  return norm;
+}
+
+/*
+ * Function   : anderson_coefficients
+ * Author     : Leo Werneck
+ *
+ * Solves the least-squares problem min ||f - dF gamma||_2 of Anderson
+ * acceleration with a QR factorization of dF (modified Gram-Schmidt). The
+ * columns are processed from the newest to the oldest, and a column that is
+ * (nearly) a linear combination of the newer ones is dropped, i.e., its
+ * coefficient is set to zero. This keeps the problem well conditioned, e.g.,
+ * only the newest column is used for a scalar equation.
+ *
+ * Parameters : n        - Number of unknowns.
+ *            : m        - Number of columns of dF.
+ *            : newest   - Index of the newest column; older columns precede
+ *                         it cyclically.
+ *            : dF       - Differences of residuals, column j at dF + j n.
+ *            : f        - Current residual.
+ *            : Q        - Workspace of size n m.
+ *            : R        - Workspace of size m m.
+ *            : gamma    - Coefficients (output).
+ *
+ * Returns    : Nothing.
+ */
+static void anderson_coefficients(
+      const unsigned n,
+      const unsigned m,
+      const unsigned newest,
+      const double *restrict dF,
+      const double *restrict f,
+      double *restrict Q,
+      double *restrict R,
+      double *restrict gamma) {
+
+  // Step 1: Orthogonalize the columns, from the newest to the oldest; col[k]
+  //         is the column of dF that gave the k-th column of Q
+  unsigned col[m];
+  unsigned p = 0;
+  for(unsigned j = 0; j < m; j++) {
+    const unsigned c = (newest + m - j) % m;
+    double *q = Q + p * n;
+    memcpy(q, dF + c * n, sizeof(double) * n);
+    double norm0 = 0;
+    for(unsigned i = 0; i < n; i++) {
+      norm0 += q[i] * q[i];
+    }
+    for(unsigned k = 0; k < p; k++) {
+      double dot = 0;
+      for(unsigned i = 0; i < n; i++) {
+        dot += Q[k * n + i] * q[i];
+      }
+      R[k * m + p] = dot;
+      for(unsigned i = 0; i < n; i++) {
+        q[i] -= dot * Q[k * n + i];
+      }
+    }
+    double norm = 0;
+    for(unsigned i = 0; i < n; i++) {
+      norm += q[i] * q[i];
+    }
+    gamma[c] = 0;
+    if(!(norm > 1e-20 * norm0)) {
+      continue;
+    }
+    norm = sqrt(norm);
+    for(unsigned i = 0; i < n; i++) {
+      q[i] /= norm;
+    }
+    R[p * m + p] = norm;
+    col[p++] = c;
+  }
+
+  // Step 2: Solve R gamma = Q^T f by back substitution
+  double y[m];
+  for(unsigned k = 0; k < p; k++) {
+    double dot = 0;
+    for(unsigned i = 0; i < n; i++) {
+      dot += Q[k * n + i] * f[i];
+    }
+    y[k] = dot;
+  }
+  for(unsigned k = p; k-- > 0;) {
+    double s = y[k];
+    for(unsigned l = k + 1; l < p; l++) {
+      s -= R[k * m + l] * y[l];
+    }
+    y[k] = s / R[k * m + k];
+    gamma[col[k]] = y[k];
+  }
+}
+
+/*
+ * Function   : roots_fixed_point
+ * Author     : Leo Werneck
+ *
+ * Find a fixed point x = g(x) of a map of n unknowns using Anderson
+ * acceleration.
+ *
+ * Plain (Picard) iteration, x <- x + beta (g(x) - x), converges only
+ * linearly, and slowly if g is nearly neutral at the fixed point. Anderson
+ * acceleration keeps the last depth differences of the residuals
+ * f = g(x) - x and of g, and takes the combination of the recent iterates
+ * that minimizes the linearized residual. For a scalar equation and depth 1
+ * this is the secant method applied to g(x) - x. The history is discarded,
+ * and a plain damped step is taken, whenever the residual grows; depth = 0
+ * gives the plain damped iteration.
+ *
+ * Convergence is declared when max_i |g_i(x) - x_i| < 4 eps max_i |x_i| + tol,
+ * i.e., when the next step is smaller than the tolerance, as for the other
+ * methods. Every iteration evaluates g once.
+ *
+ * Parameters : g        - Map whose fixed point is computed.
+ *            : gparams  - Object containing all parameters needed by the
+ *                         map g other than the vector x.
+ *            : n        - Number of unknowns.
+ *            : depth    - Number of previous iterates used by Anderson
+ *                         acceleration (typically 1 to 10).
+ *            : damping  - Damping (mixing) parameter beta in (0,1]; 1 means
+ *                         no damping.
+ *            : x        - Initial guess on input, fixed point (or best
+ *                         approximation to it) on output.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         r->root and r->residual hold x[0] and the maximum
+ *                         norm of g(x) - x.
+ *
+ * Returns    : One the following error keys:
+ *                 - roots_success if the fixed point is found
+ *                 - roots_error_max_iter if the maximum allowed number of
+ *                   iterations is exceeded
+ *                 - roots_error_max_evals if the maximum allowed number of
+ *                   evaluations of g is exceeded
+ *                 - roots_error_deadline if the deadline has passed
+ *                 - roots_error_alloc if memory cannot be allocated
+ *
+ * References : Anderson, J. Assoc. Comput. Mach. 12, 547 (1965)
+ *              Walker & Ni, SIAM J. Numer. Anal. 49, 1715 (2011)
+ */
+roots_error_t roots_fixed_point(
+      roots_map g,
+      void *restrict gparams,
+      const unsigned n,
+      const unsigned depth,
+      const double damping,
+      double *restrict x,
+      roots_params *restrict r) {
+
+  // Step 0: Set basic info to the roots_params struct
+  if(depth) {
+    sprintf(r->method, "Anderson (depth %u)", depth);
+  }
+  else {
+    sprintf(r->method, "Fixed-point iteration");
+  }
+  r->a = r->b = x[0];
+  start_solve(r);
+  r->n_evals = 0;
+
+  // Step 1: Allocate memory. The differences of f and g are stored in ring
+  //         buffers of depth columns.
+  const unsigned m = depth ? depth : 1;
+  double *buf = malloc(sizeof(double) * (5 * n + 3 * n * m + m * m + m));
+  if(!buf) {
+    return (r->error_key = roots_error_alloc);
+  }
+  double *gx = buf, *f = buf + n, *f_old = buf + 2 * n, *g_old = buf + 3 * n;
+  double *x_best = buf + 4 * n, *dF = buf + 5 * n, *dG = dF + n * m;
+  double *Q = dG + n * m, *R = Q + n * m, *gamma = R + m * m;
+
+  // Step 2: Compute g at the initial guess
+  g(n, x, gparams, gx);
+  r->n_evals++;
+  for(unsigned i = 0; i < n; i++) {
+    f[i] = gx[i] - x[i];
+  }
+  double norm = max_norm(n, f);
+  double best = norm;
+  memcpy(x_best, x, sizeof(double) * n);
+
+  // Step 3: Anderson's algorithm; n_cols columns of the history are filled,
+  //         the newest at index newest.
+  unsigned n_cols = 0, newest = 0;
+  r->error_key = roots_error_max_iter;
+  for(r->n_iters = 1; r->n_iters <= r->max_iters; r->n_iters++) {
+
+    // Step 3.a: Check for convergence
+    if(norm < 4 * DBL_EPSILON * max_norm(n, x) + r->tol) {
+      r->error_key = roots_success;
+      break;
+    }
+
+    // Step 3.b: Compute the next iterate; without history, this is the
+    //           plain damped iteration.
+    for(unsigned i = 0; i < n; i++) {
+      f_old[i] = f[i];
+      g_old[i] = gx[i];
+      x[i] += damping * f[i];
+    }
+    if(n_cols) {
+      anderson_coefficients(n, n_cols, newest, dF, f, Q, R, gamma);
+      for(unsigned j = 0; j < n_cols; j++) {
+        const double *df = dF + j * n, *dg = dG + j * n;
+        for(unsigned i = 0; i < n; i++) {
+          x[i] -= gamma[j] * ((dg[i] - df[i]) + damping * df[i]);
+        }
+      }
+    }
+
+    // Step 3.c: Check the budget; compute g at the new point
+    if(r->max_evals && r->n_evals >= r->max_evals) {
+      r->error_key = roots_error_max_evals;
+      break;
+    }
+    if(r->deadline > 0 && roots_monotonic_time() >= r->deadline) {
+      r->error_key = roots_error_deadline;
+      break;
+    }
+    g(n, x, gparams, gx);
+    r->n_evals++;
+    for(unsigned i = 0; i < n; i++) {
+      f[i] = gx[i] - x[i];
+    }
+    const double norm_old = norm;
+    norm = max_norm(n, f);
+    if(norm < best) {
+      best = norm;
+      memcpy(x_best, x, sizeof(double) * n);
+    }
+
+    // Step 3.d: Update the history, or discard it if the residual grew
+    if(!depth) {
+      continue;
+    }
+    if(!(norm < norm_old)) {
+      n_cols = 0;
+      continue;
+    }
+    newest = n_cols < depth ? n_cols : (newest + 1) % depth;
+    n_cols += n_cols < depth;
+    for(unsigned i = 0; i < n; i++) {
+      dF[newest * n + i] = f[i] - f_old[i];
+      dG[newest * n + i] = gx[i] - g_old[i];
+    }
+  }
+
+  // Step 4: Return the fixed point; if the method stopped early, return the
+  //         best approximation found
+  if(r->error_key != roots_success) {
+    memcpy(x, x_best, sizeof(double) * n);
+    norm = best;
+    if(r->n_iters > r->max_iters) {
+      r->n_iters = r->max_iters;
+    }
+  }
+  r->root = r->bracket_a = r->bracket_b = x[0];
+  r->residual = norm;
+  r->dfdx = NAN;
+  free(buf);
+  return r->error_key;
+}
+
+// Lets roots_fixed_point solve a scalar equation
+typedef struct {
+  double (*g)(const double, void *restrict);
+  void *gparams;
+} scalar_params;
+
+static void scalar_map(
+      const unsigned n,
+      const double *restrict x,
+      void *restrict params,
+      double *restrict gx) {
+  (void)n;
+  const scalar_params *p = (const scalar_params *)params;
+  gx[0] = p->g(x[0], p->gparams);
+}
+
+/*
+ * Function   : roots_fixed_point_scalar
+ * Author     : Leo Werneck
+ *
+ * Find a fixed point x = g(x) of a function of one variable using Anderson
+ * acceleration (see roots_fixed_point).
+ *
+ * Parameters : g        - Function whose fixed point is computed.
+ *            : gparams  - Object containing all parameters needed by the
+ *                         function g other than the variable x.
+ *            : x        - Initial guess.
+ *            : depth    - See roots_fixed_point.
+ *            : damping  - See roots_fixed_point.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         The fixed point is stored in r->root.
+ *
+ * Returns    : See roots_fixed_point.
+ */
+roots_error_t roots_fixed_point_scalar(
+      double g(const double, void *restrict),
+      void *restrict gparams,
+      double x,
+      const unsigned depth,
+      const double damping,
+      roots_params *restrict r) {
+
+  scalar_params p = { g, gparams };
+  return roots_fixed_point(scalar_map, &p, 1, depth, damping, &x, r);
+}
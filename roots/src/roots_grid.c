@@ -0,0 +1,297 @@
+#include <float.h>
+#include <stddef.h>
+
+#include "roots.h"
+
+// Cells are solved in tiles of up to TILE cells in each direction, and the
+// tiles are split into at most MAX_TASKS tasks of consecutive tiles
+#define TILE 8
+#define MAX_TASKS 64
+
+typedef struct {
+  roots_method method;
+  double (*f)(const double, void *restrict);
+  char *params;
+  size_t stride;
+  unsigned n[3], n_tiles[3], n_tasks;
+  const double *a, *b;
+  double *root;
+  roots_params tmpl;
+  struct {
+    unsigned long n_iters, n_evals, n_seeds, n_evals_seeds, n_narrow, n_fallback;
+    roots_error_t key;
+  } *results;
+} grid_batch;
+
+/*
+ * Function   : outward
+ * Author     : Leo Werneck
+ *
+ * Orders the coordinates lo, ..., hi-1 outward from s: s, s+1, ..., hi-1,
+ * then s-1, ..., lo.
+ *
+ * Parameters : t        - Position in the order, from 0 to hi-lo-1.
+ *            : s        - Starting coordinate.
+ *            : hi       - One past the last coordinate.
+ *
+ * Returns    : The t-th coordinate.
+ */
+static inline unsigned outward(const unsigned t, const unsigned s, const unsigned hi) {
+  return s + t < hi ? s + t : s - 1 - (t - (hi - s));
+}
+
+/*
+ * Function   : grid_task
+ * Author     : Leo Werneck
+ *
+ * Solves the tiles of one task of roots_solve_grid. In every tile, the cell
+ * at its center (the seed) is solved with its full interval, and the other
+ * cells are visited outward from the seed, so that the neighbor of a cell
+ * towards the seed is always solved before the cell: along z first, then y,
+ * then x. The root of a cell is predicted by extrapolating the roots of the
+ * two cells before it on that line, and the method is applied to a narrow
+ * interval around the prediction, whose half-width is the difference of the
+ * two roots. Next to the seed, where only one cell precedes it on the line,
+ * the root of that cell is the prediction, and the half-width is twice the
+ * largest difference between the roots of neighbors in that direction seen
+ * so far in the tile (1/64 of the full interval at first). If the narrow
+ * interval does not bracket a root, the full interval is used. Run by the
+ * thread pool.
+ *
+ * Parameters : t        - Task index.
+ *            : arg      - Pointer to a grid_batch struct.
+ *
+ * Returns    : Nothing.
+ */
+static void grid_task(const unsigned t, void *restrict arg) {
+
+  grid_batch *ctx = (grid_batch *)arg;
+  const unsigned nx = ctx->n[0], ny = ctx->n[1];
+  const unsigned total = ctx->n_tiles[0] * ctx->n_tiles[1] * ctx->n_tiles[2];
+  const unsigned slice = (total + ctx->n_tasks - 1) / ctx->n_tasks;
+  const unsigned t0 = t * slice < total ? t * slice : total;
+  const unsigned t1 = t0 + slice < total ? t0 + slice : total;
+  const size_t step[3] = { 1, nx, (size_t)nx * ny };
+  roots_params r = ctx->tmpl;
+  unsigned long n_iters = 0, n_evals = 0, n_seeds = 0, n_evals_seeds = 0, n_narrow = 0;
+  unsigned long n_fallback = 0;
+  roots_error_t key = roots_success;
+  for(unsigned tile = t0; tile < t1; tile++) {
+
+    // Step 1: Find the cells and the seed of the tile
+    const unsigned *nt = ctx->n_tiles;
+    const unsigned c[3] = { tile % nt[0], tile / nt[0] % nt[1], tile / nt[0] / nt[1] };
+    unsigned lo[3], hi[3], s[3];
+    for(int d = 0; d < 3; d++) {
+      lo[d] = c[d] * TILE;
+      hi[d] = lo[d] + TILE < ctx->n[d] ? lo[d] + TILE : ctx->n[d];
+      s[d] = (lo[d] + hi[d]) / 2;
+    }
+
+    // Step 2: Visit the cells outward from the seed. scale[d] is the largest
+    //         difference between the roots of neighbors in direction d seen
+    //         in the tile.
+    double scale[3] = { 0, 0, 0 };
+    for(unsigned tk = 0; tk < hi[2] - lo[2]; tk++) {
+      const unsigned k = outward(tk, s[2], hi[2]);
+      for(unsigned tj = 0; tj < hi[1] - lo[1]; tj++) {
+        const unsigned j = outward(tj, s[1], hi[1]);
+        for(unsigned ti = 0; ti < hi[0] - lo[0]; ti++) {
+          const unsigned i = outward(ti, s[0], hi[0]);
+          const unsigned q[3] = { i, j, k };
+          const size_t idx = i + step[1] * j + step[2] * k;
+          void *params = ctx->params + idx * ctx->stride;
+          const double a = ctx->a[idx], b = ctx->b[idx];
+
+          // Step 2.a: Find the line towards the seed; the seed itself is
+          //           solved with its full interval
+          int d = 2;
+          while(d >= 0 && q[d] == s[d]) {
+            d--;
+          }
+          if(d < 0) {
+            const roots_error_t k_seed = ctx->method(ctx->f, params, a, b, &r);
+            ctx->root[idx] = k_seed == roots_error_root_not_bracketed ? NAN : r.root;
+            n_iters += r.n_iters;
+            n_evals += r.n_evals;
+            n_seeds++;
+            n_evals_seeds += r.n_evals;
+            if(key == roots_success) {
+              key = k_seed;
+            }
+            continue;
+          }
+
+          // Step 2.b: Predict the root from the previous cells on the line
+          const ptrdiff_t dp = q[d] > s[d] ? -(ptrdiff_t)step[d] : (ptrdiff_t)step[d];
+          const bool has_x2 = q[d] > s[d] ? q[d] - 1 > s[d] : q[d] + 1 < s[d];
+          const double x1 = ctx->root[idx + dp];
+          const double x2 = has_x2 ? ctx->root[idx + 2 * dp] : NAN;
+          double x = x1, delta = scale[d] > 0 ? 2 * scale[d] : (b - a) / 64;
+          if(isfinite(x2)) {
+            x = 2 * x1 - x2;
+            delta = fabs(x1 - x2);
+          }
+          delta = fmax(delta, 32 * (DBL_EPSILON * fabs(x) + r.tol));
+
+          // Step 2.c: Solve with the narrow interval, or the full one if it
+          //           does not bracket a root
+          roots_error_t k_cell = roots_error_root_not_bracketed;
+          const double a1 = fmax(a, x - delta), b1 = fmin(b, x + delta);
+          if(isfinite(x1) && a1 < b1) {
+            k_cell = ctx->method(ctx->f, params, a1, b1, &r);
+            n_iters += r.n_iters;
+            n_evals += r.n_evals;
+          }
+          if(k_cell == roots_error_root_not_bracketed) {
+            k_cell = ctx->method(ctx->f, params, a, b, &r);
+            n_iters += r.n_iters;
+            n_evals += r.n_evals;
+            n_fallback++;
+          }
+          else {
+            n_narrow++;
+          }
+          ctx->root[idx] = k_cell == roots_error_root_not_bracketed ? NAN : r.root;
+          if(isfinite(ctx->root[idx] - x1)) {
+            scale[d] = fmax(scale[d], fabs(ctx->root[idx] - x1));
+          }
+          if(key == roots_success) {
+            key = k_cell;
+          }
+        }
+      }
+    }
+  }
+  ctx->results[t].n_iters = n_iters;
+  ctx->results[t].n_evals = n_evals;
+  ctx->results[t].n_seeds = n_seeds;
+  ctx->results[t].n_evals_seeds = n_evals_seeds;
+  ctx->results[t].n_narrow = n_narrow;
+  ctx->results[t].n_fallback = n_fallback;
+  ctx->results[t].key = key;
+}
+
+/*
+ * Function   : roots_solve_grid
+ * Author     : Leo Werneck
+ *
+ * Solves the problems f(x; p_c) = 0, x in [a_c,b_c], of the cells c of a
+ * structured grid of nx * ny * nz cells, stored with x varying fastest, i.e.,
+ * cell (i,j,k) is c = i + nx (j + ny k).
+ *
+ * The roots of neighboring cells are usually close, so most cells are solved
+ * with a narrow interval predicted from their neighbors instead of their full
+ * interval. The grid is split into tiles of up to 8 cells in each direction;
+ * the cell at the center of every tile (a seed) is solved with its full
+ * interval, and the tile is swept outward from it, each cell using the roots
+ * of the cells solved before it (see grid_task). Cells fall back to their
+ * full interval when the narrow one does not bracket a root, so if f has a
+ * single root in every full interval, the roots are those of independent
+ * solves up to the tolerance. The tiles are independent and are split, in
+ * order, among the threads of the pool.
+ *
+ * Parameters : method   - Root-finding method, e.g., roots_brent.
+ *            : f        - Function for which the roots are computed.
+ *            : params   - Parameters of the cells; those of cell c start
+ *                         stride * c bytes after params.
+ *            : stride   - Distance, in bytes, between the parameters of
+ *                         consecutive cells.
+ *            : nx       - Number of cells in the x direction.
+ *            : ny       - Number of cells in the y direction (1 for 1D).
+ *            : nz       - Number of cells in the z direction (1 for 1D/2D).
+ *            : a        - Lower limits of the full intervals.
+ *            : b        - Upper limits of the full intervals.
+ *            : root     - Roots (output); NAN if the full interval does not
+ *                         bracket a root.
+ *            : pool     - Thread pool (see roots_thread_pool_create). If
+ *                         NULL, the tiles are solved sequentially.
+ *            : st       - Counters (output, see roots_grid_stats in
+ *                         roots.h); may be NULL.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         The tolerance and limits apply to each solve; on
+ *                         output, r->n_iters and r->n_evals are the totals
+ *                         over all cells. With a thread pool, r->trace and
+ *                         r->recent are not used.
+ *
+ * Returns    : roots_success if all cells are solved, roots_error_alloc if
+ *              memory cannot be allocated, and otherwise the error key of
+ *              the first cell, in the order of the solves, that is not
+ *              solved.
+ */
+roots_error_t roots_solve_grid(
+      roots_method method,
+      double f(const double, void *restrict),
+      void *restrict params,
+      const size_t stride,
+      const unsigned nx,
+      const unsigned ny,
+      const unsigned nz,
+      const double *restrict a,
+      const double *restrict b,
+      double *restrict root,
+      roots_thread_pool *pool,
+      roots_grid_stats *restrict st,
+      roots_params *restrict r) {
+
+  // Step 1: Set up the tasks
+  grid_batch ctx;
+  ctx.method = method;
+  ctx.f = f;
+  ctx.params = (char *)params;
+  ctx.stride = stride;
+  ctx.n[0] = nx;
+  ctx.n[1] = ny;
+  ctx.n[2] = nz;
+  unsigned n_tiles = 1;
+  for(int d = 0; d < 3; d++) {
+    ctx.n_tiles[d] = (ctx.n[d] + TILE - 1) / TILE;
+    n_tiles *= ctx.n_tiles[d];
+  }
+  ctx.n_tasks = n_tiles < MAX_TASKS ? n_tiles : MAX_TASKS;
+  ctx.a = a;
+  ctx.b = b;
+  ctx.root = root;
+  ctx.tmpl = *r;
+  if(pool) {
+    ctx.tmpl.trace = NULL;
+    ctx.tmpl.recent = NULL;
+  }
+  roots_grid_stats s = { 0 };
+  s.n_cells = (unsigned long)nx * ny * nz;
+  r->n_iters = r->n_evals = 0;
+  ctx.results = malloc(sizeof(*ctx.results) * MAX_TASKS);
+  if(!ctx.results) {
+    if(st) {
+      *st = s;
+    }
+    return (r->error_key = roots_error_alloc);
+  }
+
+  // Step 2: Solve all cells
+  roots_thread_pool_run(pool, ctx.n_tasks, grid_task, &ctx);
+
+  // Step 3: Gather the counters and the first error
+  r->error_key = roots_success;
+  for(unsigned t = 0; t < ctx.n_tasks; t++) {
+    r->n_iters += ctx.results[t].n_iters;
+    s.n_evals += ctx.results[t].n_evals;
+    s.n_seeds += ctx.results[t].n_seeds;
+    s.n_evals_seeds += ctx.results[t].n_evals_seeds;
+    s.n_narrow += ctx.results[t].n_narrow;
+    s.n_fallback += ctx.results[t].n_fallback;
+    if(r->error_key == roots_success) {
+      r->error_key = ctx.results[t].key;
+    }
+  }
+  r->n_evals = s.n_evals;
+  const double cells_evals = (double)s.n_cells * s.n_evals_seeds;
+  s.savings = s.n_seeds && s.n_evals_seeds
+                    ? 1 - (double)s.n_evals * s.n_seeds / cells_evals
+                    : 0;
+  if(st) {
+    *st = s;
+  }
+  free(ctx.results);
+  return r->error_key;
+}
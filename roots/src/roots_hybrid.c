@@ -0,0 +1,239 @@
+#include <float.h>
+
+#include "roots.h"
+#include "utils.h"
+
+// Steps taken by the hybrid method, from the fastest to the safest
+typedef enum { hybrid_interpolation, hybrid_ridder, hybrid_bisection } hybrid_step;
+
+// Number of evaluations over which the rate of a step is measured, and number
+// of halvings of the interval that the method may fall behind half the rate
+// of bisection before bisection is forced
+#define WINDOW 3
+#define SLACK 4
+
+/*
+ * Function   : hybrid_interpolate
+ * Author     : Leo Werneck
+ *
+ * Computes the inverse quadratic interpolation of (a,fa), (b,fb), and (c,fc),
+ * or, if the function values are not distinct, the secant step through b and
+ * c (or b and a, if c coincides with b).
+ *
+ * Parameters : a, b, c  - Contrapoint, best point, and previous best point.
+ *            : fa,fb,fc - Function values at these points.
+ *
+ * Returns    : The next approximation to the root.
+ */
+static inline double hybrid_interpolate(
+      const double a,
+      const double b,
+      const double c,
+      const double fa,
+      const double fb,
+      const double fc) {
+
+  if(fa != fc && fb != fc && c != a && c != b) {
+    return a * fb * fc / ((fa - fb) * (fa - fc)) + b * fa * fc / ((fb - fa) * (fb - fc))
+           + c * fa * fb / ((fc - fa) * (fc - fb));
+  }
+  if(c != b && fc != fb) {
+    return b - fb * (b - c) / (fb - fc);
+  }
+  return b - fb * (b - a) / (fb - fa);
+}
+
+/*
+ * Function   : hybrid_distance
+ * Author     : Leo Werneck
+ *
+ * Estimates the distance from b to the root as |f(b)| divided by the slope
+ * of the secant through b and c, limited to the width of the interval. Unlike
+ * |f(b)|, the estimate shrinks as fast as the error in b also near multiple
+ * roots, where |f(b)| shrinks much faster.
+ *
+ * Parameters : a, b, c  - Contrapoint, best point, and previous best point.
+ *            : fb, fc   - Function values at b and c.
+ *
+ * Returns    : The estimated distance.
+ */
+static inline double hybrid_distance(
+      const double a,
+      const double b,
+      const double c,
+      const double fb,
+      const double fc) {
+
+  if(b != c && fb != fc) {
+    return fmin(fabs(fb * (b - c) / (fb - fc)), fabs(a - b));
+  }
+  return fabs(a - b);
+}
+
+/*
+ * Function   : roots_hybrid
+ * Author     : Leo Werneck
+ *
+ * Find the root of f(x) in the interval [a,b] by switching between
+ * interpolation (inverse quadratic or secant), Ridder's, and bisection steps
+ * according to the convergence rate observed during the solve.
+ *
+ * Every step is credited with the number of halvings of the interval or of
+ * the distance to the root estimated from f(b) (see hybrid_distance),
+ * whichever is larger, that it achieved; the distance is counted because
+ * interpolation often converges to the root from one side, leaving the
+ * interval wide until the last step. Over every WINDOW evaluations, a
+ * step that averages less than one halving per evaluation, the rate that
+ * bisection guarantees, is replaced by the next safer one: interpolation by
+ * Ridder's steps, and these by bisection. Ridder's steps that average two
+ * halvings or more per evaluation give way to interpolation again, and after
+ * a few bisection steps interpolation is tried again; the number of
+ * bisection steps doubles every time bisection is resumed, so rough
+ * functions do not pay for repeated trials. In addition, bisection is forced
+ * whenever the interval has been halved SLACK times fewer than half the
+ * number of evaluations, so the method never needs more than about twice the
+ * evaluations of bisection, while it converges superlinearly near simple
+ * roots of smooth functions.
+ *
+ * Parameters : f        - Function for which the root is computed.
+ *            : fparams  - Object containing all parameters needed by the
+ *                         function f other than the variable x.
+ *            : a        - Lower limit of the initial interval.
+ *            : b        - Upper limit of the initial interval.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         The root is stored in r->root.
+ *
+ * Returns    : One the following error keys:
+ *                 - roots_success if the root is found
+ *                 - roots_error_root_not_bracketed if the interval [a,b]
+ *                   does not bracket a root of f(x)
+ *                 - roots_error_max_iter if the maximum allowed number of
+ *                   iterations is exceeded
+ *                 - roots_error_max_evals if the maximum allowed number of
+ *                   function evaluations is exceeded
+ *                 - roots_error_deadline if the deadline has passed
+ *
+ * References : https://en.wikipedia.org/wiki/Inverse_quadratic_interpolation
+ *              https://en.wikipedia.org/wiki/Ridders%27_method
+ */
+roots_error_t roots_hybrid(
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      double a,
+      double b,
+      roots_params *restrict r) {
+
+  // Step 0: Set basic info to the roots_params struct
+  sprintf(r->method, "Hybrid");
+  r->a = a;
+  r->b = b;
+
+  // Step 1: Check whether a or b is the root; compute fa and fb
+  double fa, fb;
+  if(check_a_b_compute_fa_fb(f, fparams, &a, &b, &fa, &fb, r) >= roots_success) {
+    return r->error_key;
+  }
+
+  // Step 2: Declare auxiliary variables. c is the best point before the
+  //         last step that changed it, and the window accumulates the
+  //         halvings and the evaluations of the current step type.
+  const double w0 = fabs(b - a);
+  const unsigned long n0 = r->n_evals;
+  double c = a, fc = fa, distance = w0;
+  hybrid_step step = hybrid_interpolation;
+  double window_bits = 0;
+  unsigned long window_evals = 0, hold = 2;
+
+  // Step 3: Hybrid algorithm
+  for(r->n_iters = 1; r->n_iters <= r->max_iters; r->n_iters++) {
+
+    // Step 3.a: Set the tolerance for this iteration
+    const double tol = 2 * DBL_EPSILON * fabs(b) + 0.5 * r->tol;
+
+    // Step 3.b: Check for convergence
+    if(fabs(a - b) < 2 * tol || fb == 0.0) {
+      return set_root(r, roots_success, b, fb, a, b);
+    }
+
+    // Step 3.c: Force bisection if the interval lags behind half the rate
+    //           of bisection
+    const double width = fabs(a - b), distance_old = distance;
+    const unsigned long evals = r->n_evals;
+    const bool behind = log2(w0 / width) < 0.5 * (double)(evals - n0) - SLACK;
+    const hybrid_step s = behind ? hybrid_bisection : step;
+    if(budget_exhausted(r, a, b, fa, fb)) {
+      return r->error_key;
+    }
+
+    // Step 3.d: Take the step
+    const double b_old = b, fb_old = fb;
+    if(s == hybrid_interpolation) {
+      double x = hybrid_interpolate(a, b, c, fa, fb, fc);
+      if(!isfinite(x) || (x != b && !is_inside(x, a, b))) {
+        x = midpoint(a, b, r);
+      }
+      else if(fabs(x - b) < tol) {
+        x = b + (a > b ? tol : -tol);
+      }
+      const double fx = evaluate(f, fparams, x, r);
+      update_bracket(x, fx, &a, &b, &fa, &fb);
+    }
+    else if(s == hybrid_ridder) {
+      // Ridder's step needs the arithmetic midpoint
+      const double a0 = a, fa0 = fa, fb0 = fb;
+      const double m = 0.5 * (a + b);
+      const double fm = evaluate(f, fparams, m, r);
+      update_bracket(m, fm, &a, &b, &fa, &fb);
+      const double x = m + (m - a0) * sign(fa0 - fb0) * fm / sqrt(fm * fm - fa0 * fb0);
+      if(fm != 0.0 && isfinite(x) && is_inside(x, a, b)) {
+        if(budget_exhausted(r, a, b, fa, fb)) {
+          return r->error_key;
+        }
+        const double fx = evaluate(f, fparams, x, r);
+        update_bracket(x, fx, &a, &b, &fa, &fb);
+      }
+    }
+    else {
+      const double x = midpoint(a, b, r);
+      const double fx = evaluate(f, fparams, x, r);
+      update_bracket(x, fx, &a, &b, &fa, &fb);
+    }
+
+    if(b != b_old) {
+      c = b_old;
+      fc = fb_old;
+    }
+
+    // Step 3.e: Credit the step with the halvings of the interval or of the
+    //           distance to the root, and switch steps at the end of the
+    //           window
+    distance = hybrid_distance(a, b, c, fb, fc);
+    if(behind) {
+      continue;
+    }
+    window_bits += fmax(log2(width / fabs(a - b)), log2(distance_old / distance));
+    window_evals += r->n_evals - evals;
+    if(step == hybrid_bisection) {
+      if(window_evals >= hold) {
+        step = hybrid_interpolation;
+        hold *= 2;
+        window_bits = 0;
+        window_evals = 0;
+      }
+    }
+    else if(window_evals >= WINDOW) {
+      if(window_bits < window_evals) {
+        step = step == hybrid_interpolation ? hybrid_ridder : hybrid_bisection;
+      }
+      else if(step == hybrid_ridder && window_bits >= 2 * window_evals) {
+        step = hybrid_interpolation;
+      }
+      window_bits = 0;
+      window_evals = 0;
+    }
+  }
+
+  // Step 4: The only way to get here is if we have exceeded the maximum number
+  //         of iterations allowed.
+  return set_best(r, roots_error_max_iter, a, b, fa, fb);
+}
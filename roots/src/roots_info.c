@@ -35,12 +35,42 @@ void roots_info(const roots_params *restrict r) {
       printf("(roots)   %16s : ", "Error message");
       printf("Maximum number of iterations (%d) exceeded.\n", r->max_iters);
       break;
+    case roots_error_max_evals:
+      printf("Failure\n");
+      printf("(roots)   %16s : ", "Error message");
+      printf("Maximum number of function evaluations (%u) exceeded.\n", r->max_evals);
+      break;
+    case roots_error_deadline:
+      printf("Failure\n");
+      printf("(roots)   %16s : ", "Error message");
+      printf("Deadline exceeded.\n");
+      break;
+    case roots_error_alloc:
+      printf("Failure\n");
+      printf("(roots)   %16s : ", "Error message");
+      printf("Memory allocation failed.\n");
+      break;
   }
 
-  // Step 2: If succeeded, print detailed success message
-  if(!r->error_key) {
+  // Step 2: If succeeded, print detailed success message. If the method
+  //         stopped early, print the best approximation found instead.
+  if(r->error_key != roots_continue && r->error_key != roots_error_root_not_bracketed) {
     printf("(roots)   %16s : %d\n", "Iterations", r->n_iters);
-    printf("(roots)   %16s : %.15e\n", "Root", r->root);
+    printf("(roots)   %16s : %u\n", "Evaluations", r->n_evals);
+    if(r->n_surrogate_evals) {
+      printf("(roots)   %16s : %u\n", "Surrogate evals", r->n_surrogate_evals);
+    }
+    if(r->multiplicity > 1) {
+      printf("(roots)   %16s : %.2f\n", "Multiplicity", r->multiplicity);
+    }
+    printf("(roots)   %16s : %.15e\n", r->error_key ? "Best root" : "Root", r->root);
     printf("(roots)   %16s : %.15e\n", "Residual", r->residual);
+    if(isfinite(r->dfdx)) {
+      printf("(roots)   %16s : %.15e\n", "Derivative", r->dfdx);
+    }
+    printf(
+          "(roots)   %16s : [%c%21.15e, %c%21.15e]\n", "Final interval",
+          r->bracket_a >= 0 ? '+' : '-', fabs(r->bracket_a),
+          r->bracket_b >= 0 ? '+' : '-', fabs(r->bracket_b));
   }
 }
@@ -0,0 +1,345 @@
+#include <float.h>
+
+#include "roots.h"
+#include "utils.h"
+
+typedef struct {
+  double (*f)(const double, void *restrict);
+  void *fparams;
+  const double *y;
+  double *x;
+  bool increasing;
+  roots_params *r;
+} inverse_context;
+
+// A subinterval [x[1],x[2]] of the initial interval, together with the points
+// evaluated immediately to its left (x[0]) and right (x[3]), if any (NAN
+// otherwise), and the function values at these points.
+typedef struct {
+  double x[4], fx[4];
+} inverse_node;
+
+typedef struct {
+  double (*f)(const double, void *restrict);
+  void *fparams;
+  double y;
+} shifted_params;
+
+/*
+ * Function   : shifted
+ * Author     : Leo Werneck
+ *
+ * Computes f(x) - y, whose root is the solution of f(x) = y.
+ *
+ * Parameters : x        - Point at which the function is evaluated.
+ *            : p        - Pointer to a shifted_params struct.
+ *
+ * Returns    : f(x) - y.
+ */
+static double shifted(const double x, void *restrict p) {
+  const shifted_params *s = (const shifted_params *)p;
+  return s->f(x, s->fparams) - s->y;
+}
+
+/*
+ * Function   : inverse_lagrange
+ * Author     : Leo Werneck
+ *
+ * Evaluates at y the polynomial x(y) that interpolates the points (fx_j,x_j),
+ * i.e., performs inverse interpolation.
+ *
+ * Parameters : n        - Number of points.
+ *            : x        - Abscissas.
+ *            : fx       - Function values at the abscissas (distinct).
+ *            : y        - Target value.
+ *
+ * Returns    : The interpolated solution of f(x) = y.
+ */
+static inline double inverse_lagrange(
+      const int n,
+      const double *restrict x,
+      const double *restrict fx,
+      const double y) {
+
+  double res = 0;
+  for(int j = 0; j < n; j++) {
+    double l = x[j];
+    for(int k = 0; k < n; k++) {
+      if(k != j) {
+        l *= (y - fx[k]) / (fx[j] - fx[k]);
+      }
+    }
+    res += l;
+  }
+  return res;
+}
+
+/*
+ * Function   : node_interpolate
+ * Author     : Leo Werneck
+ *
+ * Inverse interpolation of f(x) = y using all points available in the node:
+ * cubic if both outer points exist, quadratic if only one does, and linear
+ * otherwise. If both outer points exist, the error estimate is the difference
+ * between the two quadratic interpolants that exclude either of them.
+ *
+ * Parameters : n        - Node.
+ *            : y        - Target value.
+ *            : err      - Error estimate (INFINITY if not available).
+ *
+ * Returns    : The interpolated solution of f(x) = y.
+ */
+static double node_interpolate(
+      const inverse_node *restrict n,
+      const double y,
+      double *err) {
+
+  const double *x = n->x;
+  const double *fx = n->fx;
+  const bool has_l = isfinite(x[0]);
+  const bool has_r = isfinite(x[3]);
+  *err = INFINITY;
+  if(has_l && has_r) {
+    *err = fabs(inverse_lagrange(3, x, fx, y) - inverse_lagrange(3, x + 1, fx + 1, y));
+    return inverse_lagrange(4, x, fx, y);
+  }
+  if(has_l) {
+    return inverse_lagrange(3, x, fx, y);
+  }
+  if(has_r) {
+    return inverse_lagrange(3, x + 1, fx + 1, y);
+  }
+  return inverse_lagrange(2, x + 1, fx + 1, y);
+}
+
+/*
+ * Function   : finish
+ * Author     : Leo Werneck
+ *
+ * Solves f(x) = y for a single target in the node using Brent's method,
+ * reusing the function values at the end points of the node.
+ *
+ * Parameters : ctx      - Context of the inverse evaluation.
+ *            : n        - Node.
+ *            : i        - Index of the target.
+ *
+ * Returns    : The error key returned by Brent's method.
+ */
+static roots_error_t finish(
+      inverse_context *ctx,
+      const inverse_node *restrict n,
+      const int i) {
+
+  shifted_params s = { ctx->f, ctx->fparams, ctx->y[i] };
+  double a = n->x[1], b = n->x[2];
+  double fa = n->fx[1] - s.y, fb = n->fx[2] - s.y;
+  ensure_b_is_closest_to_root(&a, &b, &fa, &fb);
+
+  // Brent's method runs on a copy of r, sharing its evaluation budget
+  roots_params t = *ctx->r;
+  const roots_error_t key = roots_brent_core(shifted, &s, a, b, fa, fb, &t);
+  ctx->r->n_evals = t.n_evals;
+  ctx->r->n_iters += t.n_iters;
+  ctx->x[i] = t.root;
+  return key;
+}
+
+/*
+ * Function   : inverse
+ * Author     : Leo Werneck
+ *
+ * Solves f(x) = y[i] for the targets i0 <= i < i1, all of which are known to
+ * lie in the node. If the node contains more than one target, f is evaluated
+ * at the interpolated solution for the median target, and the targets are
+ * split between the two new nodes. The function recurses on the side with
+ * fewer targets and iterates on the other, so that the recursion depth is at
+ * most log2(i1-i0).
+ *
+ * Parameters : ctx      - Context of the inverse evaluation.
+ *            : node     - Node.
+ *            : i0       - First target.
+ *            : i1       - One past the last target.
+ *
+ * Returns    : roots_success if all targets are solved, otherwise the first
+ *              error key encountered.
+ */
+static roots_error_t inverse(inverse_context *ctx, inverse_node node, int i0, int i1) {
+
+  roots_params *r = ctx->r;
+  roots_error_t key = roots_success;
+  while(i0 < i1) {
+    inverse_node *n = &node;
+    const double xl = n->x[1], xr = n->x[2];
+    const double w = xr - xl;
+    const double tol = 2 * DBL_EPSILON * fmax(fabs(xl), fabs(xr)) + 0.5 * r->tol;
+
+    // Step 1: If the node is narrower than the tolerance, use linear
+    //         interpolation for all targets.
+    if(w < 2 * tol) {
+      for(int i = i0; i < i1; i++) {
+        ctx->x[i] = inverse_lagrange(2, n->x + 1, n->fx + 1, ctx->y[i]);
+      }
+      return key;
+    }
+
+    // Step 2: Accept the interpolated solutions if their error estimates are
+    //         all below the tolerance.
+    bool accept = true;
+    for(int i = i0; accept && i < i1; i++) {
+      double err;
+      ctx->x[i] = node_interpolate(n, ctx->y[i], &err);
+      accept = err < tol && is_inside(ctx->x[i], xl, xr);
+    }
+    if(accept) {
+      return key;
+    }
+
+    // Step 3: Finish single targets with Brent's method
+    if(i1 - i0 == 1) {
+      const roots_error_t k = finish(ctx, n, i0);
+      return key == roots_success ? k : key;
+    }
+
+    // Step 4: Interpolate the solution for the median target; keep it away
+    //         from the end points so that the node always shrinks.
+    double err;
+    double xm = node_interpolate(n, ctx->y[(i0 + i1) / 2], &err);
+    if(!isfinite(xm)) {
+      xm = xl + 0.5 * w;
+    }
+    xm = fmin(fmax(xm, xl + w / 16), xr - w / 16);
+
+    // Step 5: Evaluate f at xm. If we cannot afford it, use the interpolated
+    //         solutions for all targets.
+    r->n_iters++;
+    if(budget_exhausted(r, xl, xr, n->fx[1], n->fx[2])) {
+      for(int i = i0; i < i1; i++) {
+        ctx->x[i] = node_interpolate(n, ctx->y[i], &err);
+      }
+      return key == roots_success ? r->error_key : key;
+    }
+    const double fm = evaluate(ctx->f, ctx->fparams, xm, r);
+
+    // Step 6: Split the targets into those below, at, and above f(xm)
+    int k0 = i0, k1;
+    while(k0 < i1 && ctx->y[k0] < fm) {
+      k0++;
+    }
+    for(k1 = k0; k1 < i1 && ctx->y[k1] == fm; k1++) {
+      ctx->x[k1] = xm;
+    }
+    const inverse_node left
+          = { { n->x[0], xl, xm, xr }, { n->fx[0], n->fx[1], fm, n->fx[2] } };
+    const inverse_node right
+          = { { xl, xm, xr, n->x[3] }, { n->fx[1], fm, n->fx[2], n->fx[3] } };
+    const inverse_node below = ctx->increasing ? left : right;
+    const inverse_node above = ctx->increasing ? right : left;
+
+    // Step 7: Recurse on the side with fewer targets; iterate on the other
+    roots_error_t k;
+    if(k0 - i0 < i1 - k1) {
+      k = inverse(ctx, below, i0, k0);
+      node = above;
+      i0 = k1;
+    }
+    else {
+      k = inverse(ctx, above, k1, i1);
+      node = below;
+      i1 = k0;
+    }
+    key = key == roots_success ? k : key;
+  }
+  return key;
+}
+
+/*
+ * Function   : roots_inverse
+ * Author     : Leo Werneck
+ *
+ * Solves f(x) = y[i] for many targets y[i] and a single monotone function f
+ * in the interval [a,b], sharing function evaluations between targets.
+ *
+ * Each evaluation of f narrows the brackets of all targets it separates: the
+ * targets are split recursively at the interpolated solution for the median
+ * target of each subinterval. Subintervals are finished without further
+ * evaluations once the inverse cubic interpolation through the neighboring
+ * points is accurate to within the tolerance for all of their targets (the
+ * error is estimated by the difference between two inverse quadratic
+ * interpolants). Otherwise, a subinterval containing a single target is
+ * finished with Brent's method, reusing the known function values at its end
+ * points. The number of function evaluations thus grows much slower than the
+ * number of targets: for the normal CDF at 1e-12, about 2.8 evaluations per
+ * target for 1000 targets and 0.8 for 100000, against 12.7 for independent
+ * solves with Brent's method (see bench/bench_inverse.c).
+ *
+ * Parameters : f        - Monotone function (increasing or decreasing).
+ *            : fparams  - Object containing all parameters needed by the
+ *                         function f other than the variable x.
+ *            : a        - Lower limit of the initial interval.
+ *            : b        - Upper limit of the initial interval.
+ *            : n        - Number of targets.
+ *            : y        - Targets, sorted in ascending order.
+ *            : x        - Solutions of f(x) = y[i] (output). Targets that
+ *                         are not bracketed by f(a) and f(b) are set to NAN.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         The number of function evaluations is stored in
+ *                         r->n_evals; r->root is not used.
+ *
+ * Returns    : One the following error keys:
+ *                 - roots_success if the solutions for all targets are found
+ *                 - roots_error_root_not_bracketed if any of the targets is
+ *                   not bracketed by f(a) and f(b)
+ *                 - roots_error_max_iter if the maximum allowed number of
+ *                   iterations is exceeded for any of the targets
+ *                 - roots_error_max_evals if the maximum allowed number of
+ *                   function evaluations is exceeded; the interpolated
+ *                   solutions are returned for the remaining targets
+ *                 - roots_error_deadline if the deadline has passed
+ *              If more than one error occurs, the first one is returned.
+ */
+roots_error_t roots_inverse(
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      double a,
+      double b,
+      const int n,
+      const double *restrict y,
+      double *restrict x,
+      roots_params *restrict r) {
+
+  // Step 0: Set basic info to the roots_params struct
+  sprintf(r->method, "Inverse evaluation (%d targets)", n);
+  r->a = a;
+  r->b = b;
+  start_solve(r);
+  r->n_evals = 0;
+  r->error_key = roots_success;
+
+  // Step 1: Compute fa and fb, with a < b
+  if(a > b) {
+    swap(&a, &b);
+  }
+  const double fa = evaluate(f, fparams, a, r);
+  const double fb = evaluate(f, fparams, b, r);
+  const double flo = fa < fb ? fa : fb;
+  const double fhi = fa < fb ? fb : fa;
+
+  // Step 2: Handle the targets outside or at the ends of [flo,fhi]
+  int i0 = 0, i1 = n;
+  while(i0 < n && y[i0] <= flo) {
+    x[i0] = y[i0] == flo ? (fa < fb ? a : b) : NAN;
+    r->error_key = y[i0] < flo ? roots_error_root_not_bracketed : r->error_key;
+    i0++;
+  }
+  while(i1 > i0 && y[i1 - 1] >= fhi) {
+    x[i1 - 1] = y[i1 - 1] == fhi ? (fa < fb ? b : a) : NAN;
+    r->error_key = y[i1 - 1] > fhi ? roots_error_root_not_bracketed : r->error_key;
+    i1--;
+  }
+
+  // Step 3: Solve for the remaining targets
+  inverse_context ctx = { f, fparams, y, x, fa < fb, r };
+  const inverse_node node = { { NAN, a, b, NAN }, { NAN, fa, fb, NAN } };
+  const roots_error_t key = inverse(&ctx, node, i0, i1);
+  return (r->error_key = r->error_key == roots_success ? key : r->error_key);
+}
@@ -0,0 +1,65 @@
+#include <string.h>
+
+#include "roots.h"
+#include "dispatch.h"
+
+isa_level roots_isa_level = isa_baseline;
+
+static const char *isa_names[n_isa_levels] = { "baseline", "avx2", "avx512" };
+
+/*
+ * Function   : select_isa
+ * Author     : Leo Werneck
+ *
+ * Selects the instruction set level of the vectorized kernels when the
+ * library is loaded: the best level supported by the processor, or the level
+ * named by the environment variable ROOTS_ISA (baseline, avx2, or avx512) if
+ * the processor supports it. Forcing a level is meant for testing and
+ * benchmarking.
+ *
+ * Parameters : None.
+ *
+ * Returns    : Nothing.
+ */
+__attribute__((constructor)) static void select_isa(void) {
+
+  // Step 1: Find the best level supported by the processor
+  isa_level best = isa_baseline;
+#if defined(__x86_64__) && defined(__GNUC__)
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    best = isa_avx2;
+    if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")
+       && __builtin_cpu_supports("avx512vl")) {
+      best = isa_avx512;
+    }
+  }
+#endif
+
+  // Step 2: Apply the level requested by the user, if any
+  roots_isa_level = best;
+  const char *name = getenv("ROOTS_ISA");
+  if(name) {
+    for(int i = 0; i < n_isa_levels; i++) {
+      if(!strcmp(name, isa_names[i])) {
+        roots_isa_level = i <= (int)best ? (isa_level)i : best;
+        break;
+      }
+    }
+  }
+}
+
+/*
+ * Function   : roots_isa
+ * Author     : Leo Werneck
+ *
+ * Returns the name of the instruction set level used by the vectorized
+ * kernels (see select_isa).
+ *
+ * Parameters : None.
+ *
+ * Returns    : "baseline", "avx2", or "avx512".
+ */
+const char *roots_isa(void) {
+  return isa_names[roots_isa_level];
+}
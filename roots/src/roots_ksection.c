@@ -0,0 +1,251 @@
+#include <float.h>
+
+#include "roots.h"
+#include "utils.h"
+
+// Largest number of points per round is MAX_K+2; the points are kept on the
+// stack, and rounds this large already gain little from further points
+#define MAX_K 510
+
+typedef struct {
+  double (*f)(const double, void *restrict);
+  void *fparams;
+  const double *x;
+  double *fx;
+} ksection_args;
+
+/*
+ * Function   : ksection_task
+ * Author     : Leo Werneck
+ *
+ * Evaluates the function at a single point. This is the task that is run on
+ * the thread pool.
+ *
+ * Parameters : i        - Index of the point.
+ *            : p        - Pointer to a ksection_args struct.
+ *
+ * Returns    : Nothing.
+ */
+static void ksection_task(const unsigned i, void *restrict p) {
+  const ksection_args *args = (const ksection_args *)p;
+  args->fx[i] = args->f(args->x[i], args->fparams);
+}
+
+/*
+ * Function   : interpolate
+ * Author     : Leo Werneck
+ *
+ * Inverse quadratic interpolation through (a,fa), (b,fb), and (c,fc), falling
+ * back to linear interpolation between a and b if the function values are not
+ * distinct. This is the interpolation step of Brent's method.
+ *
+ * Parameters : a, b, c  - Points; f(a)f(b) < 0.
+ *            : fa, fb, fc - Function values at these points.
+ *
+ * Returns    : The interpolated root.
+ */
+static inline double interpolate(
+      const double a,
+      const double b,
+      const double c,
+      const double fa,
+      const double fb,
+      const double fc) {
+
+  if(fc == fa || fc == fb) {
+    return b - fb * (b - a) / (fb - fa);
+  }
+  return a * fb * fc / ((fa - fb) * (fa - fc)) + b * fa * fc / ((fb - fa) * (fb - fc))
+         + c * fa * fb / ((fc - fa) * (fc - fb));
+}
+
+/*
+ * Function   : roots_ksection
+ * Author     : Leo Werneck
+ *
+ * Find the root of f(x) in the interval [a,b] using parallel k-section.
+ *
+ * This is a latency-oriented method for functions that are expensive to
+ * evaluate. Every round, f is evaluated concurrently at k+2 points of the
+ * current bracket, which speculatively cover both candidates Brent's method
+ * chooses between: the interpolation point (inverse quadratic interpolation
+ * through the best three points of the last round), surrounded by a cluster
+ * of points that bracket the root tightly if the interpolation is accurate,
+ * and equally spaced interior points. Without an interpolation point, the k+1
+ * equally spaced points split the bracket into k+2 parts. The new bracket is the smallest sign-changing subinterval, so
+ * the number of rounds, and hence the wall time, scales as 1/log(k+1). In
+ * our benchmarks the number of sequential evaluations drops by about 30%
+ * relative to Brent's method for k >= 7; k = 1 is not recommended.
+ *
+ * The function f must be safe to call concurrently with the same fparams.
+ *
+ * Parameters : f        - Function for which the root is computed.
+ *            : fparams  - Object containing all parameters needed by the
+ *                         function f other than the variable x.
+ *            : a        - Lower limit of the initial interval.
+ *            : b        - Upper limit of the initial interval.
+ *            : k        - The number of points evaluated per round is k+2;
+ *                         k is limited to MAX_K (510).
+ *            : pool     - Thread pool (see roots_thread_pool_create). If
+ *                         NULL, the points are evaluated sequentially.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         The root is stored in r->root. Each round counts
+ *                         as one iteration.
+ *
+ * Returns    : One the following error keys:
+ *                 - roots_success if the root is found
+ *                 - roots_error_root_not_bracketed if the interval [a,b]
+ *                   does not bracket a root of f(x)
+ *                 - roots_error_max_iter if the maximum allowed number of
+ *                   iterations is exceeded
+ *                 - roots_error_max_evals if the maximum allowed number of
+ *                   function evaluations is exceeded
+ *                 - roots_error_deadline if the deadline has passed
+ *
+ * References : Brent, Algorithms for Minimization Without Derivatives (1973)
+ */
+roots_error_t roots_ksection(
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      double a,
+      double b,
+      unsigned k,
+      roots_thread_pool *pool,
+      roots_params *restrict r) {
+
+  // Step 0: Set basic info to the roots_params struct
+  k = k < MAX_K ? k : MAX_K;
+  sprintf(r->method, "Parallel k-section (k = %u)", k);
+  r->a = a;
+  r->b = b;
+
+  // Step 1: Check whether a or b is the root; compute fa and fb
+  double fa, fb;
+  if(check_a_b_compute_fa_fb(f, fparams, &a, &b, &fa, &fb, r) >= roots_success) {
+    return r->error_key;
+  }
+
+  // Step 2: Declare auxiliary variables. The points of each round, together
+  //         with a and b, are kept in x (sorted) and fx.
+  const unsigned n_max = (k ? k : 1) + 2;
+  double x[n_max + 2], fx[n_max + 2];
+  double c = a;
+  double fc = fa;
+  ksection_args args = { f, fparams, x, fx };
+
+  // Step 3: k-section algorithm
+  for(r->n_iters = 1; r->n_iters <= r->max_iters; r->n_iters++) {
+
+    // Step 3.a: Set the tolerance for this iteration
+    const double tol = 2 * DBL_EPSILON * fabs(b) + 0.5 * r->tol;
+
+    // Step 3.b: Check for convergence
+    if(fabs(a - b) < 2 * tol || fb == 0.0) {
+      return set_root(r, roots_success, b, fb, a, b);
+    }
+
+    // Step 3.c: Check whether we can afford another round; if the evaluation
+    //           budget is almost exhausted, use only the points it allows.
+    if(budget_exhausted(r, a, b, fa, fb)) {
+      return r->error_key;
+    }
+    unsigned n = n_max;
+    if(r->max_evals && r->max_evals - r->n_evals < n) {
+      n = r->max_evals - r->n_evals;
+    }
+
+    // Step 3.d: Set the points of this round, most valuable first. If the
+    //           interpolation point s is usable, it is evaluated together with
+    //           a cluster of points around it, at distances decreasing
+    //           geometrically from |s-b|/2 to tol, so that the root is tightly
+    //           bracketed whenever s is accurate. The remaining points (about
+    //           half of them) divide the bracket into equal parts, which
+    //           guarantees that it shrinks.
+    unsigned m = 0;
+    const double s = interpolate(a, b, c, fa, fb, fc);
+    if(isfinite(s) && is_inside(s, a, b) && fabs(s - a) > tol && fabs(s - b) > tol) {
+      x[m++] = s;
+      const unsigned n_pairs = (k + 2) / 4;
+      const double dist = 0.5 * fabs(s - b);
+      const double q = dist > tol ? pow(tol / dist, 1.0 / (n_pairs ? n_pairs : 1)) : 1;
+      double delta = dist;
+      for(unsigned i = 0; i < n_pairs; i++) {
+        delta *= q;
+        if(is_inside(s - delta, a, b)) {
+          x[m++] = s - delta;
+        }
+        if(is_inside(s + delta, a, b)) {
+          x[m++] = s + delta;
+        }
+      }
+    }
+    const unsigned n_grid = n_max - m + 1;
+    const double lo = a < b ? a : b;
+    const double h = fabs(b - a) / n_grid;
+    for(unsigned i = 1; i < n_grid; i++) {
+      x[m++] = lo + i * h;
+    }
+    n = m < n ? m : n;
+
+    // Step 3.e: Evaluate f at all points concurrently; the evaluations are
+    //           recorded afterwards since a trace is used by one thread only.
+    //           They are remembered in reverse, so that the points closest
+    //           to the interpolation point come last.
+    roots_thread_pool_run(pool, n, ksection_task, &args);
+    for(unsigned i = n; i-- > 0;) {
+      r->n_evals++;
+      remember(r, x[i], fx[i]);
+      if(r->trace) {
+        trace_evaluation(r, x[i], fx[i]);
+      }
+    }
+
+    // Step 3.f: Add the end points and sort all points (insertion sort)
+    x[n] = a;
+    fx[n] = fa;
+    x[n + 1] = b;
+    fx[n + 1] = fb;
+    n += 2;
+    for(unsigned i = 1; i < n; i++) {
+      for(unsigned j = i; j > 0 && x[j - 1] > x[j]; j--) {
+        swap(&x[j - 1], &x[j]);
+        swap(&fx[j - 1], &fx[j]);
+      }
+    }
+
+    // Step 3.g: Find the smallest sign-changing subinterval
+    unsigned i0 = 0;
+    double width = INFINITY;
+    for(unsigned i = 0; i < n - 1; i++) {
+      if(fx[i] == 0.0) {
+        return set_root(r, roots_success, x[i], fx[i], x[i], x[i]);
+      }
+      if(fx[i] * fx[i + 1] < 0 && x[i + 1] - x[i] < width) {
+        width = x[i + 1] - x[i];
+        i0 = i;
+      }
+    }
+    if(fx[n - 1] == 0.0) {
+      return set_root(r, roots_success, x[n - 1], fx[n - 1], x[n - 1], x[n - 1]);
+    }
+
+    // Step 3.h: Update the bracket. The third point for the interpolation is
+    //           the neighbor of the end point with the smallest |f|.
+    a = x[i0];
+    fa = fx[i0];
+    b = x[i0 + 1];
+    fb = fx[i0 + 1];
+    const bool left = fabs(fa) < fabs(fb);
+    const unsigned i1
+          = left ? (i0 > 0 ? i0 - 1 : i0 + 2) : (i0 + 2 < n ? i0 + 2 : i0 - 1);
+    if(i1 < n) {
+      c = x[i1];
+      fc = fx[i1];
+    }
+    ensure_b_is_closest_to_root(&a, &b, &fa, &fb);
+  }
+
+  // Step 4: The only way to get here is if we have exceeded the maximum number
+  //         of iterations allowed.
+  return set_best(r, roots_error_max_iter, a, b, fa, fb);
+}
@@ -0,0 +1,50 @@
+#include <string.h>
+
+#include "roots.h"
+
+typedef struct {
+  const char *name;
+  roots_method method;
+} named_method;
+
+static const named_method methods[] = {
+  { "bisection", roots_bisection },
+  { "secant", roots_secant },
+  { "false_position", roots_false_position },
+  { "illinois", roots_illinois },
+  { "pegasus", roots_pegasus },
+  { "anderson_bjorck", roots_anderson_bjorck },
+  { "dekker", roots_dekker },
+  { "ridder", roots_ridder },
+  { "brent", roots_brent },
+  { "toms748", roots_toms748 },
+  { "steffensen", roots_steffensen },
+  { "muller", roots_muller },
+  { "multipoint", roots_multipoint },
+  { "hybrid", roots_hybrid },
+  { "bisection_fixed", roots_bisection_fixed },
+  { "ridder_fixed", roots_ridder_fixed },
+  { "chandrupatla_fixed", roots_chandrupatla_fixed },
+};
+
+/*
+ * Function   : roots_method_from_name
+ * Author     : Leo Werneck
+ *
+ * Looks up a root-finding method by name. The name of roots_X is "X", e.g.,
+ * "brent" for roots_brent and "ridder_fixed" for roots_ridder_fixed. Only
+ * methods with the signature roots_method can be looked up.
+ *
+ * Parameters : name     - Name of the method.
+ *
+ * Returns    : The method, or NULL if there is no method with this name.
+ */
+roots_method roots_method_from_name(const char *name) {
+
+  for(unsigned i = 0; i < sizeof(methods) / sizeof(*methods); i++) {
+    if(!strcmp(name, methods[i].name)) {
+      return methods[i].method;
+    }
+  }
+  return NULL;
+}
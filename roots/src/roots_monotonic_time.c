@@ -0,0 +1,23 @@
+#include <time.h>
+
+#include "roots.h"
+
+/*
+ * Function   : roots_monotonic_time
+ * Author     : Leo Werneck
+ *
+ * Reads the monotonic clock. Deadlines passed to the root-finding methods
+ * (see roots_params) are absolute times measured by this clock, e.g.,
+ * r.deadline = roots_monotonic_time() + 1e-3 allows the next solve to take
+ * at most one millisecond.
+ *
+ * Parameters : None.
+ *
+ * Returns    : Time, in seconds, from an arbitrary but fixed point in the past.
+ */
+double roots_monotonic_time(void) {
+
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + 1e-9 * t.tv_nsec;
+}
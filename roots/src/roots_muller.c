@@ -0,0 +1,134 @@
+#include <float.h>
+
+#include "roots.h"
+#include "utils.h"
+
+/*
+ * Function   : muller_interpolate
+ * Author     : Leo Werneck
+ *
+ * Computes the root of the parabola through (x0,f0), (x1,f1), and (x2,f2)
+ * that is closest to x2. If the parabola has no real roots, the real part of
+ * its complex roots, i.e., its vertex, is returned instead. If the points are
+ * collinear, this reduces to the secant method.
+ *
+ * Parameters : x0, x1, x2 - Three most recent points (x2 is the newest).
+ *            : f0, f1, f2 - Function values at these points.
+ *
+ * Returns    : The next approximation to the root.
+ */
+static inline double muller_interpolate(
+      const double x0,
+      const double x1,
+      const double x2,
+      const double f0,
+      const double f1,
+      const double f2) {
+
+  const double h1 = x1 - x0;
+  const double h2 = x2 - x1;
+  const double d1 = (f1 - f0) / h1;
+  const double d2 = (f2 - f1) / h2;
+  const double A = (d2 - d1) / (h2 + h1);
+  const double B = d2 + A * h2;
+  const double D = B * B - 4 * A * f2;
+  if(D < 0) {
+    return x2 - B / (2 * A);
+  }
+  const double den = B >= 0 ? B + sqrt(D) : B - sqrt(D);
+  return x2 - 2 * f2 / den;
+}
+
+/*
+ * Function   : roots_muller
+ * Author     : Leo Werneck
+ *
+ * Find the root of f(x) in the interval [a,b] using Muller's method,
+ * safeguarded by bisection.
+ *
+ * Muller's method interpolates the three most recent points by a parabola
+ * and takes its root closest to the newest point as the next iterate. It
+ * converges with order ~1.84 using a single function evaluation per
+ * iteration.
+ *
+ * Parameters : f        - Function for which the root is computed.
+ *            : fparams  - Object containing all parameters needed by the
+ *                         function f other than the variable x.
+ *            : a        - Lower limit of the initial interval.
+ *            : b        - Upper limit of the initial interval.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         The root is stored in r->root.
+ *
+ * Returns    : One the following error keys:
+ *                 - roots_success if the root is found
+ *                 - roots_error_root_not_bracketed if the interval [a,b]
+ *                   does not bracket a root of f(x)
+ *                 - roots_error_max_iter if the maximum allowed number of
+ *                   iterations is exceeded
+ *                 - roots_error_max_evals if the maximum allowed number of
+ *                   function evaluations is exceeded
+ *                 - roots_error_deadline if the deadline has passed
+ *
+ * References : https://en.wikipedia.org/wiki/Muller%27s_method
+ */
+roots_error_t roots_muller(
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      double a,
+      double b,
+      roots_params *restrict r) {
+
+  // Step 0: Set basic info to the roots_params struct
+  sprintf(r->method, "Muller's");
+  r->a = a;
+  r->b = b;
+
+  // Step 1: Check whether a or b is the root; compute fa and fb
+  double fa, fb;
+  if(check_a_b_compute_fa_fb(f, fparams, &a, &b, &fa, &fb, r) >= roots_success) {
+    return r->error_key;
+  }
+
+  // Step 2: Declare auxiliary variables. The history (x0,x1) holds the two
+  //         points evaluated before the newest one, which is b initially.
+  double x0 = a, x1 = a, x2 = b;
+  double f0 = fa, f1 = fa, f2 = fb;
+  double d = b - a;
+  double e = d;
+
+  // Step 3: Muller's algorithm
+  for(r->n_iters = 1; r->n_iters <= r->max_iters; r->n_iters++) {
+
+    // Step 3.a: Set the tolerance for this iteration
+    const double tol = 2 * DBL_EPSILON * fabs(b) + 0.5 * r->tol;
+
+    // Step 3.b: Check for convergence
+    if(fabs(a - b) < 2 * tol || fb == 0.0) {
+      return set_root(r, roots_success, b, fb, a, b);
+    }
+
+    // Step 3.c: Secant step on the first iteration, Muller's step afterwards
+    const double s = r->n_iters == 1 ? b - fb * (b - a) / (fb - fa)
+                                     : muller_interpolate(x0, x1, x2, f0, f1, f2);
+
+    // Step 3.d: Safeguard the step and compute the function at the new point
+    const double c = safeguard(a, b, s, tol, &d, &e);
+    if(budget_exhausted(r, a, b, fa, fb)) {
+      return r->error_key;
+    }
+    const double fc = evaluate(f, fparams, c, r);
+
+    // Step 3.e: Cycle the history and update the bracket
+    x0 = x1;
+    x1 = x2;
+    x2 = c;
+    f0 = f1;
+    f1 = f2;
+    f2 = fc;
+    update_bracket(c, fc, &a, &b, &fa, &fb);
+  }
+
+  // Step 4: The only way to get here is if we have exceeded the maximum number
+  //         of iterations allowed.
+  return set_best(r, roots_error_max_iter, a, b, fa, fb);
+}
@@ -0,0 +1,130 @@
+#include <float.h>
+
+#include "roots.h"
+#include "utils.h"
+
+/*
+ * Function   : roots_multipoint
+ * Author     : Leo Werneck
+ *
+ * Find the root of f(x) in the interval [a,b] using an optimal fourth-order
+ * derivative-free multipoint method, safeguarded by bisection.
+ *
+ * Each iteration takes a Steffensen step from b to y using the auxiliary
+ * point w (see roots_steffensen.c), followed by a Newton step from y in which
+ * f'(y) is replaced by the derivative at y of the parabola through b, w, and
+ * y, i.e., f[b,y] + f[y,w] - f[b,w]. The method converges with order four
+ * using three function evaluations per iteration, which is optimal in the
+ * sense of the Kung-Traub conjecture (efficiency index 4^(1/3) ~ 1.587). All
+ * intermediate points that fall inside the bracket are used to shrink it.
+ *
+ * Parameters : f        - Function for which the root is computed.
+ *            : fparams  - Object containing all parameters needed by the
+ *                         function f other than the variable x.
+ *            : a        - Lower limit of the initial interval.
+ *            : b        - Upper limit of the initial interval.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         The root is stored in r->root.
+ *
+ * Returns    : One the following error keys:
+ *                 - roots_success if the root is found
+ *                 - roots_error_root_not_bracketed if the interval [a,b]
+ *                   does not bracket a root of f(x)
+ *                 - roots_error_max_iter if the maximum allowed number of
+ *                   iterations is exceeded
+ *                 - roots_error_max_evals if the maximum allowed number of
+ *                   function evaluations is exceeded
+ *                 - roots_error_deadline if the deadline has passed
+ *
+ * References : Kung & Traub, J. ACM 21, 643 (1974)
+ *            : Zheng, Li & Huang, Appl. Math. Comput. 217, 9592 (2011)
+ */
+roots_error_t roots_multipoint(
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      double a,
+      double b,
+      roots_params *restrict r) {
+
+  // Step 0: Set basic info to the roots_params struct
+  sprintf(r->method, "Multipoint (4th order)");
+  r->a = a;
+  r->b = b;
+
+  // Step 1: Check whether a or b is the root; compute fa and fb
+  double fa, fb;
+  if(check_a_b_compute_fa_fb(f, fparams, &a, &b, &fa, &fb, r) >= roots_success) {
+    return r->error_key;
+  }
+
+  // Step 2: Declare auxiliary variables
+  double d = b - a;
+  double e = d;
+
+  // Step 3: Multipoint algorithm
+  for(r->n_iters = 1; r->n_iters <= r->max_iters; r->n_iters++) {
+
+    // Step 3.a: Set the tolerance for this iteration
+    const double tol = 2 * DBL_EPSILON * fabs(b) + 0.5 * r->tol;
+
+    // Step 3.b: Check for convergence
+    if(fabs(a - b) < 2 * tol || fb == 0.0) {
+      return set_root(r, roots_success, b, fb, a, b);
+    }
+
+    // Step 3.c: Compute the auxiliary point w, which is always inside [a,b].
+    //           Keep it at least tol away from b, otherwise f[b,w] is
+    //           dominated by roundoff once b is close to the root.
+    const double x = b;
+    const double fx = fb;
+    double w = x - fx * (b - a) / (fb - fa);
+    if(fabs(w - x) < tol) {
+      w = x + (a > x ? tol : -tol);
+    }
+    if(budget_exhausted(r, a, b, fa, fb)) {
+      return r->error_key;
+    }
+    const double fw = evaluate(f, fparams, w, r);
+    const double fxw = (fw - fx) / (w - x);
+    if(is_inside(w, a, b)) {
+      update_bracket(w, fw, &a, &b, &fa, &fb);
+    }
+
+    // Step 3.d: Steffensen step to y. If y is not usable, hand it over to the
+    //           safeguard, which will bisect.
+    const double y = x - fx / fxw;
+    double s = y;
+    if(fb != 0.0 && isfinite(y) && is_inside(y, a, b)) {
+      if(budget_exhausted(r, a, b, fa, fb)) {
+        return r->error_key;
+      }
+      const double fy = evaluate(f, fparams, y, r);
+      update_bracket(y, fy, &a, &b, &fa, &fb);
+
+      // Step 3.e: Newton step from y using the derivative of the parabola
+      //           through x, w, and y.
+      const double fxy = (fy - fx) / (y - x);
+      const double fyw = (fw - fy) / (w - y);
+      s = y - fy / (fxy + fyw - fxw);
+    }
+
+    // Step 3.f: Check whether the intermediate points led to convergence
+    if(fabs(a - b) < 2 * tol || fb == 0.0) {
+      return set_root(r, roots_success, b, fb, a, b);
+    }
+
+    // Step 3.g: Safeguard the step and compute the function at the new point
+    const double c = safeguard(a, b, s, tol, &d, &e);
+    if(budget_exhausted(r, a, b, fa, fb)) {
+      return r->error_key;
+    }
+    const double fc = evaluate(f, fparams, c, r);
+
+    // Step 3.h: Update the bracket
+    update_bracket(c, fc, &a, &b, &fa, &fb);
+  }
+
+  // Step 4: The only way to get here is if we have exceeded the maximum number
+  //         of iterations allowed.
+  return set_best(r, roots_error_max_iter, a, b, fa, fb);
+}
@@ -0,0 +1,131 @@
+#include <float.h>
+
+#include "roots.h"
+#include "utils.h"
+
+// Lets the bracketing logic, which works with functions returning doubles,
+// evaluate a dual function; the points and derivatives of the last two
+// evaluations are kept, so that those at both initial end points are known.
+typedef struct {
+  roots_dual_function f;
+  void *fparams;
+  unsigned n;
+  double x[2], dfdx[2];
+} dual_params;
+
+static double dual_value(const double x, void *restrict params) {
+  dual_params *p = (dual_params *)params;
+  const roots_dual y = p->f(roots_dual_var(x), p->fparams);
+  const unsigned k = p->n++ & 1;
+  p->x[k] = x;
+  p->dfdx[k] = y.d;
+  return y.v;
+}
+
+// Derivative at x if it is one of the last two points evaluated, else NAN
+static double dual_derivative(const dual_params *p, const double x) {
+  for(unsigned k = 0; k < 2 && k < p->n; k++) {
+    if(p->x[k] == x) {
+      return p->dfdx[k];
+    }
+  }
+  return NAN;
+}
+
+/*
+ * Function   : roots_newton
+ * Author     : Leo Werneck
+ *
+ * Find the root of f(x) in the interval [a,b] using Newton's method,
+ * safeguarded by bisection.
+ *
+ * The function is written with dual numbers (see roots_dual.h), so that every
+ * evaluation gives f(x) and f'(x) at once. Newton steps are taken from the
+ * best end point of the bracket, and are rejected in favor of bisection when
+ * they leave the bracket or do not shrink fast enough (see safeguard). The
+ * method converges quadratically using one (dual) function evaluation per
+ * iteration.
+ *
+ * Parameters : f        - Function for which the root is computed, which
+ *                         returns f(x) and f'(x) (see roots_dual_function).
+ *            : fparams  - Object containing all parameters needed by the
+ *                         function f other than the variable x.
+ *            : a        - Lower limit of the initial interval.
+ *            : b        - Upper limit of the initial interval.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         The root is stored in r->root.
+ *
+ * Returns    : One the following error keys:
+ *                 - roots_success if the root is found
+ *                 - roots_error_root_not_bracketed if the interval [a,b]
+ *                   does not bracket a root of f(x)
+ *                 - roots_error_max_iter if the maximum allowed number of
+ *                   iterations is exceeded
+ *                 - roots_error_max_evals if the maximum allowed number of
+ *                   function evaluations is exceeded
+ *                 - roots_error_deadline if the deadline has passed
+ *
+ * References : https://en.wikipedia.org/wiki/Newton%27s_method
+ *              https://en.wikipedia.org/wiki/Automatic_differentiation
+ */
+roots_error_t roots_newton(
+      roots_dual_function f,
+      void *restrict fparams,
+      double a,
+      double b,
+      roots_params *restrict r) {
+
+  // Step 0: Set basic info to the roots_params struct
+  sprintf(r->method, "Newton's");
+  r->a = a;
+  r->b = b;
+
+  // Step 1: Check whether a or b is the root; compute fa and fb, and f' at
+  //         both, so that the first Newton step is taken from the better one
+  dual_params p = { f, fparams, 0, { NAN, NAN }, { NAN, NAN } };
+  double fa, fb;
+  if(check_a_b_compute_fa_fb(dual_value, &p, &a, &b, &fa, &fb, r) >= roots_success) {
+    return r->error_key;
+  }
+
+  // Step 2: Declare auxiliary variables. Unknown derivatives are NAN, which
+  //         makes the safeguard bisect.
+  double dfa = dual_derivative(&p, a);
+  double dfb = dual_derivative(&p, b);
+  double d = b - a;
+  double e = d;
+
+  // Step 3: Newton's algorithm
+  for(r->n_iters = 1; r->n_iters <= r->max_iters; r->n_iters++) {
+
+    // Step 3.a: Set the tolerance for this iteration
+    const double tol = 2 * DBL_EPSILON * fabs(b) + 0.5 * r->tol;
+
+    // Step 3.b: Check for convergence; the derivative at the root is known
+    if(fabs(a - b) < 2 * tol || fb == 0.0) {
+      set_root(r, roots_success, b, fb, a, b);
+      if(isfinite(dfb)) {
+        r->dfdx = dfb;
+      }
+      return r->error_key;
+    }
+
+    // Step 3.c: Newton step from b; safeguard it
+    const double c = safeguard(a, b, b - fb / dfb, tol, &d, &e);
+    if(budget_exhausted(r, a, b, fa, fb)) {
+      return r->error_key;
+    }
+    const double fc = evaluate(dual_value, &p, c, r);
+    const double dfc = dual_derivative(&p, c);
+
+    // Step 3.d: Update the bracket and the derivatives at its end points
+    const double a_old = a, b_old = b, dfa_old = dfa, dfb_old = dfb;
+    update_bracket(c, fc, &a, &b, &fa, &fb);
+    dfa = a == c ? dfc : (a == a_old ? dfa_old : dfb_old);
+    dfb = b == c ? dfc : (b == b_old ? dfb_old : dfa_old);
+  }
+
+  // Step 4: The only way to get here is if we have exceeded the maximum number
+  //         of iterations allowed.
+  return set_best(r, roots_error_max_iter, a, b, fa, fb);
+}
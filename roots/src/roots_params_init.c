@@ -0,0 +1,34 @@
+#include <string.h>
+
+#include "roots.h"
+
+/*
+ * Function   : roots_params_init
+ * Author     : Leo Werneck
+ *
+ * Sets up a roots_params struct with all optional inputs disabled: no limit
+ * on the number of function evaluations, no deadline, linear bisection, no
+ * trace, and no estimate of f'(root). The optional inputs are only used if the
+ * struct is set up this way (see roots.h), so this must be called before
+ * setting any of them, e.g.,
+ *
+ *   roots_params r;
+ *   roots_params_init(&r);
+ *   r.max_iters = 100;
+ *   r.tol = 1e-12;
+ *   r.max_evals = 20;
+ *
+ * Parameters : r        - Pointer to roots library parameters (see roots.h).
+ *
+ * Returns    : Nothing.
+ */
+void roots_params_init(roots_params *restrict r) {
+
+  memset(r, 0, sizeof(*r));
+  r->bisect = roots_bisect_linear;
+  r->trace = NULL;
+  r->recent = NULL;
+  r->multiplicity = 1;
+  r->dfdx = NAN;
+  r->init = ROOTS_PARAMS_INIT;
+}
@@ -0,0 +1,187 @@
+#include <string.h>
+
+#include "roots.h"
+
+// Scratch areas are aligned to, and their sizes rounded up to multiples of,
+// this many bytes, so that the areas of concurrent tasks share no cache lines
+#define SCRATCH_ALIGN 64
+
+// Problems solved by roots_solve_prepared_batch are split into at most this
+// many tasks, each with its own scratch area
+#define MAX_TASKS 64
+
+/*
+ * Function   : roots_solve_prepared
+ * Author     : Leo Werneck
+ *
+ * Find the root of f(x) in the interval [a,b] using the given method, where f
+ * is given in two phases (see roots_prepared_function): prepare is called
+ * once, before the solve, and the method evaluates f with eval. The scratch
+ * area is on the stack, so it should be small (a few KiB at most).
+ *
+ * Parameters : method   - Root-finding method, e.g., roots_brent.
+ *            : pf       - Function in two phases.
+ *            : params   - Parameters of the problem, passed to prepare.
+ *            : a        - Lower limit of the initial interval.
+ *            : b        - Upper limit of the initial interval.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         The root is stored in r->root.
+ *
+ * Returns    : The error key returned by the method.
+ */
+roots_error_t roots_solve_prepared(
+      roots_method method,
+      const roots_prepared_function *restrict pf,
+      const void *restrict params,
+      const double a,
+      const double b,
+      roots_params *restrict r) {
+
+  unsigned char scratch[pf->scratch_size ? pf->scratch_size : 1]
+        __attribute__((aligned(SCRATCH_ALIGN)));
+  pf->prepare(params, scratch);
+  return method(pf->eval, scratch, a, b, r);
+}
+
+typedef struct {
+  roots_method method;
+  const roots_prepared_function *pf;
+  const char *params;
+  size_t stride, slot_size;
+  unsigned n, n_tasks;
+  const double *a, *b;
+  double *root;
+  unsigned char *scratch;
+  roots_params tmpl;
+  struct {
+    unsigned n_iters, n_evals;
+    roots_error_t key;
+  } *results;
+} prepared_batch;
+
+/*
+ * Function   : prepared_task
+ * Author     : Leo Werneck
+ *
+ * Solves one slice of the problems of roots_solve_prepared_batch, reusing
+ * the scratch area of the task for all of them. Run by the thread pool.
+ *
+ * Parameters : t        - Task index.
+ *            : arg      - Pointer to a prepared_batch struct.
+ *
+ * Returns    : Nothing.
+ */
+static void prepared_task(const unsigned t, void *restrict arg) {
+
+  prepared_batch *ctx = (prepared_batch *)arg;
+  const unsigned slice = (ctx->n + ctx->n_tasks - 1) / ctx->n_tasks;
+  const unsigned i0 = t * slice < ctx->n ? t * slice : ctx->n;
+  const unsigned i1 = i0 + slice < ctx->n ? i0 + slice : ctx->n;
+  void *scratch = ctx->scratch + t * ctx->slot_size;
+  roots_params r = ctx->tmpl;
+  unsigned n_iters = 0, n_evals = 0;
+  roots_error_t key = roots_success;
+  for(unsigned i = i0; i < i1; i++) {
+    ctx->pf->prepare(ctx->params + i * ctx->stride, scratch);
+    const roots_error_t k
+          = ctx->method(ctx->pf->eval, scratch, ctx->a[i], ctx->b[i], &r);
+    ctx->root[i] = k == roots_error_root_not_bracketed ? NAN : r.root;
+    n_iters += r.n_iters;
+    n_evals += r.n_evals;
+    if(key == roots_success) {
+      key = k;
+    }
+  }
+  ctx->results[t].n_iters = n_iters;
+  ctx->results[t].n_evals = n_evals;
+  ctx->results[t].key = key;
+}
+
+/*
+ * Function   : roots_solve_prepared_batch
+ * Author     : Leo Werneck
+ *
+ * Solves n independent problems f(x; p_i) = 0, x in [a_i,b_i], with the given
+ * method, where f is given in two phases (see roots_prepared_function). The
+ * problems are split into slices solved by the thread pool, and each slice
+ * owns a scratch area, carved from a single allocation, which is prepared
+ * once per problem and reused by all problems of the slice.
+ *
+ * Parameters : method   - Root-finding method, e.g., roots_brent.
+ *            : pf       - Function in two phases.
+ *            : params   - Parameters of the problems; those of problem i
+ *                         start stride * i bytes after params.
+ *            : stride   - Distance, in bytes, between the parameters of
+ *                         consecutive problems.
+ *            : n        - Number of problems.
+ *            : a        - Lower limits of the initial intervals.
+ *            : b        - Upper limits of the initial intervals.
+ *            : root     - Roots (output); NAN if the initial interval does
+ *                         not bracket a root.
+ *            : pool     - Thread pool (see roots_thread_pool_create). If
+ *                         NULL, the problems are solved sequentially.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         The tolerance and limits apply to each problem;
+ *                         on output, r->n_iters and r->n_evals are the totals
+ *                         over all problems. With a thread pool, r->trace
+ *                         and r->recent are not used.
+ *
+ * Returns    : roots_success if all problems are solved, roots_error_alloc if
+ *              memory cannot be allocated, and otherwise the error key of
+ *              the first problem that is not solved.
+ */
+roots_error_t roots_solve_prepared_batch(
+      roots_method method,
+      const roots_prepared_function *restrict pf,
+      const void *restrict params,
+      const size_t stride,
+      const unsigned n,
+      const double *restrict a,
+      const double *restrict b,
+      double *restrict root,
+      roots_thread_pool *pool,
+      roots_params *restrict r) {
+
+  // Step 1: Set up the tasks; allocate their scratch areas at once
+  prepared_batch ctx;
+  ctx.method = method;
+  ctx.pf = pf;
+  ctx.params = (const char *)params;
+  ctx.stride = stride;
+  ctx.slot_size = (pf->scratch_size + SCRATCH_ALIGN - 1) / SCRATCH_ALIGN * SCRATCH_ALIGN;
+  ctx.n = n;
+  ctx.n_tasks = n < MAX_TASKS ? n : MAX_TASKS;
+  ctx.a = a;
+  ctx.b = b;
+  ctx.root = root;
+  ctx.tmpl = *r;
+  if(pool) {
+    ctx.tmpl.trace = NULL;
+    ctx.tmpl.recent = NULL;
+  }
+  r->n_iters = r->n_evals = 0;
+  unsigned char *buf = malloc(ctx.slot_size * ctx.n_tasks + SCRATCH_ALIGN);
+  ctx.results = malloc(sizeof(*ctx.results) * MAX_TASKS);
+  if(!buf || !ctx.results) {
+    free(buf);
+    free(ctx.results);
+    return (r->error_key = roots_error_alloc);
+  }
+  ctx.scratch = buf + (SCRATCH_ALIGN - (uintptr_t)buf % SCRATCH_ALIGN) % SCRATCH_ALIGN;
+
+  // Step 2: Solve all problems
+  roots_thread_pool_run(pool, ctx.n_tasks, prepared_task, &ctx);
+
+  // Step 3: Gather the counters and the first error, then free memory
+  r->error_key = roots_success;
+  for(unsigned t = 0; t < ctx.n_tasks; t++) {
+    r->n_iters += ctx.results[t].n_iters;
+    r->n_evals += ctx.results[t].n_evals;
+    if(r->error_key == roots_success) {
+      r->error_key = ctx.results[t].key;
+    }
+  }
+  free(buf);
+  free(ctx.results);
+  return r->error_key;
+}
@@ -21,6 +21,9 @@
  *                   does not bracket a root of f(x)
  *                 - roots_error_max_iter if the maximum allowed number of
  *                   iterations is exceeded
+ *                 - roots_error_max_evals if the maximum allowed number of
+ *                   function evaluations is exceeded
+ *                 - roots_error_deadline if the deadline has passed
  *
  * References : https://en.wikipedia.org/wiki/Ridders%27_method
  */
@@ -42,33 +45,41 @@ roots_error_t roots_ridder(
     return r->error_key;
   }
 
-  // Step 2: False-position algorithm
+  // Step 2: Ridder's algorithm
   for(r->n_iters = 1; r->n_iters <= r->max_iters; r->n_iters++) {
 
-    // Step 2.a: Compute the midpoint
+    // Step 2.a: Check whether we can afford another function evaluation
+    if(budget_exhausted(r, a, b, fa, fb)) {
+      return r->error_key;
+    }
+
+    // Step 2.b: Compute the midpoint
     const double m = (a + b) / 2;
-    const double fm = f(m, fparams);
+    const double fm = evaluate(f, fparams, m, r);
 
-    // Step 2.b: Check for convergence
+    // Step 2.c: Check for convergence
     if(fabs(m - a) < r->tol || fm == 0.0) {
-      r->root = m;
-      r->residual = fm;
-      return (r->error_key = roots_success);
+      return set_root(r, roots_success, m, fm, a, m);
+    }
+
+    // Step 2.d: Check whether we can afford another function evaluation. The
+    //           midpoint is used to halve the interval if we cannot.
+    if(fa * fm < 0 ? budget_exhausted(r, a, m, fa, fm)
+                   : budget_exhausted(r, m, b, fm, fb)) {
+      return r->error_key;
     }
 
-    // Step 2.c: Compute new point
+    // Step 2.e: Compute new point
     const double d = sqrt(fm * fm - fa * fb);
     const double c = m + (m - a) * sign(fa - fb) * fm / d;
-    const double fc = f(c, fparams);
+    const double fc = evaluate(f, fparams, c, r);
 
-    // Step 2.d: Check for convergence
+    // Step 2.f: Check for convergence
     if(fabs(c - b) < r->tol || fc == 0.0) {
-      r->root = c;
-      r->residual = fc;
-      return (r->error_key = roots_success);
+      return set_root(r, roots_success, c, fc, c, b);
     }
 
-    // Step 2.e: Adjust the interval
+    // Step 2.g: Adjust the interval
     if(fm * fc < 0) {
       a = m;
       b = c;
@@ -84,11 +95,11 @@ roots_error_t roots_ridder(
       fb = fc;
     }
 
-    // Step 2.f: Ensure the best guess for the root is in b
+    // Step 2.h: Ensure the best guess for the root is in b
     ensure_b_is_closest_to_root(&a, &b, &fa, &fb);
   }
 
   // Step 3: The only way to get here is if we have exceeded the maximum number
   //         of iterations allowed.
-  return (r->error_key = roots_error_max_iter);
+  return set_best(r, roots_error_max_iter, a, b, fa, fb);
 }
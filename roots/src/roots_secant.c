@@ -21,6 +21,9 @@
  *                   does not bracket a root of f(x)
  *                 - roots_error_max_iter if the maximum allowed number of
  *                   iterations is exceeded
+ *                 - roots_error_max_evals if the maximum allowed number of
+ *                   function evaluations is exceeded
+ *                 - roots_error_deadline if the deadline has passed
  *
  * References : https://en.wikipedia.org/wiki/Secant_method
  */
@@ -42,20 +45,39 @@ roots_error_t roots_secant(
     return r->error_key;
   }
 
-  // Step 2: Secant algorithm
+  // Step 2: Secant algorithm. Near multiple roots the secant line is drawn
+  //         through the deflated function values (see track_root).
+  iterates it = { 0 };
   for(r->n_iters = 1; r->n_iters <= r->max_iters; r->n_iters++) {
-    // Step 2.a: Compute the new point
-    const double c = (a * fb - b * fa) / (fb - fa);
-    const double fc = f(c, fparams);
+    // Step 2.a: Check whether we can afford another function evaluation
+    if(budget_exhausted(r, a, b, fa, fb)) {
+      return r->error_key;
+    }
+
+    // Step 2.b: Compute the new point. The deflated step is only taken if it
+    //           goes the same way as the plain secant step and is at most 2m
+    //           times as long as the last step, m being the multiplicity.
+    double c = (a * fb - b * fa) / (fb - fa);
+    bool deflated = false;
+    if(r->multiplicity > 1) {
+      const double ga = deflate(fa, r->multiplicity);
+      const double gb = deflate(fb, r->multiplicity);
+      const double s = (a * gb - b * ga) / (gb - ga);
+      if(isfinite(s) && (s - b) * (c - b) > 0
+         && fabs(s - b) <= 2 * r->multiplicity * fabs(b - a)) {
+        c = s;
+        deflated = true;
+      }
+    }
+    const double fc = evaluate(f, fparams, c, r);
+    track_root(&it, c, fc, deflated, r);
 
-    // Step 2.b: Check for convergence
+    // Step 2.c: Check for convergence
     if(fabs(c - b) < r->tol || fc == 0.0) {
-      r->root = c;
-      r->residual = fc;
-      return (r->error_key = roots_success);
+      return set_root(r, roots_success, c, fc, b, c);
     }
 
-    // Step 2.c: Cicle the values: a <- b <- c and fa <- fb <- fc
+    // Step 2.d: Cicle the values: a <- b <- c and fa <- fb <- fc
     a = b;
     b = c;
     fa = fb;
@@ -64,5 +86,5 @@ roots_error_t roots_secant(
 
   // Step 3: The only way to get here is if we have exceeded the maximum number
   //         of iterations allowed.
-  return (r->error_key = roots_error_max_iter);
+  return set_best(r, roots_error_max_iter, a, b, fa, fb);
 }
@@ -0,0 +1,116 @@
+#include <float.h>
+
+#include "roots.h"
+
+/*
+ * Function   : roots_sensitivity
+ * Author     : Leo Werneck
+ *
+ * Computes the derivatives of the root x*(p) of f(x; p) with respect to the
+ * parameters p_i of f, using the implicit function theorem:
+ *
+ *   d(x*)/dp_i = -(df/dp_i) / (df/dx), evaluated at x = x*.
+ *
+ * The derivative df/dx is r->dfdx, which every method estimates at no extra
+ * evaluations from its last evaluations of f if r->recent is set (Newton's
+ * method has it exactly); the relative error is typically 1e-8 or smaller,
+ * about 1e-5 for Ridder's method. The fixed-iteration Ridder's and
+ * Chandrupatla's methods keep evaluating f at the root once they have
+ * converged, which leaves r->dfdx NAN. If f' is known, r->dfdx can be
+ * overwritten before calling this function. This replaces the solves with
+ * perturbed parameters otherwise needed to compute d(x*)/dp by finite
+ * differences.
+ *
+ * Parameters : r        - Pointer to roots library parameters (see roots.h),
+ *                         as returned by a root-finding method.
+ *            : dfdp     - Function computing df/dp_i at x (see
+ *                         roots_parameter_gradient).
+ *            : fparams  - Object containing the parameters of f.
+ *            : n        - Number of parameters.
+ *            : dxdp     - Derivatives d(x*)/dp_i (output).
+ *
+ * Returns    : Nothing.
+ */
+void roots_sensitivity(
+      const roots_params *restrict r,
+      roots_parameter_gradient dfdp,
+      void *restrict fparams,
+      const unsigned n,
+      double *restrict dxdp) {
+
+  dfdp(r->root, fparams, n, dxdp);
+  for(unsigned i = 0; i < n; i++) {
+    dxdp[i] = -dxdp[i] / r->dfdx;
+  }
+}
+
+/*
+ * Function   : roots_sensitivity_batch
+ * Author     : Leo Werneck
+ *
+ * Same as roots_sensitivity for the roots of n independent problems
+ * f_i(x; p_i) = 0, with one parameter per problem, e.g., as solved by
+ * roots_chandrupatla_batch. The batch methods only keep brackets of the size
+ * of the tolerance, which are too narrow to estimate f'; unless dfdx is
+ * given, f' is computed by central differences, with steps
+ * eps^(1/3) max(|x|,1), at the cost of two calls to fv.
+ *
+ * Parameters : fv       - Vectorized function, fx[i] = f_i(x[i]).
+ *            : dfdx     - Vectorized derivative of f with respect to x, or
+ *                         NULL.
+ *            : dfdp     - Vectorized derivative of f with respect to the
+ *                         parameter, dfdp[i] = df_i/dp_i at x[i].
+ *            : fparams  - Object containing the parameters of fv, dfdx, and
+ *                         dfdp.
+ *            : n        - Number of problems.
+ *            : root     - Roots.
+ *            : dxdp     - Derivatives d(x*_i)/dp_i (output); NAN if memory
+ *                         cannot be allocated.
+ *
+ * Returns    : Nothing.
+ */
+void roots_sensitivity_batch(
+      roots_vector_function fv,
+      roots_vector_function dfdx,
+      roots_vector_function dfdp,
+      void *restrict fparams,
+      const unsigned n,
+      const double *restrict root,
+      double *restrict dxdp) {
+
+  // Step 1: Compute f' at the roots
+  if(!n) {
+    return;
+  }
+  double *buf = malloc(sizeof(double) * 4 * n);
+  if(!buf) {
+    for(unsigned i = 0; i < n; i++) {
+      dxdp[i] = NAN;
+    }
+    return;
+  }
+  double *df = buf, *x = buf + n, *fp = buf + 2 * n, *fm = buf + 3 * n;
+  if(dfdx) {
+    dfdx(n, root, fparams, df);
+  }
+  else {
+    double *xp = df;
+    for(unsigned i = 0; i < n; i++) {
+      const double h = 6.0554544523933395e-6 * fmax(fabs(root[i]), 1);
+      xp[i] = root[i] + h;
+      x[i] = root[i] - h;
+    }
+    fv(n, xp, fparams, fp);
+    fv(n, x, fparams, fm);
+    for(unsigned i = 0; i < n; i++) {
+      df[i] = (fp[i] - fm[i]) / (xp[i] - x[i]);
+    }
+  }
+
+  // Step 2: Apply the implicit function theorem
+  dfdp(n, root, fparams, dxdp);
+  for(unsigned i = 0; i < n; i++) {
+    dxdp[i] = -dxdp[i] / df[i];
+  }
+  free(buf);
+}
@@ -0,0 +1,384 @@
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+
+#include "roots.h"
+
+// Number of polls of a request before roots_service_wait goes to sleep
+#define SPIN_POLLS 1000
+
+// Cell of the queue: its sequence number tells whether it is free for the
+// producer at position seq or holds the request for the consumer at seq-1.
+typedef struct {
+  uint64_t seq;
+  roots_request *req;
+} queue_cell;
+
+struct roots_service {
+  // Bounded multi-producer multi-consumer queue. The positions of producers
+  // and consumers are kept on separate cache lines.
+  queue_cell *cells;
+  uint64_t mask;
+  char pad0[64];
+  uint64_t head;
+  char pad1[64];
+  uint64_t tail;
+  char pad2[64];
+
+  // Workers; the semaphore counts the requests in the queue
+  pthread_t *threads;
+  unsigned n_threads;
+  sem_t items;
+  bool stop;
+
+  // Sleeping waiters
+  pthread_mutex_t lock;
+  pthread_cond_t completed;
+  unsigned n_waiters;
+
+  // Counters (see roots_service_stats)
+  uint64_t n_submitted, n_completed, n_rejected, max_depth;
+  uint64_t submit_ns, max_submit_ns, wait_ns, busy_ns;
+  double t_create;
+};
+
+static inline uint64_t load(const uint64_t *p) {
+  return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void add(uint64_t *p, const uint64_t v) {
+  __atomic_fetch_add(p, v, __ATOMIC_RELAXED);
+}
+
+static inline void update_max(uint64_t *p, const uint64_t v) {
+  uint64_t m = __atomic_load_n(p, __ATOMIC_RELAXED);
+  while(v > m
+        && !__atomic_compare_exchange_n(
+              p, &m, v, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    ;
+}
+
+/*
+ * Function   : enqueue
+ * Author     : Leo Werneck
+ *
+ * Adds a request to the tail of the queue without locking.
+ *
+ * Parameters : s        - Service.
+ *            : req      - Request.
+ *
+ * Returns    : true on success, false if the queue is full.
+ *
+ * References : D. Vyukov, Bounded MPMC queue (2010),
+ *              https://www.1024cores.net/home/lock-free-algorithms/queues
+ */
+static bool enqueue(roots_service *s, roots_request *req) {
+
+  uint64_t pos = __atomic_load_n(&s->tail, __ATOMIC_RELAXED);
+  while(true) {
+    queue_cell *c = &s->cells[pos & s->mask];
+    const int64_t d = (int64_t)(load(&c->seq) - pos);
+    if(d == 0) {
+      if(__atomic_compare_exchange_n(&s->tail, &pos, pos + 1, true, __ATOMIC_RELAXED,
+                                     __ATOMIC_RELAXED)) {
+        c->req = req;
+        __atomic_store_n(&c->seq, pos + 1, __ATOMIC_RELEASE);
+        return true;
+      }
+    }
+    else if(d < 0) {
+      return false;
+    }
+    else {
+      pos = __atomic_load_n(&s->tail, __ATOMIC_RELAXED);
+    }
+  }
+}
+
+/*
+ * Function   : dequeue
+ * Author     : Leo Werneck
+ *
+ * Removes a request from the head of the queue without locking.
+ *
+ * Parameters : s        - Service.
+ *
+ * Returns    : The request, or NULL if the queue is empty or the request at
+ *              its head is still being added.
+ */
+static roots_request *dequeue(roots_service *s) {
+
+  uint64_t pos = __atomic_load_n(&s->head, __ATOMIC_RELAXED);
+  while(true) {
+    queue_cell *c = &s->cells[pos & s->mask];
+    const int64_t d = (int64_t)(load(&c->seq) - (pos + 1));
+    if(d == 0) {
+      if(__atomic_compare_exchange_n(&s->head, &pos, pos + 1, true, __ATOMIC_RELAXED,
+                                     __ATOMIC_RELAXED)) {
+        roots_request *req = c->req;
+        __atomic_store_n(&c->seq, pos + s->mask + 1, __ATOMIC_RELEASE);
+        return req;
+      }
+    }
+    else if(d < 0) {
+      return NULL;
+    }
+    else {
+      pos = __atomic_load_n(&s->head, __ATOMIC_RELAXED);
+    }
+  }
+}
+
+/*
+ * Function   : worker
+ * Author     : Leo Werneck
+ *
+ * Main loop of the worker threads: takes requests from the queue and solves
+ * them until the service is destroyed and the queue is empty.
+ *
+ * Parameters : arg      - Service.
+ *
+ * Returns    : NULL.
+ */
+static void *worker(void *arg) {
+
+  roots_service *s = (roots_service *)arg;
+  while(true) {
+
+    // Step 1: Wait for a request. Every request posts the semaphore once
+    //         after being added, so one is in the queue or about to be,
+    //         unless the service is being destroyed.
+    while(sem_wait(&s->items))
+      ;
+    roots_request *req;
+    while(!(req = dequeue(s))) {
+      if(__atomic_load_n(&s->stop, __ATOMIC_ACQUIRE)) {
+        return NULL;
+      }
+      sched_yield();
+    }
+
+    // Step 2: Solve
+    const double t0 = roots_monotonic_time();
+    add(&s->wait_ns, 1e9 * (t0 - req->t_submit));
+    req->method(req->f, req->fparams, req->a, req->b, &req->r);
+    add(&s->busy_ns, 1e9 * (roots_monotonic_time() - t0));
+    __atomic_fetch_add(&s->n_completed, 1, __ATOMIC_RELEASE);
+
+    // Step 3: Complete the request; wake up sleeping waiters, if any. The
+    //         callback may free the request, so it is not touched afterwards.
+    void (*callback)(roots_request *, void *) = req->callback;
+    void *callback_arg = req->callback_arg;
+    __atomic_store_n(&req->done, true, __ATOMIC_SEQ_CST);
+    if(__atomic_load_n(&s->n_waiters, __ATOMIC_SEQ_CST)) {
+      pthread_mutex_lock(&s->lock);
+      pthread_cond_broadcast(&s->completed);
+      pthread_mutex_unlock(&s->lock);
+    }
+    if(callback) {
+      callback(req, callback_arg);
+    }
+  }
+}
+
+/*
+ * Function   : roots_service_create
+ * Author     : Leo Werneck
+ *
+ * Creates an asynchronous solver service: requests are submitted from any
+ * thread into a lock-free queue, and a pool of worker threads solves them
+ * with the existing methods.
+ *
+ * Parameters : n_threads     - Number of worker threads (at least one).
+ *            : log2_capacity - Base 2 logarithm of the capacity of the
+ *                              queue, from ROOTS_SERVICE_MIN_LOG2_CAPACITY
+ *                              to ROOTS_SERVICE_MAX_LOG2_CAPACITY (see
+ *                              roots.h). A queue of a single cell cannot
+ *                              tell a full cell from a free one.
+ *
+ * Returns    : Pointer to the service, or NULL on failure or if log2_capacity
+ *              is out of range.
+ */
+roots_service *roots_service_create(
+      const unsigned n_threads,
+      const unsigned log2_capacity) {
+
+  if(log2_capacity < ROOTS_SERVICE_MIN_LOG2_CAPACITY
+     || log2_capacity > ROOTS_SERVICE_MAX_LOG2_CAPACITY) {
+    return NULL;
+  }
+  roots_service *s = calloc(1, sizeof(*s));
+  if(!s || !n_threads) {
+    free(s);
+    return NULL;
+  }
+  const uint64_t capacity = (uint64_t)1 << log2_capacity;
+  s->cells = malloc(sizeof(queue_cell) * capacity);
+  s->threads = malloc(sizeof(pthread_t) * n_threads);
+  if(!s->cells || !s->threads) {
+    free(s->cells);
+    free(s->threads);
+    free(s);
+    return NULL;
+  }
+  for(uint64_t i = 0; i < capacity; i++) {
+    s->cells[i].seq = i;
+  }
+  s->mask = capacity - 1;
+  sem_init(&s->items, 0, 0);
+  pthread_mutex_init(&s->lock, NULL);
+  pthread_cond_init(&s->completed, NULL);
+  s->t_create = roots_monotonic_time();
+  for(unsigned i = 0; i < n_threads; i++) {
+    if(pthread_create(&s->threads[i], NULL, worker, s)) {
+      break;
+    }
+    s->n_threads++;
+  }
+  if(!s->n_threads) {
+    roots_service_destroy(s);
+    return NULL;
+  }
+  return s;
+}
+
+/*
+ * Function   : roots_service_submit
+ * Author     : Leo Werneck
+ *
+ * Submits a request without blocking. The request must stay valid until it
+ * is complete, i.e., until roots_service_done returns true, roots_service_wait
+ * returns, or its callback is called.
+ *
+ * Parameters : s        - Service.
+ *            : req      - Request. The caller sets method, f, fparams, a, b,
+ *                         the tolerance and limits in r, and optionally a
+ *                         completion callback, which is called on a worker
+ *                         thread once req->r holds the results.
+ *
+ * Returns    : true if the request is queued, false if the queue is full.
+ */
+bool roots_service_submit(roots_service *s, roots_request *req) {
+
+  const double t0 = roots_monotonic_time();
+  req->done = false;
+  req->t_submit = t0;
+  // Count the request before queuing it, so that it is never completed
+  // before being counted
+  add(&s->n_submitted, 1);
+  if(!enqueue(s, req)) {
+    __atomic_sub_fetch(&s->n_submitted, 1, __ATOMIC_RELAXED);
+    add(&s->n_rejected, 1);
+    return false;
+  }
+  sem_post(&s->items);
+  const uint64_t n_completed = __atomic_load_n(&s->n_completed, __ATOMIC_ACQUIRE);
+  const uint64_t n_submitted = __atomic_load_n(&s->n_submitted, __ATOMIC_ACQUIRE);
+  update_max(&s->max_depth, n_submitted - n_completed);
+  const uint64_t ns = 1e9 * (roots_monotonic_time() - t0);
+  add(&s->submit_ns, ns);
+  update_max(&s->max_submit_ns, ns);
+  return true;
+}
+
+/*
+ * Function   : roots_service_done
+ * Author     : Leo Werneck
+ *
+ * Checks whether a request is complete, without blocking.
+ *
+ * Parameters : req      - Request.
+ *
+ * Returns    : true if req->r holds the results, false otherwise.
+ */
+bool roots_service_done(const roots_request *req) {
+  return __atomic_load_n(&req->done, __ATOMIC_ACQUIRE);
+}
+
+/*
+ * Function   : roots_service_wait
+ * Author     : Leo Werneck
+ *
+ * Waits for a request to complete: polls it for a while, then sleeps until
+ * a worker completes a request.
+ *
+ * Parameters : s        - Service.
+ *            : req      - Request (must not have a callback that frees it).
+ *
+ * Returns    : The error key returned by the method.
+ */
+roots_error_t roots_service_wait(roots_service *s, roots_request *req) {
+
+  for(int i = 0; i < SPIN_POLLS && !roots_service_done(req); i++) {
+    sched_yield();
+  }
+  if(!roots_service_done(req)) {
+    pthread_mutex_lock(&s->lock);
+    __atomic_add_fetch(&s->n_waiters, 1, __ATOMIC_SEQ_CST);
+    while(!__atomic_load_n(&req->done, __ATOMIC_SEQ_CST)) {
+      pthread_cond_wait(&s->completed, &s->lock);
+    }
+    __atomic_sub_fetch(&s->n_waiters, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&s->lock);
+  }
+  return req->r.error_key;
+}
+
+/*
+ * Function   : roots_service_get_stats
+ * Author     : Leo Werneck
+ *
+ * Reads the counters of the service (see roots_service_stats in roots.h).
+ *
+ * Parameters : s        - Service.
+ *            : st       - Counters (output).
+ *
+ * Returns    : Nothing.
+ */
+void roots_service_get_stats(roots_service *s, roots_service_stats *st) {
+
+  const double elapsed = roots_monotonic_time() - s->t_create;
+  st->n_submitted = __atomic_load_n(&s->n_submitted, __ATOMIC_RELAXED);
+  st->n_completed = __atomic_load_n(&s->n_completed, __ATOMIC_RELAXED);
+  st->n_rejected = __atomic_load_n(&s->n_rejected, __ATOMIC_RELAXED);
+  st->queue_depth = st->n_submitted - st->n_completed;
+  st->max_queue_depth = __atomic_load_n(&s->max_depth, __ATOMIC_RELAXED);
+  const uint64_t submit_ns = __atomic_load_n(&s->submit_ns, __ATOMIC_RELAXED);
+  const uint64_t wait_ns = __atomic_load_n(&s->wait_ns, __ATOMIC_RELAXED);
+  st->mean_submit_latency = st->n_submitted ? 1e-9 * submit_ns / st->n_submitted : 0;
+  st->max_submit_latency = 1e-9 * __atomic_load_n(&s->max_submit_ns, __ATOMIC_RELAXED);
+  st->mean_queue_wait = st->n_completed ? 1e-9 * wait_ns / st->n_completed : 0;
+  st->utilization = 1e-9 * __atomic_load_n(&s->busy_ns, __ATOMIC_RELAXED)
+                    / (s->n_threads * (elapsed > 0 ? elapsed : 1));
+}
+
+/*
+ * Function   : roots_service_destroy
+ * Author     : Leo Werneck
+ *
+ * Solves all queued requests, then stops the workers and frees the service.
+ * No requests may be submitted during or after the call.
+ *
+ * Parameters : s        - Service.
+ *
+ * Returns    : Nothing.
+ */
+void roots_service_destroy(roots_service *s) {
+
+  if(!s) {
+    return;
+  }
+  __atomic_store_n(&s->stop, true, __ATOMIC_RELEASE);
+  for(unsigned i = 0; i < s->n_threads; i++) {
+    sem_post(&s->items);
+  }
+  for(unsigned i = 0; i < s->n_threads; i++) {
+    pthread_join(s->threads[i], NULL);
+  }
+  sem_destroy(&s->items);
+  pthread_mutex_destroy(&s->lock);
+  pthread_cond_destroy(&s->completed);
+  free(s->threads);
+  free(s->cells);
+  free(s);
+}
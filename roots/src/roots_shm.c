@@ -0,0 +1,616 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "roots.h"
+
+#define SHM_MAGIC "ROOTSS1"
+#define ALIGN64(n) (((n) + 63) / 64 * 64)
+
+// States of a batch slot. Free and filling slots belong to the client,
+// submitted and running slots to the server, and done slots are read by the
+// client until it releases them.
+enum { slot_free, slot_filling, slot_submitted, slot_running, slot_done };
+
+// Header of a batch slot; the arrays of the problems follow it (see
+// slot_arrays)
+typedef struct {
+  uint32_t state;
+  uint32_t n;
+  int32_t error_key;
+  uint32_t n_evals;
+} __attribute__((aligned(64))) shm_slot;
+
+// Entry of a client. The counters are updated by the server.
+typedef struct {
+  uint32_t in_use;
+  sem_t done; // Posted once per completed batch
+  uint64_t t_connect_ns;    // Zero if the entry was never used
+  uint64_t t_disconnect_ns; // Zero while the client is connected
+  uint64_t n_batches, n_problems, n_evals, busy_ns;
+} __attribute__((aligned(64))) shm_client;
+
+// Layout of the shared memory: the header, the client entries, and the batch
+// slots of every client. The magic is published last by the server.
+typedef struct {
+  uint64_t magic;
+  int32_t pid; // Process of the server
+  uint32_t n_clients, n_slots, capacity, n_params;
+  uint64_t clients_offset, slots_offset, slot_size;
+  uint32_t stop;
+  uint32_t next_client; // Client whose slots are scanned first
+  sem_t work;           // Counts the submitted batches
+} shm_header;
+
+struct roots_shm_server {
+  shm_header *h;
+  size_t size;
+  char *path;
+  roots_method method;
+  double (*f)(const double, void *restrict);
+  roots_params tmpl;
+  pthread_t *threads;
+  unsigned n_threads;
+};
+
+struct roots_shm_client {
+  shm_header *h;
+  size_t size;
+  unsigned index;
+  unsigned next; // Slot tried first by roots_shm_acquire
+};
+
+static inline uint64_t shm_magic(void) {
+  uint64_t magic;
+  memcpy(&magic, SHM_MAGIC, sizeof(magic));
+  return magic;
+}
+
+static inline shm_client *client_at(shm_header *h, const unsigned i) {
+  return (shm_client *)((char *)h + h->clients_offset) + i;
+}
+
+static inline shm_slot *slot_at(shm_header *h, const unsigned client, const unsigned k) {
+  return (shm_slot *)((char *)h + h->slots_offset
+                      + ((uint64_t)client * h->n_slots + k) * h->slot_size);
+}
+
+/*
+ * Function   : slot_arrays
+ * Author     : Leo Werneck
+ *
+ * Points a batch to the arrays of a slot: a, b, root, the parameters, and
+ * the error keys, each holding capacity problems.
+ *
+ * Parameters : h        - Header of the shared memory.
+ *            : slot     - Slot.
+ *            : batch    - Batch (output).
+ *
+ * Returns    : Nothing.
+ */
+static void slot_arrays(const shm_header *h, shm_slot *slot, roots_shm_batch *batch) {
+  double *data = (double *)(slot + 1);
+  batch->capacity = h->capacity;
+  batch->a = data;
+  batch->b = data + h->capacity;
+  batch->root = data + 2 * h->capacity;
+  batch->params = data + 3 * h->capacity;
+  batch->error_key
+        = (roots_error_t *)(batch->params + (size_t)h->capacity * h->n_params);
+}
+
+/*
+ * Function   : take
+ * Author     : Leo Werneck
+ *
+ * Takes a submitted batch for a worker. The scan starts at a different client
+ * every time, so that the clients are served in turn.
+ *
+ * Parameters : h        - Header of the shared memory.
+ *            : client   - Client of the batch (output).
+ *
+ * Returns    : The slot of the batch, or NULL if no batch is submitted.
+ */
+static shm_slot *take(shm_header *h, unsigned *client) {
+
+  const unsigned first = __atomic_fetch_add(&h->next_client, 1, __ATOMIC_RELAXED);
+  for(unsigned i = 0; i < h->n_clients; i++) {
+    const unsigned c = (first + i) % h->n_clients;
+    for(unsigned k = 0; k < h->n_slots; k++) {
+      shm_slot *slot = slot_at(h, c, k);
+      uint32_t state = slot_submitted;
+      if(__atomic_compare_exchange_n(&slot->state, &state, slot_running, false,
+                                     __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        *client = c;
+        return slot;
+      }
+    }
+  }
+  return NULL;
+}
+
+/*
+ * Function   : worker
+ * Author     : Leo Werneck
+ *
+ * Main loop of the worker threads of the server: takes submitted batches and
+ * solves their problems in place until the server is destroyed and no batch
+ * is left.
+ *
+ * Parameters : arg      - Server.
+ *
+ * Returns    : NULL.
+ */
+static void *worker(void *arg) {
+
+  roots_shm_server *s = (roots_shm_server *)arg;
+  shm_header *h = s->h;
+  roots_params r = s->tmpl;
+  while(true) {
+
+    // Step 1: Wait for a batch. Every batch posts the semaphore once after
+    //         being submitted, so one is available unless the server is
+    //         being destroyed.
+    while(sem_wait(&h->work))
+      ;
+    unsigned c;
+    shm_slot *slot;
+    while(!(slot = take(h, &c))) {
+      if(__atomic_load_n(&h->stop, __ATOMIC_ACQUIRE)) {
+        return NULL;
+      }
+      sched_yield();
+    }
+
+    // Step 2: Solve the problems; roots are NAN if not bracketed
+    const double t0 = roots_monotonic_time();
+    roots_shm_batch batch;
+    slot_arrays(h, slot, &batch);
+    const uint32_t n = slot->n;
+    uint64_t n_evals = 0;
+    roots_error_t key = roots_success;
+    for(uint32_t i = 0; i < n; i++) {
+      double *params = batch.params + (size_t)i * h->n_params;
+      s->method(s->f, params, batch.a[i], batch.b[i], &r);
+      batch.root[i] = r.error_key == roots_error_root_not_bracketed ? NAN : r.root;
+      batch.error_key[i] = r.error_key;
+      n_evals += r.n_evals;
+      if(key == roots_success) {
+        key = r.error_key;
+      }
+    }
+    slot->error_key = key;
+    slot->n_evals = n_evals;
+
+    // Step 3: Update the counters of the client, then hand the batch back
+    shm_client *cl = client_at(h, c);
+    __atomic_fetch_add(&cl->n_batches, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&cl->n_problems, n, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&cl->n_evals, n_evals, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&cl->busy_ns, (uint64_t)(1e9 * (roots_monotonic_time() - t0)),
+                       __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->state, slot_done, __ATOMIC_RELEASE);
+    sem_post(&cl->done);
+  }
+}
+
+/*
+ * Function   : roots_shm_server_create
+ * Author     : Leo Werneck
+ *
+ * Creates a solver server for the processes of one machine. The server owns
+ * a shared-memory file, in which every client (see roots_shm_connect) has a
+ * ring of batch slots; clients write their problems directly into the slots,
+ * and a pool of worker threads solves them in place, so that neither the
+ * problems nor the results are copied. Synchronization uses process-shared
+ * semaphores, so idle workers and waiting clients sleep.
+ *
+ * Parameters : path      - Path to the shared-memory file, preferably in a
+ *                          memory file system, e.g., /dev/shm/roots. An
+ *                          existing file is replaced.
+ *            : n_clients - Maximum number of connected clients.
+ *            : n_slots   - Number of batch slots per client.
+ *            : capacity  - Maximum number of problems per batch.
+ *            : n_params  - Number of parameters (doubles) per problem.
+ *            : n_threads - Number of worker threads (at least one).
+ *            : method    - Root-finding method, e.g., roots_brent.
+ *            : f         - Function for which the roots are computed; its
+ *                          params point to the parameters of the problem.
+ *            : r         - Tolerance and limits applied to every problem.
+ *
+ * Returns    : Pointer to the server, or NULL on failure.
+ */
+roots_shm_server *roots_shm_server_create(
+      const char *path,
+      const unsigned n_clients,
+      const unsigned n_slots,
+      const unsigned capacity,
+      const unsigned n_params,
+      const unsigned n_threads,
+      roots_method method,
+      double f(const double, void *restrict),
+      const roots_params *restrict r) {
+
+  if(!n_clients || !n_slots || !capacity || !n_threads) {
+    return NULL;
+  }
+  roots_shm_server *s = calloc(1, sizeof(*s));
+  if(!s) {
+    return NULL;
+  }
+
+  // Step 1: Create and map the file
+  const uint64_t clients_offset = ALIGN64(sizeof(shm_header));
+  const uint64_t slots_offset
+        = clients_offset + (uint64_t)n_clients * sizeof(shm_client);
+  const uint64_t data_size = (uint64_t)capacity * (3 + n_params) * sizeof(double)
+                             + (uint64_t)capacity * sizeof(roots_error_t);
+  const uint64_t slot_size = sizeof(shm_slot) + ALIGN64(data_size);
+  s->size = slots_offset + (uint64_t)n_clients * n_slots * slot_size;
+  const int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+  if(fd < 0) {
+    free(s);
+    return NULL;
+  }
+  s->h = ftruncate(fd, s->size)
+               ? MAP_FAILED
+               : mmap(NULL, s->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if(s->h == MAP_FAILED) {
+    unlink(path);
+    free(s);
+    return NULL;
+  }
+
+  // Step 2: Initialize the shared memory. Mapped memory is zero, i.e., all
+  //         slots are free. The magic is written last, so that clients do
+  //         not connect to a server that is not ready.
+  shm_header *h = s->h;
+  h->n_clients = n_clients;
+  h->n_slots = n_slots;
+  h->capacity = capacity;
+  h->n_params = n_params;
+  h->clients_offset = clients_offset;
+  h->slots_offset = slots_offset;
+  h->slot_size = slot_size;
+  h->pid = getpid();
+
+  // The semaphore of the work, then those of the clients; on failure, the
+  // ones that were initialized are destroyed
+  unsigned n_sems = 0;
+  while(n_sems <= n_clients
+        && !sem_init(n_sems ? &client_at(h, n_sems - 1)->done : &h->work, 1, 0)) {
+    n_sems++;
+  }
+  if(n_sems <= n_clients) {
+    while(n_sems) {
+      n_sems--;
+      sem_destroy(n_sems ? &client_at(h, n_sems - 1)->done : &h->work);
+    }
+    munmap(s->h, s->size);
+    unlink(path);
+    free(s);
+    return NULL;
+  }
+
+  // Step 3: Start the workers
+  s->path = strdup(path);
+  s->method = method;
+  s->f = f;
+  s->tmpl = *r;
+  s->tmpl.trace = NULL;
+  s->tmpl.recent = NULL;
+  s->threads = malloc(sizeof(pthread_t) * n_threads);
+  for(unsigned i = 0; s->threads && i < n_threads; i++) {
+    if(pthread_create(&s->threads[i], NULL, worker, s)) {
+      break;
+    }
+    s->n_threads++;
+  }
+  if(!s->n_threads || !s->path) {
+    roots_shm_server_destroy(s);
+    return NULL;
+  }
+  __atomic_store_n(&h->magic, shm_magic(), __ATOMIC_RELEASE);
+  return s;
+}
+
+/*
+ * Function   : client_stats
+ * Author     : Leo Werneck
+ *
+ * Reads the counters of a client entry.
+ *
+ * Parameters : h        - Header of the shared memory.
+ *            : client   - Index of the client.
+ *            : st       - Counters (output).
+ *
+ * Returns    : true if the entry was ever used, false otherwise.
+ */
+static bool client_stats(shm_header *h, const unsigned client, roots_shm_stats *st) {
+
+  memset(st, 0, sizeof(*st));
+  if(client >= h->n_clients) {
+    return false;
+  }
+  const shm_client *cl = client_at(h, client);
+  const uint64_t t_connect_ns = __atomic_load_n(&cl->t_connect_ns, __ATOMIC_ACQUIRE);
+  if(!t_connect_ns) {
+    return false;
+  }
+  st->connected = __atomic_load_n(&cl->in_use, __ATOMIC_RELAXED);
+  st->n_batches = __atomic_load_n(&cl->n_batches, __ATOMIC_RELAXED);
+  st->n_problems = __atomic_load_n(&cl->n_problems, __ATOMIC_RELAXED);
+  st->n_evals = __atomic_load_n(&cl->n_evals, __ATOMIC_RELAXED);
+  st->busy = 1e-9 * __atomic_load_n(&cl->busy_ns, __ATOMIC_RELAXED);
+  const uint64_t t_disconnect_ns
+        = __atomic_load_n(&cl->t_disconnect_ns, __ATOMIC_RELAXED);
+  const double t_end = t_disconnect_ns ? 1e-9 * t_disconnect_ns : roots_monotonic_time();
+  const double elapsed = t_end - 1e-9 * t_connect_ns;
+  st->throughput = elapsed > 0 ? st->n_problems / elapsed : 0;
+  return true;
+}
+
+/*
+ * Function   : roots_shm_server_get_stats
+ * Author     : Leo Werneck
+ *
+ * Reads the counters of a client of the server.
+ *
+ * Parameters : s        - Server.
+ *            : client   - Index of the client, from 0 to n_clients - 1.
+ *            : st       - Counters (output, see roots_shm_stats in roots.h).
+ *
+ * Returns    : true if a client has used the entry since the server was
+ *              created, false otherwise.
+ */
+bool roots_shm_server_get_stats(
+      roots_shm_server *s,
+      const unsigned client,
+      roots_shm_stats *st) {
+  return client_stats(s->h, client, st);
+}
+
+/*
+ * Function   : roots_shm_server_destroy
+ * Author     : Leo Werneck
+ *
+ * Solves all submitted batches, then stops the workers, removes the
+ * shared-memory file, and frees the server. Clients may stay mapped, but
+ * must not submit batches during or after the call.
+ *
+ * Parameters : s        - Server (may be NULL).
+ *
+ * Returns    : Nothing.
+ */
+void roots_shm_server_destroy(roots_shm_server *s) {
+
+  if(!s) {
+    return;
+  }
+  __atomic_store_n(&s->h->stop, true, __ATOMIC_RELEASE);
+  for(unsigned i = 0; i < s->n_threads; i++) {
+    sem_post(&s->h->work);
+  }
+  for(unsigned i = 0; i < s->n_threads; i++) {
+    pthread_join(s->threads[i], NULL);
+  }
+  if(s->path) {
+    unlink(s->path);
+  }
+  munmap(s->h, s->size);
+  free(s->threads);
+  free(s->path);
+  free(s);
+}
+
+/*
+ * Function   : roots_shm_connect
+ * Author     : Leo Werneck
+ *
+ * Connects to a solver server (see roots_shm_server_create) as a new client.
+ * A client is used by one thread at a time.
+ *
+ * Parameters : path     - Path to the shared-memory file of the server.
+ *
+ * Returns    : Pointer to the client, or NULL if the server does not exist,
+ *              is not ready, has no free client entry, or left a stale file
+ *              behind (its process is gone).
+ */
+roots_shm_client *roots_shm_connect(const char *path) {
+
+  // Step 1: Map the file and check that the server is ready and alive
+  const int fd = open(path, O_RDWR);
+  struct stat st;
+  if(fd < 0 || fstat(fd, &st) || (size_t)st.st_size < sizeof(shm_header)) {
+    if(fd >= 0) {
+      close(fd);
+    }
+    return NULL;
+  }
+  shm_header *h = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if(h == MAP_FAILED) {
+    return NULL;
+  }
+  if(__atomic_load_n(&h->magic, __ATOMIC_ACQUIRE) != shm_magic()
+     || (kill(h->pid, 0) && errno == ESRCH)) {
+    munmap(h, st.st_size);
+    return NULL;
+  }
+
+  // Step 2: Claim a client entry and reset its counters
+  for(unsigned i = 0; i < h->n_clients; i++) {
+    shm_client *cl = client_at(h, i);
+    uint32_t in_use = false;
+    if(!__atomic_compare_exchange_n(&cl->in_use, &in_use, true, false, __ATOMIC_ACQ_REL,
+                                    __ATOMIC_RELAXED)) {
+      continue;
+    }
+    roots_shm_client *c = malloc(sizeof(*c));
+    if(!c) {
+      __atomic_store_n(&cl->in_use, false, __ATOMIC_RELEASE);
+      break;
+    }
+    c->h = h;
+    c->size = st.st_size;
+    c->index = i;
+    c->next = 0;
+    __atomic_store_n(&cl->n_batches, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&cl->n_problems, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&cl->n_evals, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&cl->busy_ns, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&cl->t_disconnect_ns, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&cl->t_connect_ns, (uint64_t)(1e9 * roots_monotonic_time()),
+                     __ATOMIC_RELEASE);
+    return c;
+  }
+  munmap(h, st.st_size);
+  return NULL;
+}
+
+/*
+ * Function   : roots_shm_acquire
+ * Author     : Leo Werneck
+ *
+ * Acquires a free batch slot of the client. The caller writes the problems
+ * directly into the arrays of the batch and sets batch->n, then submits it.
+ *
+ * Parameters : c        - Client.
+ *            : batch    - Batch (output).
+ *
+ * Returns    : true on success, false if all slots of the client are in use.
+ */
+bool roots_shm_acquire(roots_shm_client *c, roots_shm_batch *batch) {
+
+  const unsigned n_slots = c->h->n_slots;
+  for(unsigned i = 0; i < n_slots; i++) {
+    const unsigned k = (c->next + i) % n_slots;
+    shm_slot *slot = slot_at(c->h, c->index, k);
+    if(__atomic_load_n(&slot->state, __ATOMIC_ACQUIRE) == slot_free) {
+      slot->state = slot_filling;
+      slot_arrays(c->h, slot, batch);
+      batch->n = 0;
+      batch->slot = k;
+      c->next = (k + 1) % n_slots;
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * Function   : roots_shm_submit
+ * Author     : Leo Werneck
+ *
+ * Submits a batch to the server without blocking. The arrays of the batch
+ * must not be touched until roots_shm_wait returns.
+ *
+ * Parameters : c        - Client.
+ *            : batch    - Batch, filled with batch->n problems.
+ *
+ * Returns    : Nothing.
+ */
+void roots_shm_submit(roots_shm_client *c, roots_shm_batch *batch) {
+
+  shm_slot *slot = slot_at(c->h, c->index, batch->slot);
+  slot->n = batch->n < c->h->capacity ? batch->n : c->h->capacity;
+  __atomic_store_n(&slot->state, slot_submitted, __ATOMIC_RELEASE);
+  sem_post(&c->h->work);
+}
+
+/*
+ * Function   : roots_shm_wait
+ * Author     : Leo Werneck
+ *
+ * Waits for the server to solve a batch. On return, batch->root and
+ * batch->error_key hold the results.
+ *
+ * Parameters : c        - Client.
+ *            : batch    - Submitted batch.
+ *
+ * Returns    : roots_success if all problems are solved, and otherwise the
+ *              error key of the first problem that is not.
+ */
+roots_error_t roots_shm_wait(roots_shm_client *c, roots_shm_batch *batch) {
+
+  shm_slot *slot = slot_at(c->h, c->index, batch->slot);
+  sem_t *done = &client_at(c->h, c->index)->done;
+  while(__atomic_load_n(&slot->state, __ATOMIC_ACQUIRE) != slot_done) {
+    sem_wait(done);
+  }
+  return slot->error_key;
+}
+
+/*
+ * Function   : roots_shm_release
+ * Author     : Leo Werneck
+ *
+ * Releases the slot of a solved batch, after which its arrays may be reused
+ * by roots_shm_acquire.
+ *
+ * Parameters : c        - Client.
+ *            : batch    - Solved batch.
+ *
+ * Returns    : Nothing.
+ */
+void roots_shm_release(roots_shm_client *c, roots_shm_batch *batch) {
+  shm_slot *slot = slot_at(c->h, c->index, batch->slot);
+  __atomic_store_n(&slot->state, slot_free, __ATOMIC_RELEASE);
+}
+
+/*
+ * Function   : roots_shm_get_stats
+ * Author     : Leo Werneck
+ *
+ * Reads the counters of the client (see roots_shm_server_get_stats).
+ *
+ * Parameters : c        - Client.
+ *            : st       - Counters (output).
+ *
+ * Returns    : Nothing.
+ */
+void roots_shm_get_stats(roots_shm_client *c, roots_shm_stats *st) {
+  client_stats(c->h, c->index, st);
+}
+
+/*
+ * Function   : roots_shm_disconnect
+ * Author     : Leo Werneck
+ *
+ * Frees the client entry, after waiting for its submitted batches, and
+ * unmaps the shared memory. The counters of the client remain readable by
+ * the server until another client takes the entry.
+ *
+ * Parameters : c        - Client (may be NULL).
+ *
+ * Returns    : Nothing.
+ */
+void roots_shm_disconnect(roots_shm_client *c) {
+
+  if(!c) {
+    return;
+  }
+  for(unsigned k = 0; k < c->h->n_slots; k++) {
+    shm_slot *slot = slot_at(c->h, c->index, k);
+    uint32_t state = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+    if(state == slot_submitted || state == slot_running) {
+      roots_shm_batch batch = { .slot = k };
+      roots_shm_wait(c, &batch);
+    }
+    __atomic_store_n(&slot->state, slot_free, __ATOMIC_RELAXED);
+  }
+  shm_client *cl = client_at(c->h, c->index);
+  __atomic_store_n(&cl->t_disconnect_ns, (uint64_t)(1e9 * roots_monotonic_time()),
+                   __ATOMIC_RELAXED);
+  __atomic_store_n(&cl->in_use, false, __ATOMIC_RELEASE);
+  munmap(c->h, c->size);
+  free(c);
+}
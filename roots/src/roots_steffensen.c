@@ -0,0 +1,109 @@
+#include <float.h>
+
+#include "roots.h"
+#include "utils.h"
+
+/*
+ * Function   : roots_steffensen
+ * Author     : Leo Werneck
+ *
+ * Find the root of f(x) in the interval [a,b] using Steffensen's method,
+ * safeguarded by bisection.
+ *
+ * At every iteration the derivative in Newton's method is replaced by the
+ * divided difference f[b,w], where w = b + gamma f(b). We use the self
+ * correcting choice gamma = -(b-a)/(f(b)-f(a)), which places w at the false
+ * position point of the current bracket. The method converges quadratically
+ * using two function evaluations per iteration (efficiency index sqrt(2)).
+ *
+ * Parameters : f        - Function for which the root is computed.
+ *            : fparams  - Object containing all parameters needed by the
+ *                         function f other than the variable x.
+ *            : a        - Lower limit of the initial interval.
+ *            : b        - Upper limit of the initial interval.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         The root is stored in r->root.
+ *
+ * Returns    : One the following error keys:
+ *                 - roots_success if the root is found
+ *                 - roots_error_root_not_bracketed if the interval [a,b]
+ *                   does not bracket a root of f(x)
+ *                 - roots_error_max_iter if the maximum allowed number of
+ *                   iterations is exceeded
+ *                 - roots_error_max_evals if the maximum allowed number of
+ *                   function evaluations is exceeded
+ *                 - roots_error_deadline if the deadline has passed
+ *
+ * References : https://en.wikipedia.org/wiki/Steffensen%27s_method
+ */
+roots_error_t roots_steffensen(
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      double a,
+      double b,
+      roots_params *restrict r) {
+
+  // Step 0: Set basic info to the roots_params struct
+  sprintf(r->method, "Steffensen's");
+  r->a = a;
+  r->b = b;
+
+  // Step 1: Check whether a or b is the root; compute fa and fb
+  double fa, fb;
+  if(check_a_b_compute_fa_fb(f, fparams, &a, &b, &fa, &fb, r) >= roots_success) {
+    return r->error_key;
+  }
+
+  // Step 2: Declare auxiliary variables
+  double d = b - a;
+  double e = d;
+
+  // Step 3: Steffensen's algorithm
+  for(r->n_iters = 1; r->n_iters <= r->max_iters; r->n_iters++) {
+
+    // Step 3.a: Set the tolerance for this iteration
+    const double tol = 2 * DBL_EPSILON * fabs(b) + 0.5 * r->tol;
+
+    // Step 3.b: Check for convergence
+    if(fabs(a - b) < 2 * tol || fb == 0.0) {
+      return set_root(r, roots_success, b, fb, a, b);
+    }
+
+    // Step 3.c: Compute the auxiliary point w, which is always inside [a,b].
+    //           Keep it at least tol away from b, otherwise f[b,w] is
+    //           dominated by roundoff once b is close to the root.
+    double w = b - fb * (b - a) / (fb - fa);
+    if(fabs(w - b) < tol) {
+      w = b + (a > b ? tol : -tol);
+    }
+    if(budget_exhausted(r, a, b, fa, fb)) {
+      return r->error_key;
+    }
+    const double fw = evaluate(f, fparams, w, r);
+    const double dfdx = (fw - fb) / (w - b);
+
+    // Step 3.d: Use w to shrink the bracket
+    const double b_old = b;
+    const double fb_old = fb;
+    if(is_inside(w, a, b)) {
+      update_bracket(w, fw, &a, &b, &fa, &fb);
+      if(fabs(a - b) < 2 * tol || fb == 0.0) {
+        return set_root(r, roots_success, b, fb, a, b);
+      }
+    }
+
+    // Step 3.e: Steffensen step from the old b; safeguard it
+    const double c = safeguard(a, b, b_old - fb_old / dfdx, tol, &d, &e);
+    if(budget_exhausted(r, a, b, fa, fb)) {
+      return r->error_key;
+    }
+    const double fc = evaluate(f, fparams, c, r);
+
+    // Step 3.f: Update the bracket
+    update_bracket(c, fc, &a, &b, &fa, &fb);
+  }
+
+  // Step 4: The only way to get here is if we have exceeded the maximum number
+  //         of iterations allowed.
+  return set_best(r, roots_error_max_iter, a, b, fa, fb);
+}
@@ -0,0 +1,71 @@
+#include "roots.h"
+#include "utils.h"
+
+/*
+ * Function   : roots_surrogate
+ * Author     : Leo Werneck
+ *
+ * Find the root of an expensive function f(x) in the interval [a,b] with the
+ * help of a cheap approximation s(x) of it (a surrogate).
+ *
+ * The root of s is first found with the given method to a tolerance of a
+ * tenth of its estimated error. Then f is evaluated at the end points of an
+ * interval around it, of half-width equal to the estimated error; if they
+ * bracket the root, the method is applied to f on this interval, reusing
+ * these two evaluations. Otherwise, the interval is moved to the secant
+ * estimate of the root and widened until it brackets the root (see
+ * solve_near.c). If the root of s cannot be found, the method is applied to f
+ * on [a,b].
+ *
+ * Parameters : method   - Root-finding method, e.g., roots_brent.
+ *            : f        - Function for which the root is computed.
+ *            : fparams  - Object containing all parameters needed by the
+ *                         function f other than the variable x.
+ *            : s        - Surrogate of f.
+ *            : sparams  - Object containing all parameters needed by the
+ *                         function s other than the variable x.
+ *            : a        - Lower limit of the initial interval.
+ *            : b        - Upper limit of the initial interval.
+ *            : error    - Estimated distance between the roots of s and f.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         r->n_evals counts the evaluations of f and
+ *                         r->n_surrogate_evals those of s. Limits on the
+ *                         number of evaluations only apply to f, and only
+ *                         its evaluations are traced or remembered.
+ *
+ * Returns    : The error key returned by the method.
+ */
+roots_error_t roots_surrogate(
+      roots_method method,
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      double s(const double, void *restrict),
+      void *restrict sparams,
+      double a,
+      double b,
+      const double error,
+      roots_params *restrict r) {
+
+  // Step 1: Find the root of the surrogate to a loose tolerance
+  if(a > b) {
+    swap(&a, &b);
+  }
+  start_solve(r);
+  roots_params t = *r;
+  t.tol = fmax(0.1 * error, r->tol);
+  t.max_evals = 0;
+  t.trace = NULL;
+  t.recent = NULL;
+  const roots_error_t key = method(s, sparams, a, b, &t);
+
+  // Step 2: Solve for the root of f near that of the surrogate
+  if((key == roots_success || key == roots_error_max_iter) && t.root >= a
+     && t.root <= b) {
+    solve_near(method, f, fparams, a, b, t.root, fmax(error, r->tol), r);
+  }
+  else {
+    method(f, fparams, a, b, r);
+  }
+  r->n_surrogate_evals = t.n_evals;
+  return r->error_key;
+}
@@ -0,0 +1,180 @@
+#include <pthread.h>
+
+#include "roots.h"
+
+struct roots_thread_pool {
+  pthread_t *threads;
+  unsigned n_threads;
+  pthread_mutex_t lock;
+  pthread_cond_t work, done;
+  void (*task)(const unsigned, void *restrict);
+  void *arg;
+  unsigned n_tasks, next, n_done;
+  unsigned long generation;
+  bool stop;
+};
+
+/*
+ * Function   : run_tasks
+ * Author     : Leo Werneck
+ *
+ * Runs tasks of the current generation until there are none left. Must be
+ * called with the pool lock held; the lock is released while a task runs.
+ *
+ * Parameters : pool     - Thread pool.
+ *            : gen      - Generation the caller is working on.
+ *
+ * Returns    : Nothing.
+ */
+static void run_tasks(roots_thread_pool *pool, const unsigned long gen) {
+
+  while(pool->generation == gen && pool->next < pool->n_tasks) {
+    const unsigned i = pool->next++;
+    pthread_mutex_unlock(&pool->lock);
+    pool->task(i, pool->arg);
+    pthread_mutex_lock(&pool->lock);
+    if(++pool->n_done == pool->n_tasks) {
+      pthread_cond_signal(&pool->done);
+    }
+  }
+}
+
+/*
+ * Function   : worker
+ * Author     : Leo Werneck
+ *
+ * Main loop of the worker threads: wait for a new generation of tasks, run
+ * them, and go back to waiting.
+ *
+ * Parameters : p        - Thread pool.
+ *
+ * Returns    : NULL.
+ */
+static void *worker(void *p) {
+
+  roots_thread_pool *pool = (roots_thread_pool *)p;
+  pthread_mutex_lock(&pool->lock);
+  unsigned long seen = pool->generation;
+  while(true) {
+    while(!pool->stop && pool->generation == seen) {
+      pthread_cond_wait(&pool->work, &pool->lock);
+    }
+    if(pool->stop) {
+      break;
+    }
+    seen = pool->generation;
+    run_tasks(pool, seen);
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return NULL;
+}
+
+/*
+ * Function   : roots_thread_pool_create
+ * Author     : Leo Werneck
+ *
+ * Creates a fork-join thread pool.
+ *
+ * Parameters : n_threads - Number of worker threads. The thread that calls
+ *                          roots_thread_pool_run also runs tasks, so up to
+ *                          n_threads+1 tasks run concurrently.
+ *
+ * Returns    : Pointer to the thread pool, or NULL on failure.
+ */
+roots_thread_pool *roots_thread_pool_create(const unsigned n_threads) {
+
+  roots_thread_pool *pool = calloc(1, sizeof(*pool));
+  if(!pool) {
+    return NULL;
+  }
+  pool->threads = calloc(n_threads ? n_threads : 1, sizeof(*pool->threads));
+  if(!pool->threads) {
+    free(pool);
+    return NULL;
+  }
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->work, NULL);
+  pthread_cond_init(&pool->done, NULL);
+  for(unsigned i = 0; i < n_threads; i++) {
+    if(pthread_create(&pool->threads[i], NULL, worker, pool)) {
+      break;
+    }
+    pool->n_threads++;
+  }
+  return pool;
+}
+
+/*
+ * Function   : roots_thread_pool_run
+ * Author     : Leo Werneck
+ *
+ * Runs task(i, arg) for i = 0, ..., n_tasks-1 on the thread pool and waits
+ * until all tasks are done. Must not be called concurrently on the same pool.
+ *
+ * Parameters : pool     - Thread pool. If NULL, tasks run sequentially on
+ *                         the calling thread.
+ *            : n_tasks  - Number of tasks.
+ *            : task     - Function that runs a single task.
+ *            : arg      - Argument passed to all tasks.
+ *
+ * Returns    : Nothing.
+ */
+void roots_thread_pool_run(
+      roots_thread_pool *pool,
+      const unsigned n_tasks,
+      void task(const unsigned, void *restrict),
+      void *restrict arg) {
+
+  // Step 1: Run sequentially if there is no pool
+  if(!pool || !pool->n_threads || n_tasks == 1) {
+    for(unsigned i = 0; i < n_tasks; i++) {
+      task(i, arg);
+    }
+    return;
+  }
+
+  // Step 2: Publish a new generation of tasks and wake up the workers
+  pthread_mutex_lock(&pool->lock);
+  pool->task = task;
+  pool->arg = arg;
+  pool->n_tasks = n_tasks;
+  pool->next = pool->n_done = 0;
+  const unsigned long gen = ++pool->generation;
+  pthread_cond_broadcast(&pool->work);
+
+  // Step 3: Help out, then wait for the remaining tasks to finish
+  run_tasks(pool, gen);
+  while(pool->n_done < pool->n_tasks) {
+    pthread_cond_wait(&pool->done, &pool->lock);
+  }
+  pthread_mutex_unlock(&pool->lock);
+}
+
+/*
+ * Function   : roots_thread_pool_destroy
+ * Author     : Leo Werneck
+ *
+ * Stops all worker threads and frees the thread pool.
+ *
+ * Parameters : pool     - Thread pool (may be NULL).
+ *
+ * Returns    : Nothing.
+ */
+void roots_thread_pool_destroy(roots_thread_pool *pool) {
+
+  if(!pool) {
+    return;
+  }
+  pthread_mutex_lock(&pool->lock);
+  pool->stop = true;
+  pthread_cond_broadcast(&pool->work);
+  pthread_mutex_unlock(&pool->lock);
+  for(unsigned i = 0; i < pool->n_threads; i++) {
+    pthread_join(pool->threads[i], NULL);
+  }
+  pthread_mutex_destroy(&pool->lock);
+  pthread_cond_destroy(&pool->work);
+  pthread_cond_destroy(&pool->done);
+  free(pool->threads);
+  free(pool);
+}
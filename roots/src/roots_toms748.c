@@ -27,7 +27,8 @@ static void bracket(
       double *restrict fa,
       double *restrict fb,
       double *restrict d,
-      double *restrict fd) {
+      double *restrict fd,
+      roots_params *restrict r) {
 
   //
   // Given a point c inside the existing enclosing interval
@@ -55,7 +56,7 @@ static void bracket(
   //
   // OK, lets invoke f(c):
   //
-  double fc = f(c, fparams);
+  double fc = evaluate(f, fparams, c, r);
   //
   // if we have a zero then we have an exact solution to the root:
   //
@@ -216,8 +217,11 @@ roots_error_t roots_toms748(
       double b,
       roots_params *restrict r) {
 
+  sprintf(r->method, "TOMS748");
   r->a = a;
   r->b = b;
+  start_solve(r);
+  r->n_evals = 0;
 
   int count = r->max_iters;
   double c, u, fu, d, fd, e, fe;
@@ -229,24 +233,18 @@ roots_error_t roots_toms748(
   }
 
   // Now compute fa and fb
-  double fa = f(a, fparams);
-  double fb = f(b, fparams);
+  double fa = evaluate(f, fparams, a, r);
+  double fb = evaluate(f, fparams, b, r);
 
   if(sign(fa) * sign(fb) > 0) {
+    r->n_iters = 0;
     return (r->error_key = roots_error_root_not_bracketed);
   }
 
   // Check if we already have a root
   if(fabs(b - a) < r->tol || (fa == 0) || (fb == 0)) {
     r->n_iters = 0;
-    if(fabs(fa) < fabs(fb)) {
-      r->root = a;
-      r->residual = fa;
-      return (r->error_key = roots_success);
-    }
-    r->root = b;
-    r->residual = fb;
-    return (r->error_key = roots_success);
+    return set_best(r, roots_success, a, b, fa, fb);
   }
 
   // dummy value for fd, e and fe:
@@ -257,7 +255,11 @@ roots_error_t roots_toms748(
     // On the first step we take a secant step:
     //
     c = secant_interpolate(a, b, fa, fb);
-    bracket(f, fparams, &a, &b, c, &fa, &fb, &d, &fd);
+    if(budget_exhausted(r, a, b, fa, fb)) {
+      r->n_iters = r->max_iters - count;
+      return r->error_key;
+    }
+    bracket(f, fparams, &a, &b, c, &fa, &fb, &d, &fd, r);
     --count;
 
     if(count && (fa != 0) && fabs(b - a) > r->tol) {
@@ -267,7 +269,11 @@ roots_error_t roots_toms748(
       c = quadratic_interpolate(a, b, d, fa, fb, fd, 2);
       e = d;
       fe = fd;
-      bracket(f, fparams, &a, &b, c, &fa, &fb, &d, &fd);
+      if(budget_exhausted(r, a, b, fa, fb)) {
+        r->n_iters = r->max_iters - count;
+        return r->error_key;
+      }
+      bracket(f, fparams, &a, &b, c, &fa, &fb, &d, &fd, r);
       --count;
     }
   }
@@ -299,7 +305,11 @@ roots_error_t roots_toms748(
     //
     e = d;
     fe = fd;
-    bracket(f, fparams, &a, &b, c, &fa, &fb, &d, &fd);
+    if(budget_exhausted(r, a, b, fa, fb)) {
+      r->n_iters = r->max_iters - count;
+      return r->error_key;
+    }
+    bracket(f, fparams, &a, &b, c, &fa, &fb, &d, &fd, r);
     if((0 == --count) || (fa == 0) || fabs(b - a) < r->tol) {
       break;
     }
@@ -320,7 +330,11 @@ roots_error_t roots_toms748(
     //
     // Bracket again, and check termination condition, update e:
     //
-    bracket(f, fparams, &a, &b, c, &fa, &fb, &d, &fd);
+    if(budget_exhausted(r, a, b, fa, fb)) {
+      r->n_iters = r->max_iters - count;
+      return r->error_key;
+    }
+    bracket(f, fparams, &a, &b, c, &fa, &fb, &d, &fd, r);
     if((0 == --count) || (fa == 0) || fabs(b - a) < r->tol) {
       break;
     }
@@ -338,7 +352,7 @@ roots_error_t roots_toms748(
     }
     c = u - 2 * (fu / (fb - fa)) * (b - a);
     if(fabs(c - u) > (b - a) / 2) {
-      c = a + (b - a) / 2;
+      c = midpoint(a, b, r);
     }
 
     //
@@ -346,7 +360,11 @@ roots_error_t roots_toms748(
     //
     e = d;
     fe = fd;
-    bracket(f, fparams, &a, &b, c, &fa, &fb, &d, &fd);
+    if(budget_exhausted(r, a, b, fa, fb)) {
+      r->n_iters = r->max_iters - count;
+      return r->error_key;
+    }
+    bracket(f, fparams, &a, &b, c, &fa, &fb, &d, &fd, r);
     if((0 == --count) || (fa == 0) || fabs(b - a) < r->tol) {
       break;
     }
@@ -364,17 +382,14 @@ roots_error_t roots_toms748(
     //
     e = d;
     fe = fd;
-    bracket(f, fparams, &a, &b, a + (b - a) / 2, &fa, &fb, &d, &fd);
+    if(budget_exhausted(r, a, b, fa, fb)) {
+      r->n_iters = r->max_iters - count;
+      return r->error_key;
+    }
+    bracket(f, fparams, &a, &b, midpoint(a, b, r), &fa, &fb, &d, &fd, r);
     --count;
   }  // while loop
 
   r->n_iters = r->max_iters - count;
-  if(fabs(fa) < fabs(fb)) {
-    r->root = a;
-    r->residual = fa;
-    return (r->error_key = roots_success);
-  }
-  r->root = b;
-  r->residual = fb;
-  return (r->error_key = roots_success);
+  return set_best(r, roots_success, a, b, fa, fb);
 }
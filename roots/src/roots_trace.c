@@ -0,0 +1,347 @@
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "roots.h"
+#include "utils.h"
+
+/*
+ * Traces of function evaluations. A trace file starts with the 8 byte magic
+ * string below, followed by records in the native byte order, each starting
+ * with a one byte tag:
+ *   'S' - A new solve: length of the method name (uint16), method name, a,
+ *         b, and tol (double), max_iters (uint32), and bisect (uint8).
+ *   'E' - An evaluation of f in the current solve: x and f(x) (double).
+ * Records are collected in a buffer that is written to the file when full.
+ */
+#define TRACE_MAGIC "ROOTST1"
+#define TRACE_BUFFER (1 << 16)
+
+struct roots_trace {
+  int fd;
+  bool failed;
+  size_t used;
+  unsigned char buf[TRACE_BUFFER];
+};
+
+/*
+ * Function   : flush
+ * Author     : Leo Werneck
+ *
+ * Writes the buffered records to the trace file.
+ *
+ * Parameters : t        - Trace.
+ *
+ * Returns    : Nothing.
+ */
+static void flush(roots_trace *t) {
+
+  size_t done = 0;
+  while(done < t->used && !t->failed) {
+    const ssize_t w = write(t->fd, t->buf + done, t->used - done);
+    t->failed = w < 0;
+    done += w > 0 ? w : 0;
+  }
+  t->used = 0;
+}
+
+static void put(roots_trace *t, const void *data, const size_t size) {
+  if(t->used + size > TRACE_BUFFER) {
+    flush(t);
+  }
+  memcpy(t->buf + t->used, data, size);
+  t->used += size;
+}
+
+/*
+ * Function   : roots_trace_open
+ * Author     : Leo Werneck
+ *
+ * Creates a trace file. Solves whose roots_params point to the trace (the
+ * member trace) record their method, initial interval, tolerance, and every
+ * evaluation of f. A trace must not be used by more than one thread at a
+ * time.
+ *
+ * Parameters : path     - Path to the trace file (overwritten).
+ *
+ * Returns    : Pointer to the trace, or NULL on failure.
+ */
+roots_trace *roots_trace_open(const char *path) {
+
+  roots_trace *t = malloc(sizeof(roots_trace));
+  if(!t) {
+    return NULL;
+  }
+  t->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if(t->fd < 0) {
+    free(t);
+    return NULL;
+  }
+  t->failed = false;
+  t->used = 0;
+  put(t, TRACE_MAGIC, 8);
+  return t;
+}
+
+/*
+ * Function   : roots_trace_close
+ * Author     : Leo Werneck
+ *
+ * Writes the buffered records and closes the trace file.
+ *
+ * Parameters : t        - Trace.
+ *
+ * Returns    : true if all records were written, false otherwise.
+ */
+bool roots_trace_close(roots_trace *t) {
+
+  flush(t);
+  const bool ok = !t->failed && !close(t->fd);
+  free(t);
+  return ok;
+}
+
+/*
+ * Function   : trace_evaluation
+ * Author     : Leo Werneck
+ *
+ * Records an evaluation of f, preceded by the description of the solve if
+ * it is the first evaluation of the solve. Called by evaluate (see utils.h).
+ *
+ * Parameters : r        - Pointer to roots library parameters (see roots.h).
+ *            : x        - Point at which f was evaluated.
+ *            : fx       - f(x).
+ *
+ * Returns    : Nothing.
+ */
+void trace_evaluation(const roots_params *restrict r, const double x, const double fx) {
+
+  roots_trace *t = r->trace;
+  if(r->n_evals == 1) {
+    const uint16_t len = strnlen(r->method, sizeof(r->method));
+    const double v[3] = { r->a, r->b, r->tol };
+    const uint32_t max_iters = r->max_iters;
+    const uint8_t bisect = r->bisect;
+    put(t, "S", 1);
+    put(t, &len, sizeof(len));
+    put(t, r->method, len);
+    put(t, v, sizeof(v));
+    put(t, &max_iters, sizeof(max_iters));
+    put(t, &bisect, sizeof(bisect));
+  }
+  const double v[2] = { x, fx };
+  put(t, "E", 1);
+  put(t, v, sizeof(v));
+}
+
+static int compare_points(const void *p, const void *q) {
+  const double x = *(const double *)p, y = *(const double *)q;
+  return (x > y) - (x < y);
+}
+
+/*
+ * Function   : roots_trace_load
+ * Author     : Leo Werneck
+ *
+ * Reads all solves recorded in a trace file. The evaluations of each solve
+ * are sorted by x, with duplicates removed, for roots_trace_replay.
+ *
+ * Parameters : path     - Path to the trace file.
+ *            : n_solves - Number of solves (output).
+ *
+ * Returns    : Array of solves, to be freed with roots_trace_free, or NULL if
+ *              the file cannot be read or is not a trace.
+ */
+roots_trace_solve *roots_trace_load(const char *path, unsigned *n_solves) {
+
+  // Step 1: Map the file
+  *n_solves = 0;
+  const int fd = open(path, O_RDONLY);
+  struct stat st;
+  if(fd < 0 || fstat(fd, &st) || st.st_size < 8) {
+    if(fd >= 0) {
+      close(fd);
+    }
+    return NULL;
+  }
+  const size_t size = st.st_size;
+  const unsigned char *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(data == MAP_FAILED || memcmp(data, TRACE_MAGIC, 8)) {
+    if(data != MAP_FAILED) {
+      munmap((void *)data, size);
+    }
+    return NULL;
+  }
+
+  // Step 2: Read the records
+  unsigned capacity = 16, n = 0;
+  roots_trace_solve *solves = malloc(sizeof(roots_trace_solve) * capacity);
+  if(!solves) {
+    munmap((void *)data, size);
+    return NULL;
+  }
+  unsigned capacity_points = 0;
+  size_t pos = 8;
+  while(pos < size) {
+    roots_trace_solve *s = n ? &solves[n - 1] : NULL;
+    if(data[pos] == 'S' && pos + 3 <= size) {
+      uint16_t len;
+      memcpy(&len, data + pos + 1, sizeof(len));
+      if(pos + 3 + len + 24 + 4 + 1 > size) {
+        break;
+      }
+      if(n == capacity) {
+        roots_trace_solve *grown
+              = realloc(solves, sizeof(roots_trace_solve) * 2 * capacity);
+        if(!grown) {
+          goto fail;
+        }
+        solves = grown;
+        capacity *= 2;
+      }
+      s = &solves[n++];
+      memset(s, 0, sizeof(*s));
+      const size_t l = len < sizeof(s->method) - 1 ? len : sizeof(s->method) - 1;
+      memcpy(s->method, data + pos + 3, l);
+      double v[3];
+      uint32_t max_iters;
+      memcpy(v, data + pos + 3 + len, sizeof(v));
+      memcpy(&max_iters, data + pos + 3 + len + 24, sizeof(max_iters));
+      s->a = v[0];
+      s->b = v[1];
+      s->tol = v[2];
+      s->max_iters = max_iters;
+      s->bisect = data[pos + 3 + len + 28];
+      capacity_points = 0;
+      pos += 3 + len + 24 + 4 + 1;
+    }
+    else if(data[pos] == 'E' && pos + 17 <= size && s) {
+      if(s->n_points == capacity_points) {
+        const unsigned grown = capacity_points ? 2 * capacity_points : 16;
+        double *x = realloc(s->x, sizeof(double) * grown);
+        if(x) {
+          s->x = x;
+        }
+        double *fx = realloc(s->fx, sizeof(double) * grown);
+        if(fx) {
+          s->fx = fx;
+        }
+        if(!x || !fx) {
+          goto fail;
+        }
+        capacity_points = grown;
+      }
+      memcpy(&s->x[s->n_points], data + pos + 1, sizeof(double));
+      memcpy(&s->fx[s->n_points], data + pos + 9, sizeof(double));
+      s->n_points++;
+      s->n_evals++;
+      pos += 17;
+    }
+    else {
+      break;
+    }
+  }
+  munmap((void *)data, size);
+  data = NULL;
+
+  // Step 3: Sort the points of each solve and remove duplicates
+  for(unsigned k = 0; k < n; k++) {
+    roots_trace_solve *s = &solves[k];
+    double *p = malloc(sizeof(double) * 2 * (s->n_points + 1));
+    if(!p) {
+      goto fail;
+    }
+    for(unsigned i = 0; i < s->n_points; i++) {
+      p[2 * i] = s->x[i];
+      p[2 * i + 1] = s->fx[i];
+    }
+    qsort(p, s->n_points, 2 * sizeof(double), compare_points);
+    unsigned m = 0;
+    for(unsigned i = 0; i < s->n_points; i++) {
+      if(!m || p[2 * i] != s->x[m - 1]) {
+        s->x[m] = p[2 * i];
+        s->fx[m++] = p[2 * i + 1];
+      }
+    }
+    s->n_points = m;
+    free(p);
+  }
+  *n_solves = n;
+  return solves;
+
+fail:
+  if(data) {
+    munmap((void *)data, size);
+  }
+  roots_trace_free(solves, n);
+  return NULL;
+}
+
+/*
+ * Function   : roots_trace_free
+ * Author     : Leo Werneck
+ *
+ * Frees the solves returned by roots_trace_load.
+ *
+ * Parameters : solves   - Solves.
+ *            : n_solves - Number of solves.
+ *
+ * Returns    : Nothing.
+ */
+void roots_trace_free(roots_trace_solve *solves, const unsigned n_solves) {
+
+  for(unsigned k = 0; k < n_solves; k++) {
+    free(solves[k].x);
+    free(solves[k].fx);
+  }
+  free(solves);
+}
+
+/*
+ * Function   : roots_trace_replay
+ * Author     : Leo Werneck
+ *
+ * Function to pass to the root-finding methods to re-run a recorded solve:
+ * returns the recorded value of f at points that were evaluated, and
+ * interpolates linearly between the nearest recorded points otherwise
+ * (extrapolates outside of them). Replay is exact for the method and
+ * parameters that were recorded. Every call is counted in the members
+ * n_replayed and n_interpolated of the solve, so a solve must not be replayed
+ * by more than one thread at a time.
+ *
+ * Parameters : x        - Point at which the function is evaluated.
+ *            : solve    - Pointer to a roots_trace_solve struct.
+ *
+ * Returns    : The recorded or interpolated value of f(x).
+ */
+double roots_trace_replay(const double x, void *restrict solve) {
+
+  roots_trace_solve *s = (roots_trace_solve *)solve;
+  s->n_replayed++;
+  if(s->n_points < 2) {
+    s->n_interpolated += !s->n_points || s->x[0] != x;
+    return s->n_points ? s->fx[0] : NAN;
+  }
+
+  // Binary search for the first point not smaller than x
+  unsigned lo = 0, hi = s->n_points;
+  while(lo < hi) {
+    const unsigned mid = (lo + hi) / 2;
+    if(s->x[mid] < x) {
+      lo = mid + 1;
+    }
+    else {
+      hi = mid;
+    }
+  }
+  if(lo < s->n_points && s->x[lo] == x) {
+    return s->fx[lo];
+  }
+  s->n_interpolated++;
+  const unsigned i = lo == 0 ? 1 : (lo == s->n_points ? s->n_points - 1 : lo);
+  const double t = (x - s->x[i - 1]) / (s->x[i] - s->x[i - 1]);
+  return s->fx[i - 1] + t * (s->fx[i] - s->fx[i - 1]);
+}
@@ -0,0 +1,128 @@
+#include <float.h>
+
+#include "roots.h"
+#include "utils.h"
+
+// Wrapper around f that returns the function values at two points known in
+// advance without evaluating f again. The evaluations of f are counted, and
+// traced if a trace is set, through r.
+typedef struct {
+  double (*f)(const double, void *restrict);
+  void *fparams;
+  double x[2], fx[2];
+  roots_params *r;
+} memo_params;
+
+/*
+ * Function   : memo
+ * Author     : Leo Werneck
+ *
+ * Evaluates f(x), unless x is one of the memoized points.
+ *
+ * Parameters : x        - Point at which the function is evaluated.
+ *            : p        - Pointer to a memo_params struct.
+ *
+ * Returns    : f(x).
+ */
+static double memo(const double x, void *restrict p) {
+  memo_params *m = (memo_params *)p;
+  if(x == m->x[0]) {
+    return m->fx[0];
+  }
+  if(x == m->x[1]) {
+    return m->fx[1];
+  }
+  return evaluate(m->f, m->fparams, x, m->r);
+}
+
+/*
+ * Function   : solve_near
+ * Author     : Leo Werneck
+ *
+ * Find the root of f(x) in the interval [a,b] using the given method and an
+ * approximation x of the root.
+ *
+ * f is evaluated at the end points of the interval [x-delta,x+delta]. If the
+ * interval brackets the root, the method is applied to it, reusing these two
+ * evaluations. Otherwise, the interval is moved to the secant estimate of the
+ * root computed from them and widened, and the process is repeated until the
+ * interval covers [a,b].
+ *
+ * Parameters : method   - Root-finding method, e.g., roots_brent.
+ *            : f        - Function for which the root is computed.
+ *            : fparams  - Object containing all parameters needed by the
+ *                         function f other than the variable x.
+ *            : a        - Lower limit of the initial interval.
+ *            : b        - Upper limit of the initial interval (b > a).
+ *            : x        - Approximation of the root in [a,b].
+ *            : delta    - Estimated error of the approximation.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *                         r->n_evals counts all evaluations of f. If
+ *                         r->trace is set, they are all recorded as a single
+ *                         solve on [a,b].
+ *
+ * Returns    : The error key returned by the method.
+ */
+roots_error_t solve_near(
+      roots_method method,
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      const double a,
+      const double b,
+      double x,
+      double delta,
+      roots_params *restrict r) {
+
+  // Step 1: Look for a small interval around x that brackets the root. The
+  //         evaluations of f are counted and traced through e, both here
+  //         and within the method, which evaluates memo.
+  start_solve(r);
+  roots_params e = *r;
+  sprintf(e.method, "Near approximation");
+  e.a = a;
+  e.b = b;
+  e.n_evals = 0;
+  e.recent = NULL;
+  memo_params m = { f, fparams, { NAN, NAN }, { NAN, NAN }, &e };
+  delta = fmax(delta, 4 * DBL_EPSILON * fabs(x));
+  double a1, b1;
+  while(true) {
+    a1 = fmax(a, x - delta);
+    b1 = fmin(b, x + delta);
+    if(r->max_evals && e.n_evals + 2 > r->max_evals) {
+      break;
+    }
+    m.x[0] = a1;
+    m.x[1] = b1;
+    m.fx[0] = evaluate(f, fparams, a1, &e);
+    m.fx[1] = evaluate(f, fparams, b1, &e);
+    if(m.fx[0] * m.fx[1] <= 0 || (a1 == a && b1 == b)) {
+      break;
+    }
+
+    // Step 1.a: Move the interval to the secant estimate of the root and
+    //           widen it.
+    const double s = b1 - m.fx[1] * (b1 - a1) / (m.fx[1] - m.fx[0]);
+    if(isfinite(s) && s >= a && s <= b) {
+      delta = fmax(2 * delta, 0.25 * fabs(s - x));
+      x = s;
+    }
+    else {
+      delta *= 16;
+    }
+  }
+
+  // Step 2: Apply the method, sharing the evaluation budget, if any
+  const unsigned max_evals = r->max_evals;
+  if(max_evals) {
+    r->max_evals = max_evals > e.n_evals ? max_evals - e.n_evals : 1;
+  }
+  r->trace = NULL;
+  method(memo, &m, a1, b1, r);
+  r->trace = e.trace;
+  r->max_evals = max_evals;
+  r->n_evals = e.n_evals;
+  r->a = a;
+  r->b = b;
+  return r->error_key;
+}
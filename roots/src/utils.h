@@ -57,6 +57,351 @@ static inline void ensure_b_is_closest_to_root(
   }
 }
 
+/*
+ * Function   : is_inside
+ * Author     : Leo Werneck
+ *
+ * Checks whether x lies strictly inside the interval with end points a and b.
+ * The end points may be given in any order.
+ *
+ * Parameters : x        - Point to be checked.
+ *            : a        - First end point of the interval.
+ *            : b        - Second end point of the interval.
+ *
+ * Returns    : true if x is strictly between a and b, false otherwise.
+ */
+static inline bool is_inside(const double x, const double a, const double b) {
+  return a < b ? (x > a && x < b) : (x > b && x < a);
+}
+
+/*
+ * Function   : update_bracket
+ * Author     : Leo Werneck
+ *
+ * Given an interval with end points a and b such that f(a)f(b) < 0 and a new
+ * point x inside it, replaces the end point that has the same sign as f(x) by
+ * x, so that the root remains bracketed. On return, |f(b)| <= |f(a)|.
+ *
+ * Parameters : x        - New point inside the interval.
+ *            : fx       - f(x).
+ *            : a        - First end point of the interval.
+ *            : b        - Second end point of the interval.
+ *            : fa       - f(a).
+ *            : fb       - f(b).
+ *
+ * Returns    : Nothing.
+ */
+static inline void update_bracket(
+      const double x,
+      const double fx,
+      double *restrict a,
+      double *restrict b,
+      double *restrict fa,
+      double *restrict fb) {
+
+  if(sign(fx) == sign(*fb)) {
+    *b = x;
+    *fb = fx;
+  }
+  else {
+    *a = x;
+    *fa = fx;
+  }
+  ensure_b_is_closest_to_root(a, b, fa, fb);
+}
+
+/*
+ * Function   : safeguard
+ * Author     : Leo Werneck
+ *
+ * Bracketing safeguard used by the open (interpolating) methods, following
+ * the logic of Brent's method. The candidate c is accepted only if it lies
+ * in the bracket and the step it implies is smaller than half of the step
+ * taken before the last one; otherwise a bisection step is taken. Steps
+ * smaller than the tolerance are enlarged to the tolerance, so that once b is
+ * within tol of the root the next point lands on the other side of it.
+ *
+ * Parameters : a        - Contrapoint, i.e., f(a)f(b) < 0.
+ *            : b        - Best approximation to the root.
+ *            : c        - Candidate for the next point.
+ *            : tol      - Tolerance for this iteration.
+ *            : d        - Last step taken (updated).
+ *            : e        - Step taken before the last one (updated).
+ *
+ * Returns    : The next point at which f should be evaluated.
+ */
+static inline double safeguard(
+      const double a,
+      const double b,
+      const double c,
+      const double tol,
+      double *restrict d,
+      double *restrict e) {
+
+  const double m = 0.5 * (a - b);
+  const double emax = 0.5 * fabs(*e);
+  if(isfinite(c) && (c == b || is_inside(c, a, b)) && fabs(c - b) < emax) {
+    *e = *d;
+    *d = c - b;
+  }
+  else {
+    *e = *d = m;
+  }
+  if(fabs(*d) > tol) {
+    return b + *d;
+  }
+  return b + (m > 0 ? tol : -tol);
+}
+
+/*
+ * Function   : start_solve
+ * Author     : Leo Werneck
+ *
+ * Prepares r for a new solve. Unless r was set up by roots_params_init, the
+ * optional inputs (see roots.h) may hold garbage and are disabled. The
+ * iteration counter and the outputs that not every method sets are reset;
+ * the evaluation counter is left to the caller, so that solves continuing
+ * from known function values, e.g., roots_brent_core, count the evaluations
+ * made before.
+ *
+ * Parameters : r        - Pointer to roots library parameters (see roots.h).
+ *
+ * Returns    : Nothing.
+ */
+static inline void start_solve(roots_params *restrict r) {
+
+  if(r->init != ROOTS_PARAMS_INIT) {
+    r->max_evals = 0;
+    r->deadline = 0;
+    r->bisect = roots_bisect_linear;
+    r->trace = NULL;
+    r->recent = NULL;
+  }
+  r->n_iters = 0;
+  r->n_surrogate_evals = 0;
+  r->multiplicity = 1;
+  r->dfdx = NAN;
+}
+
+/*
+ * Function   : remember
+ * Author     : Leo Werneck
+ *
+ * Keeps the most recent evaluations of f in the ring buffer r->recent, if
+ * set, indexed by the evaluation counter, which must already count this
+ * evaluation. f'(root) is estimated from them when a method stops (see
+ * recent_slope).
+ *
+ * Parameters : r        - Pointer to roots library parameters (see roots.h).
+ *            : x        - Point at which f was evaluated.
+ *            : fx       - f(x).
+ *
+ * Returns    : Nothing.
+ */
+static inline void remember(roots_params *restrict r, const double x, const double fx) {
+
+  if(r->recent) {
+    const unsigned i = (r->n_evals - 1) % (sizeof(r->recent->x) / sizeof(*r->recent->x));
+    r->recent->x[i] = x;
+    r->recent->f[i] = fx;
+  }
+}
+
+// This function is implemented in roots_trace.c
+void trace_evaluation(const roots_params *restrict r, const double x, const double fx);
+
+/*
+ * Function   : evaluate
+ * Author     : Leo Werneck
+ *
+ * Evaluates f(x), keeping track of the number of function evaluations and
+ * remembering it (see remember), and recording it if a trace is set. All
+ * root-finding methods evaluate f through this function.
+ *
+ * Parameters : f        - Function for which the root is computed.
+ *            : fparams  - Object containing all parameters needed by the
+ *                         function f other than the variable x.
+ *            : x        - Point at which f is evaluated.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *
+ * Returns    : f(x).
+ */
+static inline double evaluate(
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      const double x,
+      roots_params *restrict r) {
+
+  r->n_evals++;
+  const double fx = f(x, fparams);
+  remember(r, x, fx);
+  if(r->trace) {
+    trace_evaluation(r, x, fx);
+  }
+  return fx;
+}
+
+/*
+ * Function   : recent_slope
+ * Author     : Leo Werneck
+ *
+ * Estimates f'(x) from the evaluations kept by remember: the derivative at x
+ * of the parabola through the newest evaluation and the two next newest ones
+ * that are farther than sqrt(eps)|x| + tol from it and from each other. The
+ * final, tolerance-sized steps of a method are skipped this way, since their
+ * divided differences are dominated by rounding errors. With fewer than three
+ * such points, the slope of the line through the newest evaluation and the
+ * one farthest from it is used.
+ *
+ * Parameters : r        - Pointer to roots library parameters (see roots.h).
+ *            : x        - Point at which f' is estimated, usually the root.
+ *
+ * Returns    : The estimate of f'(x), or NAN if there are fewer than two
+ *              finite evaluations.
+ */
+static inline double recent_slope(const roots_params *restrict r, const double x) {
+
+  // Step 1: Select the points, scanning from the newest to the oldest and
+  //         skipping non-finite values
+  const unsigned size = sizeof(r->recent->x) / sizeof(*r->recent->x);
+  const unsigned n = r->n_evals < size ? r->n_evals : size;
+  const double delta = 1.5e-8 * fabs(x) + r->tol;
+  const double *xs = r->recent->x, *fs = r->recent->f;
+  unsigned i2 = size, i1 = size, i0 = size, far = size;
+  for(unsigned k = 0; k < n && i0 == size; k++) {
+    const unsigned i = (r->n_evals - 1 - k) % size;
+    if(!isfinite(xs[i]) || !isfinite(fs[i])) {
+      continue;
+    }
+    if(i2 == size) {
+      i2 = i;
+      continue;
+    }
+    const double d2 = fabs(xs[i] - xs[i2]);
+    if(far == size || d2 > fabs(xs[far] - xs[i2])) {
+      far = i;
+    }
+    if(!(d2 > delta)) {
+      continue;
+    }
+    if(i1 == size) {
+      i1 = i;
+    }
+    else if(fabs(xs[i] - xs[i1]) > delta) {
+      i0 = i;
+    }
+  }
+
+  // Step 2: Compute the slope from the divided differences
+  if(far == size) {
+    return NAN;
+  }
+  if(i0 == size) {
+    return (fs[i2] - fs[far]) / (xs[i2] - xs[far]);
+  }
+  const double d12 = (fs[i2] - fs[i1]) / (xs[i2] - xs[i1]);
+  const double d01 = (fs[i1] - fs[i0]) / (xs[i1] - xs[i0]);
+  const double d012 = (d12 - d01) / (xs[i2] - xs[i0]);
+  return d12 + d012 * ((x - xs[i1]) + (x - xs[i2]));
+}
+
+/*
+ * Function   : set_root
+ * Author     : Leo Werneck
+ *
+ * Stores the result of a root-finding method in the roots_params struct,
+ * including the estimate of f'(x) if r->recent is set (see recent_slope).
+ *
+ * Parameters : r        - Pointer to roots library parameters (see roots.h).
+ *            : key      - Error key to be returned.
+ *            : x        - Root (or best approximation to it).
+ *            : fx       - f(x).
+ *            : a        - One end of the final interval.
+ *            : b        - Other end of the final interval.
+ *
+ * Returns    : The error key.
+ */
+static inline roots_error_t set_root(
+      roots_params *restrict r,
+      const roots_error_t key,
+      const double x,
+      const double fx,
+      const double a,
+      const double b) {
+
+  r->root = x;
+  r->residual = fx;
+  r->dfdx = r->recent ? recent_slope(r, x) : NAN;
+  r->bracket_a = a < b ? a : b;
+  r->bracket_b = a < b ? b : a;
+  return (r->error_key = key);
+}
+
+/*
+ * Function   : set_best
+ * Author     : Leo Werneck
+ *
+ * Same as set_root, but uses a or b, whichever has the smallest |f|, as the
+ * approximation to the root. Used when a method stops before convergence.
+ *
+ * Parameters : r        - Pointer to roots library parameters (see roots.h).
+ *            : key      - Error key to be returned.
+ *            : a        - One end of the final interval.
+ *            : b        - Other end of the final interval.
+ *            : fa       - f(a).
+ *            : fb       - f(b).
+ *
+ * Returns    : The error key.
+ */
+static inline roots_error_t set_best(
+      roots_params *restrict r,
+      const roots_error_t key,
+      const double a,
+      const double b,
+      const double fa,
+      const double fb) {
+
+  if(fabs(fa) < fabs(fb)) {
+    return set_root(r, key, a, fa, a, b);
+  }
+  return set_root(r, key, b, fb, a, b);
+}
+
+/*
+ * Function   : budget_exhausted
+ * Author     : Leo Werneck
+ *
+ * Checks, before a new function evaluation, whether the maximum number of
+ * function evaluations has been reached or the deadline has passed. If so,
+ * the best approximation to the root and the current interval are stored in
+ * the roots_params struct (see set_best).
+ *
+ * Parameters : r        - Pointer to roots library parameters (see roots.h).
+ *            : a        - One end of the current interval.
+ *            : b        - Other end of the current interval.
+ *            : fa       - f(a).
+ *            : fb       - f(b).
+ *
+ * Returns    : true if the method must stop, false otherwise.
+ */
+static inline bool budget_exhausted(
+      roots_params *restrict r,
+      const double a,
+      const double b,
+      const double fa,
+      const double fb) {
+
+  if(r->max_evals && r->n_evals >= r->max_evals) {
+    set_best(r, roots_error_max_evals, a, b, fa, fb);
+    return true;
+  }
+  if(r->deadline > 0 && roots_monotonic_time() >= r->deadline) {
+    set_best(r, roots_error_deadline, a, b, fa, fb);
+    return true;
+  }
+  return false;
+}
+
 /*
  * Function   : bracket
  * Author     : Leo Werneck
@@ -121,6 +466,199 @@ static inline void ensure_b_is_closest_to_root(
 //   return roots_continue;
 // }
 
+/*
+ * Function   : ordered_bits
+ * Author     : Leo Werneck
+ *
+ * Maps a double to an integer such that the order of doubles is preserved
+ * and consecutive doubles map to consecutive integers (both zeros map to 0).
+ * The map is its own inverse (see from_ordered_bits).
+ *
+ * Parameters : x        - Number.
+ *
+ * Returns    : The integer.
+ */
+static inline int64_t ordered_bits(const double x) {
+
+  const union {
+    double x;
+    int64_t i;
+  } u = { x };
+  return u.i < 0 ? INT64_MIN - u.i : u.i;
+}
+
+static inline double from_ordered_bits(const int64_t i) {
+
+  const union {
+    int64_t i;
+    double x;
+  } u = { i < 0 ? INT64_MIN - i : i };
+  return u.x;
+}
+
+/*
+ * Function   : midpoint
+ * Author     : Leo Werneck
+ *
+ * Computes the point that splits the interval [a,b] in two, according to the
+ * bisection mode r->bisect:
+ *   - roots_bisect_linear: the arithmetic mean of a and b;
+ *   - roots_bisect_log: the geometric mean of a and b, i.e., bisection in
+ *     log space, if a and b have the same sign. Otherwise, as below;
+ *   - roots_bisect_bits: the mean of the integer representations of a and b
+ *     (see ordered_bits), so that each step halves the number of doubles in
+ *     the interval and at most 64 steps reach any root.
+ *
+ * Parameters : a        - One end of the interval.
+ *            : b        - Other end of the interval.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *
+ * Returns    : The midpoint.
+ */
+static inline double midpoint(
+      const double a,
+      const double b,
+      const roots_params *restrict r) {
+
+  if(r->bisect == roots_bisect_linear) {
+    return (a + b) / 2;
+  }
+  if(r->bisect == roots_bisect_log && a * b > 0) {
+    return copysign(sqrt(fabs(a)) * sqrt(fabs(b)), a);
+  }
+  const int64_t i = ordered_bits(a), j = ordered_bits(b);
+  return from_ordered_bits((i >> 1) + (j >> 1) + (i & j & 1));
+}
+
+/*
+ * Function   : deflate
+ * Author     : Leo Werneck
+ *
+ * Near a root of multiplicity m, f(x) ~ C (x - x*)^m, so g = sign(f)|f|^(1/m)
+ * has a simple root at x*. Interpolation steps computed with g instead of f
+ * recover the convergence rate that they have at simple roots.
+ *
+ * Parameters : fx       - f(x).
+ *            : m        - Estimated multiplicity of the root.
+ *
+ * Returns    : g(x).
+ */
+static inline double deflate(const double fx, const double m) {
+  return m == 1 ? fx : copysign(pow(fabs(fx), 1 / m), fx);
+}
+
+// Last three iterates on each side of the root (g < 0 and g > 0), their
+// deflated function values, the last estimate of p, the number of
+// consecutive estimates of p that agree, and the last iterate, see
+// track_root
+typedef struct {
+  unsigned n[2], n_agree;
+  double x[2][3], g[2][3], p[2], x_last, f_last;
+} iterates;
+
+// Number of consecutive estimates of p that must agree before the
+// multiplicity is changed
+#define MULTIPLICITY_HOLD 3
+
+/*
+ * Function   : track_root
+ * Author     : Leo Werneck
+ *
+ * Updates the estimate of the multiplicity of the root, r->multiplicity,
+ * given a new iterate. If g = deflate(f) behaves as C (x - x*)^p, then
+ * p = g'^2/(g'^2 - g g''), which is estimated with divided differences at the
+ * middle of the last three iterates on the same side of the root. It is only
+ * used if |g| decreases slowly along them, i.e., the method converges
+ * linearly, as interpolation methods do at multiple roots; such iterates are
+ * close to each other compared to their distance to the root, so that the
+ * estimate is accurate. If MULTIPLICITY_HOLD consecutive estimates of p agree
+ * to 20% and differ from one by more than 10%, the multiplicity is
+ * multiplied by p (but kept >= 1) and the history restarts; a step that does
+ * not converge linearly breaks the sequence. Interpolation steps computed
+ * with the deflated function then converge as fast as at simple roots.
+ *
+ * Far from a simple root, f may look like a power of x - x*, e.g., when a
+ * cubic term dominates a small linear one, and deflating with that power
+ * near the root stalls the method. So as soon as a deflated step longer than
+ * the tolerance fails to reduce |f|, the multiplicity is reset to one.
+ *
+ * Parameters : it       - Last iterates (updated).
+ *            : x        - New iterate.
+ *            : fx       - f(x).
+ *            : deflated - Whether x is an interpolation step, computed from
+ *                         the deflated function values.
+ *            : r        - Pointer to roots library parameters (see roots.h).
+ *
+ * Returns    : Nothing.
+ *
+ * References : Traub, Iterative Methods for the Solution of Equations (1964)
+ */
+static inline void track_root(
+      iterates *restrict it,
+      const double x,
+      const double fx,
+      const bool deflated,
+      roots_params *restrict r) {
+
+  // Step 1: Undo the deflation if it did not reduce |f|
+  const double x_last = it->x_last, f_last = it->f_last;
+  it->x_last = x;
+  it->f_last = fx;
+  if(deflated && r->multiplicity > 1 && f_last != 0.0 && fabs(x - x_last) > r->tol
+     && fabs(fx) >= fabs(f_last)) {
+    r->multiplicity = 1;
+    it->n[0] = it->n[1] = it->n_agree = 0;
+    it->p[0] = it->p[1] = 0;
+    return;
+  }
+
+  // Step 2: Shift the history of this side of the root
+  if(fx == 0.0) {
+    return;
+  }
+  const int k = fx > 0;
+  double *restrict xs = it->x[k], *restrict gs = it->g[k];
+  xs[0] = xs[1];
+  gs[0] = gs[1];
+  xs[1] = xs[2];
+  gs[1] = gs[2];
+  xs[2] = x;
+  gs[2] = deflate(fx, r->multiplicity);
+  if(++it->n[k] < 3) {
+    return;
+  }
+
+  // Step 3: Check for slow convergence
+  const double q0 = gs[1] / gs[0];
+  const double q1 = gs[2] / gs[1];
+  if(!(q0 > 0.1 && q0 < 1 && q1 > 0.1 && q1 < 1)) {
+    it->n_agree = 0;
+    return;
+  }
+
+  // Step 4: Estimate g' and g'' at x1, then p
+  const double h0 = xs[1] - xs[0];
+  const double h1 = xs[2] - xs[1];
+  const double s0 = (gs[1] - gs[0]) / h0;
+  const double s1 = (gs[2] - gs[1]) / h1;
+  const double dg = (s0 * h1 + s1 * h0) / (h0 + h1);
+  const double d2g = 2 * (s1 - s0) / (h0 + h1);
+  const double p_old = it->p[k];
+  const double p = it->p[k] = dg * dg / (dg * dg - gs[1] * d2g);
+  if(!isfinite(p) || fabs(p - p_old) > 0.2 * p) {
+    it->n_agree = 0;
+    return;
+  }
+
+  // Step 5: Update the multiplicity
+  if((p > 1.1 || (p < 0.9 && r->multiplicity > 1))
+     && ++it->n_agree >= MULTIPLICITY_HOLD - 1) {
+    r->multiplicity = fmax(1, r->multiplicity * p);
+    it->n[0] = it->n[1] = it->n_agree = 0;
+    it->p[0] = it->p[1] = 0;
+  }
+}
+
 /***********************
  * Function prototypes *
  ***********************/
@@ -134,4 +672,25 @@ roots_error_t check_a_b_compute_fa_fb(
       double *restrict fb,
       roots_params *restrict r);
 
+// This function is implemented in roots_brent.c; it is not exported
+__attribute__((visibility("hidden"))) roots_error_t roots_brent_core(
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      double a,
+      double b,
+      double fa,
+      double fb,
+      roots_params *restrict r);
+
+// This function is implemented in solve_near.c
+roots_error_t solve_near(
+      roots_method method,
+      double f(const double, void *restrict),
+      void *restrict fparams,
+      const double a,
+      const double b,
+      double x,
+      double delta,
+      roots_params *restrict r);
+
 #endif  // UTILS_H_
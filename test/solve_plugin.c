@@ -0,0 +1,7 @@
+// Plugin for roots-solve: f(x;p) = x^3 - p, whose root is the cube root of p
+const unsigned roots_n_params = 1;
+
+double roots_f(const double x, void *restrict params) {
+  const double p = *(const double *)params;
+  return x * x * x - p;
+}
@@ -0,0 +1,57 @@
+#include "roots.h"
+
+// f(x) = exp(x) - 2; the auxiliary outputs are x and exp(x)
+typedef struct {
+  double x;
+  double e;
+} outputs;
+
+static unsigned n_calls = 0;
+
+double f(const double x, void *restrict params) {
+  (void)params;
+  return exp(x) - 2;
+}
+
+double f_aux(const double x, void *restrict params, void *restrict aux) {
+  (void)params;
+  outputs *out = (outputs *)aux;
+  out->x = x;
+  out->e = exp(x);
+  n_calls++;
+  return out->e - 2;
+}
+
+int main() {
+
+  // Step 1: The outputs at the root are handed back without evaluating f
+  //         again, i.e., with as many evaluations as a plain solve
+  const roots_method methods[] = { roots_bisection, roots_illinois, roots_ridder,
+                                   roots_brent, roots_toms748, roots_muller };
+  for(unsigned i = 0; i < sizeof(methods) / sizeof(*methods); i++) {
+    roots_params r = { 0 }, s = { 0 };
+    r.max_iters = s.max_iters = 300;
+    r.tol = s.tol = 1e-12;
+    methods[i](f, NULL, 0, 2, &s);
+    outputs out = { NAN, NAN };
+    n_calls = 0;
+    roots_solve_aux(methods[i], f_aux, NULL, 0, 2, sizeof(outputs), &out, &r);
+    roots_info(&r);
+    if(r.error_key != roots_success || r.root != s.root || r.n_evals != s.n_evals
+       || n_calls != r.n_evals || out.x != r.root || out.e != exp(r.root)) {
+      return 1;
+    }
+  }
+
+  // Step 2: The outputs are not set if the root is not bracketed
+  roots_params r = { 0 };
+  r.max_iters = 300;
+  r.tol = 1e-12;
+  outputs out = { NAN, NAN };
+  if(roots_solve_aux(roots_brent, f_aux, NULL, 1, 2, sizeof(outputs), &out, &r)
+     != roots_error_root_not_bracketed || !isnan(out.x)) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,38 @@
+#include "roots.h"
+
+double f(const double x, void *params) {
+  return log(x/1234.5);
+}
+
+int main() {
+
+  // Bisection on a bracket spanning 27 orders of magnitude
+  unsigned n_iters[3];
+  for(int m = 0; m < 3; m++) {
+    roots_params r;
+    roots_params_init(&r);
+    r.max_iters = 300;
+    r.tol = 1e-9;
+    r.bisect = m;
+    roots_bisection(f, NULL, 1e-12, 1e15, &r);
+    if(r.error_key != roots_success || fabs(r.root - 1234.5) > 1e-9) {
+      return 1;
+    }
+    n_iters[m] = r.n_iters;
+  }
+  if(n_iters[roots_bisect_log] > 64 || n_iters[roots_bisect_bits] > 64
+     || n_iters[roots_bisect_linear] <= n_iters[roots_bisect_log]) {
+    return 1;
+  }
+
+  // Brent's method with bisection fallback steps in log space
+  roots_params r;
+  roots_params_init(&r);
+  r.max_iters = 300;
+  r.tol = 1e-9;
+  r.bisect = roots_bisect_log;
+  roots_brent(f, NULL, 1e-12, 1e15, &r);
+  roots_info(&r);
+
+  return r.error_key;
+}
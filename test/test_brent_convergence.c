@@ -0,0 +1,46 @@
+#include "roots.h"
+
+// Brent's method must stop once the bracket is narrower than the tolerance;
+// testing the step from the previous iterate instead, as it used to, never
+// converges when the last steps are of the size of the tolerance.
+double quadratic(const double x, void *params) {
+  (void)params;
+  return x*x - 3;
+}
+
+double cubic(const double x, void *params) {
+  (void)params;
+  return x*x*x + x - 4;
+}
+
+double quartic(const double x, void *params) {
+  (void)params;
+  return x*x*x*x - 5;
+}
+
+typedef struct {
+  double (*f)(const double, void *);
+  double tol, root;
+} problem;
+
+int main() {
+
+  const problem problems[] = {
+    { quadratic, 1e-8, 1.7320508075688772 },
+    { cubic, 1e-8, 1.378796700129551 },
+    { cubic, 1e-12, 1.378796700129551 },
+    { quartic, 1e-10, 1.4953487812212205 },
+  };
+  for(unsigned i = 0; i < sizeof(problems) / sizeof(*problems); i++) {
+    roots_params r;
+    r.max_iters = 300;
+    r.tol = problems[i].tol;
+    roots_brent(problems[i].f, NULL, 0, 3, &r);
+    roots_info(&r);
+    if(r.error_key != roots_success || r.n_iters > 50
+       || fabs(r.root - problems[i].root) > problems[i].tol + 4e-16) {
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,71 @@
+#include <string.h>
+
+#include "roots.h"
+
+double f(const double x, void *params) {
+  return (x-1.234)*(x+111)*atan(x+50);
+}
+
+typedef roots_error_t (*method)(
+      double f(const double, void *restrict),
+      void *restrict,
+      double,
+      double,
+      roots_params *restrict);
+
+int main() {
+
+  const method methods[] = {
+    roots_bisection, roots_secant, roots_false_position, roots_illinois,
+    roots_pegasus, roots_anderson_bjorck, roots_dekker, roots_ridder,
+    roots_brent, roots_toms748, roots_steffensen, roots_muller,
+    roots_multipoint
+  };
+  const int n_methods = sizeof(methods) / sizeof(*methods);
+
+  // Step 1: Evaluation budget. Every method must stop after exactly max_evals
+  //         evaluations. All methods but the secant method (which does not
+  //         keep a bracket) must return an interval containing the root.
+  for(int i = 0; i < n_methods; i++) {
+    roots_params r;
+    roots_params_init(&r);
+    r.max_iters = 300;
+    r.tol  = 1e-15;
+    r.max_evals = 5;
+    methods[i](f, NULL, 200, 0, &r);
+    roots_info(&r);
+    if(r.error_key != roots_error_max_evals || r.n_evals != r.max_evals) {
+      return 1;
+    }
+    if(methods[i] != roots_secant && (r.bracket_a > 1.234 || r.bracket_b < 1.234)) {
+      return 1;
+    }
+  }
+
+  // Step 2: A deadline in the past stops the method right after the initial
+  //         evaluations.
+  roots_params r;
+  roots_params_init(&r);
+  r.max_iters = 300;
+  r.tol  = 1e-15;
+  r.deadline = roots_monotonic_time() - 1;
+  roots_brent(f, NULL, 200, 0, &r);
+  roots_info(&r);
+  if(r.error_key != roots_error_deadline || r.n_evals != 2) {
+    return 1;
+  }
+
+  // Step 3: The optional fields of a struct not set up by roots_params_init
+  //         are not used, whatever they hold
+  for(int i = 0; i < n_methods; i++) {
+    memset(&r, 0xff, sizeof(r));
+    r.max_iters = 300;
+    r.tol  = 1e-15;
+    methods[i](f, NULL, 200, 0, &r);
+    if(r.error_key != roots_success) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
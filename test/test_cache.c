@@ -0,0 +1,92 @@
+#include <string.h>
+#include <unistd.h>
+
+#include "roots.h"
+
+double f(const double x, void *params) {
+  const double p = *(const double *)params;
+  return (x-p)*(x+111);
+}
+
+// Solves the problem for p = 1.234 + 1e-9 i, i = 0, ..., 99, using the cache
+// if one is given; returns the total number of function evaluations, or 0 on
+// failure. The evaluations for the first problem are stored in first.
+unsigned solve(roots_cache *cache, unsigned *first) {
+
+  const double quantum = 1e-6;
+  unsigned n_evals = 0;
+  for(int i = 0; i < 100; i++) {
+    double p = 1.234 + 1e-9 * i;
+    roots_params r = { 0 };
+    r.max_iters = 300;
+    r.tol  = 1e-10;
+    if(cache) {
+      const uint64_t key = roots_cache_key(1, &p, &quantum);
+      roots_cached(roots_brent, f, &p, 200, 0, cache, key, &r);
+    }
+    else {
+      roots_brent(f, &p, 200, 0, &r);
+    }
+    if(r.error_key || fabs(r.root - p) > 1e-10) {
+      roots_info(&r);
+      return 0;
+    }
+    n_evals += r.n_evals;
+    if(!i) {
+      *first = r.n_evals;
+    }
+  }
+  return n_evals;
+}
+
+int main() {
+
+  char path[] = "/tmp/test_cache_XXXXXX";
+  const int fd = mkstemp(path);
+  if(fd < 0) {
+    return 1;
+  }
+  close(fd);
+
+  // Step 1: No cache, cold start, and warm start from the file. Only the
+  //         first problem of the cold start misses the cache.
+  unsigned none_first, cold_first, warm_first;
+  const unsigned none = solve(NULL, &none_first);
+  roots_cache *cache = roots_cache_open(path, 10);
+  const unsigned cold = solve(cache, &cold_first);
+  roots_cache_close(cache);
+  cache = roots_cache_open(path, 10);
+  const unsigned warm = solve(cache, &warm_first);
+  roots_cache_close(cache);
+
+  // Step 2: Files that are not caches, or caches with a corrupt capacity,
+  //         are not opened and are left untouched
+  FILE *fp = fopen(path, "r+");
+  if(!fp || fseek(fp, 8, SEEK_SET) || fwrite(&(uint64_t){ 3 }, 8, 1, fp) != 1) {
+    return 1;
+  }
+  fclose(fp);
+  const bool corrupt = roots_cache_open(path, 10) == NULL;
+  fp = fopen(path, "w");
+  fputs("not a cache\n", fp);
+  fclose(fp);
+  char line[32] = "";
+  const bool other = roots_cache_open(path, 10) == NULL;
+  fp = fopen(path, "r");
+  const bool untouched
+        = fp && fgets(line, sizeof(line), fp) && !strcmp(line, "not a cache\n");
+  if(fp) {
+    fclose(fp);
+  }
+  unlink(path);
+
+  // Step 3: Capacities beyond the documented maximum are rejected
+  const bool too_large
+        = !roots_cache_open(NULL, ROOTS_CACHE_MAX_LOG2_CAPACITY + 1)
+          && !roots_cache_open(NULL, 64);
+
+  printf("(roots) Evaluations: no cache %u, cold start %u, warm start %u\n", none, cold,
+         warm);
+  return !(none && cold && warm && cold < none && warm < none && warm_first < cold_first
+           && corrupt && other && untouched && too_large);
+}
@@ -0,0 +1,38 @@
+#include "roots.h"
+
+#ifdef restrict
+#error "roots.h must not leave restrict defined in C++"
+#endif
+
+// Kepler's equation, written once for doubles and dual numbers
+template<typename T> T kepler(const T x) {
+  using std::sin;
+  return x - 0.9 * sin(x) - 1;
+}
+
+static roots_dual f(const roots_dual x, void *) {
+  return kepler(x);
+}
+
+int main() {
+
+  // The derivative must match the analytic one
+  const roots_dual y = kepler(roots_dual_var(2.0));
+  if(y.v != kepler(2.0) || std::fabs(y.d - (1 - 0.9 * std::cos(2.0))) > 1e-15) {
+    return 1;
+  }
+
+  // Powers have the value of pow also where u^(p-1) is not finite
+  const roots_dual z = pow(roots_dual_var(0.0), 0.5), w = pow(roots_dual_var(4.0), 0.5);
+  if(z.v != 0 || w.v != 2 || w.d != 0.25 || pow(roots_dual_var(0.0), 0.0).d != 0) {
+    return 1;
+  }
+
+  roots_params r = {};
+  r.max_iters = 300;
+  r.tol = 1e-12;
+  roots_newton(f, NULL, 0, 3, &r);
+  roots_info(&r);
+
+  return r.error_key != roots_success || std::fabs(kepler(r.root)) > 1e-12;
+}
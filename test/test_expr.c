@@ -0,0 +1,101 @@
+#include "roots.h"
+
+double f(const double x, void *params) {
+  const double *p = (const double *)params;
+  return x - p[0] * sin(x) - p[1];
+}
+
+int main() {
+
+  // Step 1: Syntax errors are reported with their position
+  int pos;
+  if(roots_expr_compile("x + * 2", 0, NULL, &pos) || pos != 4) {
+    return 1;
+  }
+  if(roots_expr_compile("x + foo(x)", 0, NULL, &pos) || pos != 4) {
+    return 1;
+  }
+
+  // Step 2: Folding and sharing: 2*pi*x is one product, sin(x) is computed
+  //         once, and x^4 is two products.
+  const char *formulas[] = { "2*pi*x", "sin(x)*sin(x) + sin(x)", "x^4 - (x*x)*(x*x)" };
+  const unsigned sizes[] = { 1, 3, 3 };
+  for(int k = 0; k < 3; k++) {
+    roots_expr *e = roots_expr_compile(formulas[k], 0, NULL, NULL);
+    if(!e || roots_expr_size(e) != sizes[k]) {
+      return 1;
+    }
+    roots_expr_free(e);
+  }
+
+  // Step 3: Kepler's equation; the expression agrees with the callback at
+  //         single points, in blocks, and when solving (up to rounding, as
+  //         the compiler may contract the callback's operations).
+  const char *names[] = { "e", "M" };
+  const double p[] = { 0.9, 1 };
+  roots_expr *e = roots_expr_compile("x - e*sin(x) - M", 2, names, &pos);
+  if(!e || pos != -1) {
+    return 1;
+  }
+  roots_expr_params ep = { e, p };
+  const unsigned n = 1000;
+  double x[1000], fx[1000];
+  for(unsigned i = 0; i < n; i++) {
+    x[i] = -5 + 10.0 * i / n;
+  }
+  roots_expr_fv(n, x, &ep, fx);
+  for(unsigned i = 0; i < n; i++) {
+    if(fabs(fx[i] - f(x[i], (void *)p)) > 1e-14 || roots_expr_f(x[i], &ep) != fx[i]) {
+      return 1;
+    }
+  }
+
+  roots_params r = { 0 }, s = { 0 };
+  r.max_iters = s.max_iters = 300;
+  r.tol = s.tol = 1e-15;
+  roots_brent(f, (void *)p, 0, 3, &r);
+  roots_brent(roots_expr_f, &ep, 0, 3, &s);
+  if(s.error_key != roots_success || fabs(s.root - r.root) > 1e-14) {
+    return 1;
+  }
+  roots_info(&s);
+
+  // Step 4: Batched evaluation
+  double a[16], b[16], root[16];
+  for(int i = 0; i < 16; i++) {
+    a[i] = -1 - i;
+    b[i] = 3 + i;
+  }
+  roots_chandrupatla_batch(roots_expr_fv, &ep, 16, a, b, root, &r);
+  for(int i = 0; i < 16; i++) {
+    if(r.error_key != roots_success || fabs(root[i] - s.root) > 1e-12) {
+      return 1;
+    }
+  }
+  roots_expr_free(e);
+
+  // Step 5: Formulas too large for the stack; sum of (k + 0.5) x
+  const unsigned n_terms = 20000;
+  char *formula = malloc(16 * n_terms);
+  unsigned len = sprintf(formula, "-1");
+  for(unsigned k = 0; k < n_terms; k++) {
+    len += sprintf(formula + len, "+%u.5*x", k);
+  }
+  e = roots_expr_compile(formula, 0, NULL, NULL);
+  free(formula);
+  if(!e) {
+    return 1;
+  }
+  ep.expr = e;
+  roots_expr_fv(n, x, &ep, fx);
+  for(unsigned i = 0; i < n; i++) {
+    const double exact = 0.5 * n_terms * (double)n_terms * x[i] - 1;
+    if(fabs(fx[i] - exact) > 1e-9 * fabs(exact) + 1e-6
+       || roots_expr_f(x[i], &ep) != fx[i]) {
+      return 1;
+    }
+  }
+  roots_expr_free(e);
+
+  return 0;
+}
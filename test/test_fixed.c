@@ -0,0 +1,59 @@
+#include "roots.h"
+
+double f(const double x, void *params) {
+  return (x-1.234)*(x+111);
+}
+
+// Vectorized f for p[i] = 1.234 + i
+void fv(
+      const unsigned n,
+      const double *restrict x,
+      void *restrict params,
+      double *restrict fx) {
+  for(unsigned i = 0; i < n; i++) {
+    fx[i] = (x[i]-1.234-i)*(x[i]+111);
+  }
+}
+
+int main() {
+
+  const roots_method methods[] = {
+    roots_bisection_fixed, roots_ridder_fixed, roots_chandrupatla_fixed
+  };
+  roots_error_t (*const batch[])(
+        roots_vector_function, void *restrict, const unsigned, const double *restrict,
+        const double *restrict, double *restrict, roots_params *restrict) = {
+    roots_bisection_batch, roots_ridder_batch, roots_chandrupatla_batch
+  };
+
+  for(int k = 0; k < 3; k++) {
+
+    // Step 1: Scalar solve; the number of iterations only depends on the
+    //         interval and the tolerance.
+    roots_params r = { 0 };
+    r.max_iters = 300;
+    r.tol  = 1e-10;
+    methods[k](f, NULL, 200, 0, &r);
+    roots_info(&r);
+    if(r.error_key || fabs(r.root - 1.234) > 1e-10
+       || r.n_iters != roots_fixed_iterations(200, 0, 1e-10)) {
+      return 1;
+    }
+
+    // Step 2: Batch solve
+    double a[16], b[16], root[16];
+    for(int i = 0; i < 16; i++) {
+      a[i] = 0;
+      b[i] = 200;
+    }
+    batch[k](fv, NULL, 16, a, b, root, &r);
+    roots_info(&r);
+    for(int i = 0; i < 16; i++) {
+      if(r.error_key || fabs(root[i] - 1.234 - i) > 1e-10) {
+        return 1;
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,65 @@
+#include "roots.h"
+
+double g(const double x, void *params) {
+  return cos(x);
+}
+
+// Coupled nonlinear system whose Jacobian has spectral radius close to 0.95,
+// so that plain iteration converges slowly
+void h(
+      const unsigned n,
+      const double *restrict x,
+      void *restrict params,
+      double *restrict gx) {
+  for(unsigned i = 0; i < n; i++) {
+    const double left = i > 0 ? x[i - 1] : 0;
+    const double right = i < n - 1 ? x[i + 1] : 0;
+    gx[i] = 0.45 * (left + right) + 0.05 * sin(x[i]) + 1;
+  }
+}
+
+int main() {
+
+  // Scalar problem: x = cos(x)
+  roots_params r, t;
+  roots_params_init(&r);
+  roots_params_init(&t);
+  r.max_iters = t.max_iters = 1000;
+  r.tol = t.tol = 1e-12;
+  roots_fixed_point_scalar(g, NULL, 1, 0, 1, &t);
+  roots_fixed_point_scalar(g, NULL, 1, 1, 1, &r);
+  roots_info(&r);
+  if(r.error_key != roots_success || t.error_key != roots_success
+     || fabs(r.root - 0.7390851332151607) > 1e-11 || 4 * r.n_evals > t.n_evals) {
+    return 1;
+  }
+
+  // System of 8 unknowns, with plain and damped iterations for reference
+  enum { n = 8 };
+  double x[n] = { 0 }, y[n] = { 0 }, z[n] = { 0 }, gx[n];
+  roots_fixed_point(h, NULL, n, 0, 1, y, &t);
+  const unsigned n_plain = t.n_evals;
+  roots_fixed_point(h, NULL, n, 0, 0.8, z, &t);
+  roots_fixed_point(h, NULL, n, 5, 1, x, &r);
+  roots_info(&r);
+  h(n, x, NULL, gx);
+  for(unsigned i = 0; i < n; i++) {
+    if(fabs(gx[i] - x[i]) > 1e-11 || fabs(x[i] - y[i]) > 1e-9
+       || fabs(x[i] - z[i]) > 1e-9) {
+      return 1;
+    }
+  }
+  if(r.error_key != roots_success || 4 * r.n_evals > n_plain) {
+    return 1;
+  }
+
+  // Budget
+  double w[n] = { 0 };
+  r.max_evals = 3;
+  if(roots_fixed_point(h, NULL, n, 5, 1, w, &r) != roots_error_max_evals
+     || r.n_evals != 3) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,70 @@
+#include "roots.h"
+
+#define NX 40
+#define NY 30
+#define NZ 3
+
+// f(x; p) = x^3 - p, with p smooth over the grid except across a jump
+double f(const double x, void *restrict params) {
+  return x * x * x - *(const double *)params;
+}
+
+int main() {
+
+  static double p[NZ][NY][NX], a[NZ][NY][NX], b[NZ][NY][NX], root[2][NZ][NY][NX];
+  for(int k = 0; k < NZ; k++) {
+    for(int j = 0; j < NY; j++) {
+      for(int i = 0; i < NX; i++) {
+        p[k][j][i] = 2 + sin(0.1 * i) * cos(0.07 * j) + 0.3 * k + (i >= 25 ? 20 : 0);
+        a[k][j][i] = 0;
+        b[k][j][i] = 10;
+      }
+    }
+  }
+  a[1][5][5] = 5; // Not bracketed
+
+  // Step 1: Solve with and without a thread pool; the results are the same
+  roots_thread_pool *pool = roots_thread_pool_create(2);
+  roots_grid_stats st[2];
+  for(int t = 0; t < 2; t++) {
+    roots_params r = { 0 };
+    r.max_iters = 300;
+    r.tol = 1e-12;
+    const roots_error_t key = roots_solve_grid(
+          roots_brent, f, p, sizeof(double), NX, NY, NZ, &a[0][0][0], &b[0][0][0],
+          &root[t][0][0][0], t ? pool : NULL, &st[t], &r);
+    printf("%lu cells, %lu seeds, %lu narrow, %lu fallback, %lu evaluations, "
+           "%.1f%% saved\n",
+           st[t].n_cells, st[t].n_seeds, st[t].n_narrow, st[t].n_fallback, st[t].n_evals,
+           100 * st[t].savings);
+    if(key != roots_error_root_not_bracketed || r.n_evals != st[t].n_evals
+       || st[t].n_cells != NX * NY * NZ
+       || st[t].n_seeds + st[t].n_narrow + st[t].n_fallback != st[t].n_cells
+       || st[t].n_fallback == 0 || !(st[t].savings > 0.3)) {
+      return 1;
+    }
+  }
+  roots_thread_pool_destroy(pool);
+  if(st[0].n_evals != st[1].n_evals || st[0].n_narrow != st[1].n_narrow) {
+    return 1;
+  }
+
+  // Step 2: Check the roots
+  for(int k = 0; k < NZ; k++) {
+    for(int j = 0; j < NY; j++) {
+      for(int i = 0; i < NX; i++) {
+        const double x = root[0][k][j][i];
+        if(k == 1 && j == 5 && i == 5) {
+          if(!isnan(x) || !isnan(root[1][k][j][i])) {
+            return 1;
+          }
+        }
+        else if(fabs(x - cbrt(p[k][j][i])) > 1e-11 || x != root[1][k][j][i]) {
+          return 1;
+        }
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,76 @@
+#include "roots.h"
+
+// Problems that are slow for some methods (see adversarial_corpus.txt), and
+// smooth problems with simple and multiple roots
+typedef struct {
+  double (*f)(const double, void *restrict);
+  double a, b, tol;
+} problem;
+
+double cubic(const double x, void *restrict params) {
+  (void)params;
+  return pow(x + 0.2, 3) + 0.0525 * (x + 0.2);
+}
+
+double power(const double x, void *restrict params) {
+  (void)params;
+  return (x - 2) * pow(fabs(x - 2), 2.4) + 0.0005;
+}
+
+double exponential(const double x, void *restrict params) {
+  (void)params;
+  return exp(3.98 * x) - 0.18;
+}
+
+double steep(const double x, void *restrict params) {
+  (void)params;
+  return pow(x, 25) - 0.003;
+}
+
+double step(const double x, void *restrict params) {
+  (void)params;
+  return x < 0.3 ? -1 : 1;
+}
+
+double triple(const double x, void *restrict params) {
+  (void)params;
+  return pow(x - 1, 3);
+}
+
+double kepler(const double x, void *restrict params) {
+  (void)params;
+  return x - 0.5 * sin(x) - 1;
+}
+
+int main() {
+
+  // Step 1: The number of evaluations is at most about twice that of
+  //         bisection, i.e., log2((b-a)/tol)
+  const problem slow[] = {
+    { cubic, -9.93, 8.426, 6e-9 },    { power, -1, 16, 3.1e-5 },
+    { exponential, -9, 1.655, 1e-4 }, { steep, -5, 20, 9e-5 },
+    { step, -3, 2, 1e-12 },           { triple, -3, 2, 1e-12 },
+  };
+  for(unsigned i = 0; i < sizeof(slow) / sizeof(*slow); i++) {
+    roots_params r = { 0 };
+    r.max_iters = 1000;
+    r.tol = slow[i].tol;
+    roots_hybrid(slow[i].f, NULL, slow[i].a, slow[i].b, &r);
+    roots_info(&r);
+    if(r.error_key != roots_success
+       || r.n_evals > 2 * ceil(log2((slow[i].b - slow[i].a) / slow[i].tol)) + 12) {
+      return 1;
+    }
+  }
+
+  // Step 2: Smooth problems keep the convergence of interpolation
+  roots_params r = { 0 };
+  r.max_iters = 1000;
+  r.tol = 1e-12;
+  roots_hybrid(kepler, NULL, 0, 4, &r);
+  roots_info(&r);
+  if(r.error_key != roots_success || r.n_evals > 10) {
+    return 1;
+  }
+  return 0;
+}
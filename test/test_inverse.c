@@ -0,0 +1,48 @@
+#include "roots.h"
+
+double f(const double x, void *params) {
+  return (x-1.234)*(x+111);
+}
+
+double g(const double x, void *params) {
+  return exp(x) - 1;
+}
+
+int main() {
+
+  // Targets f(x) for x = 0.5, 1.0, ..., 100
+  double x[200], y[200];
+  for(int i = 0; i < 200; i++) {
+    y[i] = f(0.5 * (i + 1), NULL);
+  }
+
+  roots_params r = { 0 };
+  r.max_iters = 300;
+  r.tol  = 1e-10;
+  roots_inverse(f, NULL, 200, 0, 200, y, x, &r);
+  roots_info(&r);
+
+  for(int i = 0; i < 200; i++) {
+    if(fabs(x[i] - 0.5 * (i + 1)) > 1e-10) {
+      return 1;
+    }
+  }
+
+  if(r.error_key != roots_success) {
+    return 1;
+  }
+
+  // Brent's method on the nodes interpolates, i.e., does not fall back to
+  // bisection (about 150 evaluations)
+  const double z[3] = { -0.5, 2, 100 };
+  roots_params t;
+  t.max_iters = 300;
+  t.tol = 1e-13;
+  roots_inverse(g, NULL, -5, 10, 3, z, x, &t);
+  roots_info(&t);
+  if(t.error_key != roots_success || t.n_evals > 50) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,28 @@
+#include "roots.h"
+
+double f(const double x, void *params) {
+  return (x-1.234)*(x+111);
+}
+
+int main() {
+
+  roots_params r = { 0 };
+  r.max_iters = 300;
+  r.tol  = 1e-10;
+  roots_thread_pool *pool = roots_thread_pool_create(4);
+  roots_ksection(f, NULL, 200, 0, 7, pool, &r);
+  roots_info(&r);
+  if(r.error_key) {
+    return 1;
+  }
+
+  // The number of points per round is bounded, however large k is
+  roots_params t = { 0 };
+  t.max_iters = 300;
+  t.tol  = 1e-10;
+  roots_ksection(f, NULL, 200, 0, 100000000, pool, &t);
+  roots_thread_pool_destroy(pool);
+  roots_info(&t);
+
+  return t.error_key || fabs(t.root - 1.234) > 1e-10;
+}
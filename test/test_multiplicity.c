@@ -0,0 +1,67 @@
+#include "roots.h"
+
+// Triple root at x = 1
+double f(const double x, void *params) {
+  const double y = x - 1;
+  return y * y * y;
+}
+
+// Simple roots at x = -0.2 and x = -1.727 where f looks like a cubic away
+// from the root
+double g(const double x, void *params) {
+  return pow(x + 0.2, 3) + 0.0525 * (x + 0.2);
+}
+
+double h(const double x, void *params) {
+  return pow(x + 1.727, 3) + 4e-6 * (x + 1.727);
+}
+
+int main() {
+
+  // Step 1: The multiplicity of the triple root is found
+  const roots_method methods[]
+        = { roots_secant, roots_false_position, roots_dekker, roots_brent };
+  for(int i = 0; i < 4; i++) {
+    roots_params r = { 0 };
+    r.max_iters = 300;
+    r.tol = 1e-12;
+    methods[i](f, NULL, 0, 3.3, &r);
+    roots_info(&r);
+    if(r.error_key != roots_success || fabs(r.root - 1) > 1e-10 || r.n_iters > 50
+       || fabs(r.multiplicity - 3) > 0.5) {
+      return 1;
+    }
+  }
+
+  // Step 2: Simple roots keep multiplicity one, and the secant and Brent's
+  //         methods take no more iterations than without deflation. A zero
+  //         limit skips the check; false position stalls on the wide
+  //         interval with or without deflation.
+  const struct {
+    double (*f)(const double, void *);
+    double a, b, root;
+    unsigned max_iters[4];
+  } simple[] = {
+    { g, -1, 1, -0.2, { 11, 300, 300, 14 } },
+    { g, -9.93, 8.426, -0.2, { 14, 0, 300, 21 } },
+    { h, -10.283, 3.93, -1.727, { 33, 300, 300, 39 } },
+  };
+  for(int k = 0; k < 3; k++) {
+    for(int i = 0; i < 4; i++) {
+      roots_params r = { 0 };
+      r.max_iters = 300;
+      r.tol = 1e-12;
+      methods[i](simple[k].f, NULL, simple[k].a, simple[k].b, &r);
+      if(r.multiplicity != 1) {
+        return 1;
+      }
+      if(simple[k].max_iters[i]
+         && (r.error_key != roots_success || fabs(r.root - simple[k].root) > 1e-10
+             || r.n_iters > simple[k].max_iters[i])) {
+        return 1;
+      }
+    }
+  }
+
+  return 0;
+}
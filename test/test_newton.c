@@ -0,0 +1,44 @@
+#include "roots.h"
+
+roots_dual f(const roots_dual x, void *params) {
+  return roots_dual_mul(roots_dual_shift(x, -1.234), roots_dual_shift(x, 111));
+}
+
+// Kepler's equation
+roots_dual g(const roots_dual x, void *params) {
+  const roots_dual e_sin_x = roots_dual_scale(0.9, roots_dual_sin(x));
+  return roots_dual_shift(roots_dual_sub(x, e_sin_x), -1);
+}
+
+double h(const double x, void *params) {
+  return x - 0.9*sin(x) - 1;
+}
+
+int main() {
+
+  // The first Newton step is taken from the better end point, whichever it
+  // is, using the derivative computed there
+  roots_params r = { 0 };
+  r.max_iters = 300;
+  r.tol = 1e-10;
+  for(int k = 0; k < 2; k++) {
+    roots_newton(f, NULL, k ? 0 : 200, k ? 200 : 0, &r);
+    roots_info(&r);
+    if(r.error_key != roots_success || fabs(r.root - 1.234) > 1e-10 || r.n_evals > 7) {
+      return 1;
+    }
+  }
+
+  roots_params t = { 0 };
+  r.tol = t.tol = 1e-12;
+  t.max_iters = 300;
+  roots_newton(g, NULL, 0, 3, &r);
+  roots_brent(h, NULL, 0, 3, &t);
+  roots_info(&r);
+  if(r.error_key != roots_success || fabs(r.root - t.root) > 1e-12
+     || r.n_evals > t.n_evals) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,73 @@
+#include "roots.h"
+
+// f(x; p) = x^3 - p, written as a polynomial whose coefficients are computed
+// once per problem
+typedef struct {
+  int id;
+  double p;
+} problem;
+
+typedef struct {
+  double c[4];
+} cubic;
+
+static unsigned n_prepared = 0;
+
+void prepare(const void *restrict params, void *restrict scratch) {
+  const problem *pb = (const problem *)params;
+  cubic *s = (cubic *)scratch;
+  s->c[0] = -pb->p;
+  s->c[1] = s->c[2] = 0;
+  s->c[3] = 1;
+  __atomic_fetch_add(&n_prepared, 1, __ATOMIC_RELAXED);
+}
+
+double eval(const double x, void *restrict scratch) {
+  const cubic *s = (const cubic *)scratch;
+  return ((s->c[3] * x + s->c[2]) * x + s->c[1]) * x + s->c[0];
+}
+
+int main() {
+
+  const roots_prepared_function pf = { sizeof(cubic), prepare, eval };
+
+  // Step 1: Single solve; prepare runs once
+  roots_params r = { 0 };
+  r.max_iters = 300;
+  r.tol = 1e-12;
+  problem pb = { 0, 2 };
+  roots_solve_prepared(roots_brent, &pf, &pb, 0, 3, &r);
+  roots_info(&r);
+  if(r.error_key != roots_success || fabs(r.root - cbrt(2)) > 1e-12 || n_prepared != 1) {
+    return 1;
+  }
+
+  // Step 2: Batch solve with and without a thread pool; the last problem is
+  //         not bracketed
+  enum { n = 100 };
+  problem pbs[n];
+  double a[n], b[n], root[n];
+  for(int i = 0; i < n; i++) {
+    pbs[i].id = i;
+    pbs[i].p = 1 + i;
+    a[i] = 0;
+    b[i] = i < n - 1 ? 5 : 4;
+  }
+  roots_thread_pool *pool = roots_thread_pool_create(2);
+  for(int k = 0; k < 2; k++) {
+    n_prepared = 0;
+    const roots_error_t key = roots_solve_prepared_batch(
+          roots_brent, &pf, pbs, sizeof(problem), n, a, b, root, k ? pool : NULL, &r);
+    if(key != roots_error_root_not_bracketed || n_prepared != n || !isnan(root[n - 1])) {
+      return 1;
+    }
+    for(int i = 0; i < n - 1; i++) {
+      if(fabs(root[i] - cbrt(pbs[i].p)) > 1e-11) {
+        return 1;
+      }
+    }
+  }
+  roots_thread_pool_destroy(pool);
+
+  return 0;
+}
@@ -0,0 +1,113 @@
+#include "roots.h"
+
+// Kepler's equation, f(x; e, M) = x - e sin(x) - M
+typedef struct {
+  double e, M;
+} kepler;
+
+double f(const double x, void *params) {
+  const kepler *k = (const kepler *)params;
+  return x - k->e * sin(x) - k->M;
+}
+
+roots_dual g(const roots_dual x, void *params) {
+  const kepler *k = (const kepler *)params;
+  const roots_dual e_sin_x = roots_dual_scale(k->e, roots_dual_sin(x));
+  return roots_dual_shift(roots_dual_sub(x, e_sin_x), -k->M);
+}
+
+void dfdp(const double x, void *params, const unsigned n, double *dfdp) {
+  dfdp[0] = -sin(x);
+  dfdp[1] = -1;
+}
+
+// Cube roots of p[i] = 1 + i
+void fv(
+      const unsigned n,
+      const double *restrict x,
+      void *restrict params,
+      double *restrict fx) {
+  for(unsigned i = 0; i < n; i++) {
+    fx[i] = x[i] * x[i] * x[i] - 1 - i;
+  }
+}
+
+void dfdxv(
+      const unsigned n,
+      const double *restrict x,
+      void *restrict params,
+      double *restrict df) {
+  for(unsigned i = 0; i < n; i++) {
+    df[i] = 3 * x[i] * x[i];
+  }
+}
+
+void dfdpv(
+      const unsigned n,
+      const double *restrict x,
+      void *restrict params,
+      double *restrict df) {
+  for(unsigned i = 0; i < n; i++) {
+    df[i] = -1;
+  }
+}
+
+int main() {
+
+  // Step 1: Scalar solves; dx/de = sin(x)/(1 - e cos(x)), dx/dM = 1/(1 - e cos(x))
+  const roots_method methods[]
+        = { roots_bisection, roots_secant, roots_ridder, roots_brent, roots_toms748 };
+  kepler k = { 0.9, 1 };
+  roots_recent recent;
+  for(int m = 0; m <= 5; m++) {
+    roots_params r;
+    roots_params_init(&r);
+    r.recent = &recent;
+    r.max_iters = 300;
+    r.tol = 1e-12;
+    if(m < 5) {
+      methods[m](f, &k, 0, 3, &r);
+    }
+    else {
+      roots_newton(g, &k, 0, 3, &r);
+    }
+    roots_info(&r);
+    double dxdp[2];
+    roots_sensitivity(&r, dfdp, &k, 2, dxdp);
+    const double den = 1 - k.e * cos(r.root);
+    if(r.error_key != roots_success || fabs(dxdp[0] * den / sin(r.root) - 1) > 1e-4
+       || fabs(dxdp[1] * den - 1) > 1e-4) {
+      return 1;
+    }
+  }
+
+  // Without r.recent, f' is not estimated
+  roots_params s;
+  s.max_iters = 300;
+  s.tol = 1e-12;
+  roots_brent(f, &k, 0, 3, &s);
+  if(s.error_key != roots_success || !isnan(s.dfdx)) {
+    return 1;
+  }
+
+  // Step 2: Batch solve, with f' estimated and given
+  double a[16], b[16], root[16], dxdp[16], dxdp_exact[16];
+  for(int i = 0; i < 16; i++) {
+    a[i] = 0;
+    b[i] = 3;
+  }
+  roots_params r = { 0 };
+  r.max_iters = 300;
+  r.tol = 1e-12;
+  roots_chandrupatla_batch(fv, NULL, 16, a, b, root, &r);
+  roots_sensitivity_batch(fv, NULL, dfdpv, NULL, 16, root, dxdp);
+  roots_sensitivity_batch(fv, dfdxv, dfdpv, NULL, 16, root, dxdp_exact);
+  for(int i = 0; i < 16; i++) {
+    const double exact = 1 / (3 * root[i] * root[i]);
+    if(fabs(dxdp[i] / exact - 1) > 1e-8 || fabs(dxdp_exact[i] / exact - 1) > 1e-14) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+#include <pthread.h>
+
+#include "roots.h"
+
+#define N_PRODUCERS 3
+#define N_REQUESTS 200
+
+double f(const double x, void *params) {
+  return (x - *(const double *)params) * (x + 111);
+}
+
+typedef struct {
+  roots_service *s;
+  double roots[N_REQUESTS];
+  roots_request req[N_REQUESTS];
+  unsigned n_callbacks;
+} producer;
+
+static void completed(roots_request *req, void *arg) {
+  (void)req;
+  __atomic_fetch_add(&((producer *)arg)->n_callbacks, 1, __ATOMIC_RELAXED);
+}
+
+// Submits requests alternating between futures and callbacks; waits for the
+// futures only.
+static void *produce(void *arg) {
+  producer *p = (producer *)arg;
+  for(int i = 0; i < N_REQUESTS; i++) {
+    roots_request *req = &p->req[i];
+    *req = (roots_request){ .method = i % 2 ? roots_brent : roots_ridder, .f = f };
+    req->fparams = &p->roots[i];
+    req->a = 0;
+    req->b = 200;
+    req->r.max_iters = 300;
+    req->r.tol = 1e-10;
+    req->callback = i % 2 ? completed : NULL;
+    req->callback_arg = p;
+    while(!roots_service_submit(p->s, req)) {
+      sched_yield();
+    }
+  }
+  for(int i = 0; i < N_REQUESTS; i += 2) {
+    roots_service_wait(p->s, &p->req[i]);
+  }
+  return NULL;
+}
+
+int main() {
+
+  // A queue of a single cell and shifts past 63 bits are rejected
+  if(roots_service_create(4, 0) || roots_service_create(4, 64)) {
+    return 1;
+  }
+
+  roots_service *s = roots_service_create(4, 6);
+  static producer p[N_PRODUCERS];
+  pthread_t threads[N_PRODUCERS];
+  for(int k = 0; k < N_PRODUCERS; k++) {
+    p[k].s = s;
+    for(int i = 0; i < N_REQUESTS; i++) {
+      p[k].roots[i] = 1 + k + 0.01 * i;
+    }
+    pthread_create(&threads[k], NULL, produce, &p[k]);
+  }
+  for(int k = 0; k < N_PRODUCERS; k++) {
+    pthread_join(threads[k], NULL);
+  }
+
+  // Destroying the service completes the requests with callbacks
+  roots_service_stats st;
+  roots_service_get_stats(s, &st);
+  roots_service_destroy(s);
+  printf("Submitted %lu, completed %lu, rejected %lu, max depth %lu\n",
+         (unsigned long)st.n_submitted, (unsigned long)st.n_completed,
+         (unsigned long)st.n_rejected, (unsigned long)st.max_queue_depth);
+  printf("Submit latency %.3g s (max %.3g s), queue wait %.3g s, utilization %.2f\n",
+         st.mean_submit_latency, st.max_submit_latency, st.mean_queue_wait,
+         st.utilization);
+  if(st.n_submitted != N_PRODUCERS * N_REQUESTS
+     || st.max_queue_depth > 64 + N_PRODUCERS) {
+    return 1;
+  }
+
+  for(int k = 0; k < N_PRODUCERS; k++) {
+    if(p[k].n_callbacks != N_REQUESTS / 2) {
+      return 1;
+    }
+    for(int i = 0; i < N_REQUESTS; i++) {
+      const roots_request *req = &p[k].req[i];
+      if(!roots_service_done(req) || req->r.error_key != roots_success
+         || fabs(req->r.root - p[k].roots[i]) > 1e-9) {
+        return 1;
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,138 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "roots.h"
+
+#define N_CLIENTS 3
+#define N_BATCHES 20
+#define CAPACITY 50
+
+double f(const double x, void *restrict params) {
+  return x * x * x - *(const double *)params;
+}
+
+// Solves N_BATCHES batches of cube roots, keeping two batches in flight
+static int client(const char *path) {
+
+  roots_shm_client *c = roots_shm_connect(path);
+  if(!c) {
+    return 1;
+  }
+  roots_shm_batch batch[N_BATCHES];
+  for(int k = 0; k < N_BATCHES; k++) {
+    if(k >= 2) {
+      roots_shm_batch *old = &batch[k - 2];
+      if(roots_shm_wait(c, old) != roots_success) {
+        return 1;
+      }
+      for(unsigned i = 0; i < old->n; i++) {
+        if(fabs(old->root[i] - cbrt(old->params[i])) > 1e-11) {
+          return 1;
+        }
+      }
+      roots_shm_release(c, old);
+    }
+    if(!roots_shm_acquire(c, &batch[k]) || batch[k].capacity != CAPACITY) {
+      return 1;
+    }
+    batch[k].n = CAPACITY;
+    for(unsigned i = 0; i < CAPACITY; i++) {
+      batch[k].params[i] = 1 + i + k;
+      batch[k].a[i] = 0;
+      batch[k].b[i] = 10;
+    }
+    roots_shm_submit(c, &batch[k]);
+  }
+
+  // The last batch has a problem that is not bracketed
+  roots_shm_wait(c, &batch[N_BATCHES - 2]);
+  roots_shm_release(c, &batch[N_BATCHES - 2]);
+  roots_shm_wait(c, &batch[N_BATCHES - 1]);
+  roots_shm_release(c, &batch[N_BATCHES - 1]);
+  roots_shm_batch last;
+  roots_shm_acquire(c, &last);
+  last.n = 1;
+  last.params[0] = 2000;
+  last.a[0] = 0;
+  last.b[0] = 10;
+  roots_shm_submit(c, &last);
+  if(roots_shm_wait(c, &last) != roots_error_root_not_bracketed || !isnan(last.root[0])
+     || last.error_key[0] != roots_error_root_not_bracketed) {
+    return 1;
+  }
+  roots_shm_release(c, &last);
+
+  roots_shm_stats st;
+  roots_shm_get_stats(c, &st);
+  roots_shm_disconnect(c);
+  return !st.connected || st.n_batches != N_BATCHES + 1
+         || st.n_problems != N_BATCHES * CAPACITY + 1 || !(st.throughput > 0);
+}
+
+int main() {
+
+  // Step 1: Start the server
+  char path[64];
+  sprintf(path, "/tmp/roots-test-shm-%d", (int)getpid());
+  roots_params r = { 0 };
+  r.max_iters = 300;
+  r.tol = 1e-12;
+  roots_shm_server *s = roots_shm_server_create(
+        path, N_CLIENTS, 2, CAPACITY, 1, 2, roots_brent, f, &r);
+  if(!s) {
+    return 1;
+  }
+
+  // Step 2: Solve batches from several processes
+  pid_t pid[N_CLIENTS];
+  for(int i = 0; i < N_CLIENTS; i++) {
+    pid[i] = fork();
+    if(pid[i] == 0) {
+      _exit(client(path));
+    }
+  }
+  int failed = 0;
+  for(int i = 0; i < N_CLIENTS; i++) {
+    int status;
+    waitpid(pid[i], &status, 0);
+    failed |= !WIFEXITED(status) || WEXITSTATUS(status);
+  }
+
+  // Step 3: Check the counters of every client
+  for(unsigned i = 0; i < N_CLIENTS; i++) {
+    roots_shm_stats st;
+    if(!roots_shm_server_get_stats(s, i, &st) || st.connected
+       || st.n_problems != N_BATCHES * CAPACITY + 1) {
+      failed = 1;
+    }
+    printf("Client %u: %lu batches, %lu problems, %.3e problems/s\n", i,
+           (unsigned long)st.n_batches, (unsigned long)st.n_problems, st.throughput);
+  }
+  roots_shm_stats st;
+  failed |= roots_shm_server_get_stats(s, N_CLIENTS, &st);
+
+  // Step 4: The server accepts at most N_CLIENTS clients at once
+  roots_shm_client *c[N_CLIENTS + 1];
+  for(int i = 0; i <= N_CLIENTS; i++) {
+    c[i] = roots_shm_connect(path);
+  }
+  failed |= !c[N_CLIENTS - 1] || c[N_CLIENTS] != NULL;
+  for(int i = 0; i <= N_CLIENTS; i++) {
+    roots_shm_disconnect(c[i]);
+  }
+
+  roots_shm_server_destroy(s);
+  failed |= roots_shm_connect(path) != NULL;
+
+  // Step 5: The file of a server whose process is gone is stale
+  const pid_t server = fork();
+  if(server == 0) {
+    _exit(!roots_shm_server_create(
+          path, N_CLIENTS, 2, CAPACITY, 1, 1, roots_brent, f, &r));
+  }
+  int status;
+  waitpid(server, &status, 0);
+  failed |= !WIFEXITED(status) || WEXITSTATUS(status) || roots_shm_connect(path) != NULL;
+  unlink(path);
+  return failed;
+}
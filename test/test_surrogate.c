@@ -0,0 +1,28 @@
+#include "roots.h"
+
+// Kepler's equation and its surrogate, with sin(x) replaced by the first
+// terms of its Taylor series
+double f(const double x, void *params) {
+  return x - 0.9*sin(x) - 1;
+}
+
+double s(const double x, void *params) {
+  return x - 0.9*x*(1 - x*x/6*(1 - x*x/20)) - 1;
+}
+
+int main() {
+
+  roots_params r = { 0 }, t = { 0 };
+  r.max_iters = t.max_iters = 300;
+  r.tol = t.tol = 1e-12;
+  roots_brent(f, NULL, 0, 3, &r);
+  roots_surrogate(roots_brent, f, NULL, s, NULL, 0, 3, 0.05, &t);
+  roots_info(&t);
+
+  if(t.error_key != roots_success || fabs(t.root - r.root) > 1e-12
+     || t.n_evals >= r.n_evals || !t.n_surrogate_evals) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+#include <string.h>
+
+#include "roots.h"
+
+double f(const double x, void *params) {
+  return x*x*x - *(double *)params;
+}
+
+double s(const double x, void *params) {
+  return x*x*x - 1.01 * *(double *)params;
+}
+
+int main() {
+
+  // Record a few solves
+  const char *path = "test_trace.bin";
+  roots_trace *trace = roots_trace_open(path);
+  if(!trace) {
+    return 1;
+  }
+  roots_params r[3];
+  for(int i = 0; i < 3; i++) {
+    double p = i + 2;
+    roots_params_init(&r[i]);
+    r[i].max_iters = 300;
+    r[i].tol = 1e-12;
+    r[i].trace = trace;
+    roots_brent(f, &p, 0, 3, &r[i]);
+  }
+  if(!roots_trace_close(trace)) {
+    remove(path);
+    return 1;
+  }
+
+  // Replaying the recorded method must reproduce the original solves
+  unsigned n_solves;
+  roots_trace_solve *solves = roots_trace_load(path, &n_solves);
+  remove(path);
+  if(!solves || n_solves != 3) {
+    return 1;
+  }
+  for(unsigned i = 0; i < n_solves; i++) {
+    roots_params t = { 0 };
+    t.max_iters = solves[i].max_iters;
+    t.tol = solves[i].tol;
+    roots_brent(roots_trace_replay, &solves[i], solves[i].a, solves[i].b, &t);
+    roots_info(&t);
+    if(strcmp(solves[i].method, r[i].method) || solves[i].n_evals != r[i].n_evals
+       || t.n_evals != r[i].n_evals || t.root != r[i].root
+       || solves[i].n_replayed != r[i].n_evals || solves[i].n_interpolated) {
+      return 1;
+    }
+  }
+
+  // Other methods run on interpolated values close to the function
+  roots_params t = { 0 };
+  t.max_iters = 300;
+  t.tol = 1e-12;
+  roots_bisection(roots_trace_replay, &solves[0], solves[0].a, solves[0].b, &t);
+  roots_trace_free(solves, n_solves);
+  if(t.error_key != roots_success || fabs(t.root - r[0].root) > 1e-6) {
+    return 1;
+  }
+
+  // A solve with a surrogate records the evaluations of f only, including
+  // those made to bracket the root near that of the surrogate, as one solve
+  trace = roots_trace_open(path);
+  double p = 2, q = 2;
+  roots_params u;
+  roots_params_init(&u);
+  u.max_iters = 300;
+  u.tol = 1e-12;
+  u.trace = trace;
+  if(!trace) {
+    return 1;
+  }
+  roots_surrogate(roots_brent, f, &p, s, &q, 0, 3, 0.01, &u);
+  const bool closed = roots_trace_close(trace);
+  solves = roots_trace_load(path, &n_solves);
+  remove(path);
+  if(!closed || u.error_key != roots_success) {
+    roots_trace_free(solves, solves ? n_solves : 0);
+    return 1;
+  }
+  const bool recorded = solves && n_solves == 1 && solves[0].n_evals == u.n_evals
+                        && solves[0].a == 0 && solves[0].b == 3;
+  for(unsigned i = 0; recorded && i < solves[0].n_points; i++) {
+    if(solves[0].fx[i] != f(solves[0].x[i], &p)) {
+      return 1;
+    }
+  }
+  roots_trace_free(solves, n_solves);
+  if(!recorded) {
+    return 1;
+  }
+
+  return 0;
+}
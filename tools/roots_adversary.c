@@ -0,0 +1,540 @@
+/*
+ * roots-adversary: searches for problems on which root-finding methods need
+ * many more function evaluations than usual, and keeps them in a regression
+ * corpus.
+ *
+ * Usage: roots-adversary [options] [method ...]
+ *        roots-adversary -c corpus
+ *
+ * For each method (see roots_method_from_name; default: all of them), the
+ * search samples problems from families of functions with parameters (e.g.,
+ * x^p1 - p2, or a nearly triple root), brackets, and tolerances, and climbs
+ * towards the problem with the largest cost: the number of evaluations
+ * divided by the number bisection needs, log2((b-a)/tol). Solves that do not
+ * converge within MAX_EVALS evaluations have infinite cost. The worst problem
+ * found is then minimized: its parameters, brackets, and tolerance are
+ * rounded to as few significant digits as possible while keeping at least
+ * 90% of its cost, and it is written as a corpus line
+ *   method, max_evals, tol, a, b, formula
+ * where formula (see roots_expr_compile) is the function with the parameters
+ * substituted, and max_evals is the number of evaluations the method needs
+ * plus a margin of 25% and 2 evaluations, so that a harmless change to the
+ * method or to the floating-point rounding does not fail the case. A problem
+ * on which the method does not converge is written with max_evals 0. Cases
+ * already in the corpus are not written again.
+ *
+ * The number of evaluations of the current tree is only trusted if it is not
+ * a regression: with -b, a case is checked against the budget of a baseline
+ * corpus before it is written, and reported instead if the method needs more
+ * evaluations than that budget (or does not converge). The baseline budgets
+ * are measured with a baseline build, e.g., the last release, by running
+ *   roots-adversary -c candidates -o baseline
+ * on the cases found by the current tree, written with -o candidates.
+ *
+ * With -c, the cases of the corpus are solved, and the exit status is 2 if
+ * any of them does not converge or needs more evaluations than its budget,
+ * so that a change that slows down a pathological case fails the tests.
+ * Cases with max_evals 0 are known not to converge; they are only reported
+ * if they converge now, so that they can be given a budget. With -o as well,
+ * every case is also written to that file with the budget measured now.
+ *
+ * Options:
+ *   -n n        Number of search steps per method (default: 2000).
+ *   -s seed     Seed of the random number generator (default: 1).
+ *   -m cost     Minimum cost of the cases written (default: 2).
+ *   -o corpus   Append the cases to this file instead of printing them.
+ *   -b corpus   Baseline corpus to check the cases against before writing them.
+ *   -c corpus   Check the cases of the corpus.
+ *
+ * Exit status: 0 on success, 2 if a case of the corpus fails or a case found
+ * needs more evaluations than its baseline budget, 1 on errors.
+ */
+#include <float.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "roots.h"
+
+// Evaluations allowed per solve; solves that need more do not converge
+#define MAX_EVALS 5000
+
+// Budget written for a case that needs n evaluations
+static unsigned budget_of(const unsigned n) {
+  return (unsigned)ceil(1.25 * n) + 2;
+}
+
+// Families of functions; positive ranges are sampled logarithmically
+static const struct {
+  const char *formula;
+  unsigned n_params;
+  double lo[3], hi[3];
+} families[] = {
+  { "x^p1 - p2", 2, { 2, 1e-3 }, { 30, 10 } },
+  { "(x - p1)^3 + p2*(x - p1)", 2, { -5, 1e-10 }, { 5, 1 } },
+  { "exp(p1*x) - p2", 2, { 0.1, 1e-2 }, { 50, 1e2 } },
+  { "atan(p1*(x - p2))", 2, { 1e-2, -5 }, { 1e4, 5 } },
+  { "tanh(p1*(x - p2)) + p3*(x - p2)", 3, { 1, -5, 1e-8 }, { 1e4, 5, 1 } },
+  { "(x - p1)*abs(x - p1)^p2 + p3", 3, { -5, 0.5, -1e-3 }, { 5, 10, 1e-3 } },
+  { "sin(p1*x) + p2*x - p3", 3, { 0.1, 1e-3, -5 }, { 20, 2, 5 } },
+  { "x*exp(-p1*x) - p2", 2, { 0.1, 1e-4 }, { 10, 0.3 } },
+};
+
+#define N_FAMILIES (sizeof(families) / sizeof(*families))
+
+typedef struct {
+  unsigned family;
+  double p[3];
+  double a, b, tol;
+} problem;
+
+static uint64_t rng;
+
+// Uniform random number in [0,1) (xorshift64*)
+static double uniform(void) {
+  rng ^= rng >> 12;
+  rng ^= rng << 25;
+  rng ^= rng >> 27;
+  return ((rng * 0x2545f4914f6cdd1dULL) >> 11) * 0x1.0p-53;
+}
+
+static double normal(void) {
+  return sqrt(-2 * log(1 - uniform())) * cos(2 * M_PI * uniform());
+}
+
+// Shortest decimal representation of x that reads back as x
+static void shortest(char *buf, const size_t size, const double x) {
+  if(x == trunc(x) && fabs(x) < 1e15) {
+    snprintf(buf, size, "%.0f", x);
+    return;
+  }
+  for(int k = 1; k <= 17; k++) {
+    snprintf(buf, size, "%.*g", k, x);
+    if(strtod(buf, NULL) == x) {
+      return;
+    }
+  }
+}
+
+// Rounds x to k significant digits
+static double round_digits(const double x, const int k) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.*g", k, x);
+  return strtod(buf, NULL);
+}
+
+/*
+ * Function   : substitute
+ * Author     : Leo Werneck
+ *
+ * Writes the formula of a problem with its parameters substituted; a negative
+ * parameter after a + or - flips the sign, and is parenthesized otherwise.
+ *
+ * Parameters : pb       - Problem.
+ *            : buf      - Formula (output).
+ *            : size     - Size of buf.
+ *
+ * Returns    : Nothing.
+ */
+static void substitute(const problem *pb, char *buf, const size_t size) {
+
+  const char *s = families[pb->family].formula;
+  size_t n = 0;
+  while(*s && n + 40 < size) {
+    if(s[0] == 'p' && s[1] >= '1' && s[1] <= '3') {
+      char num[32];
+      double p = pb->p[s[1] - '1'];
+      const bool after_sign
+            = n >= 2 && (buf[n - 2] == '+' || buf[n - 2] == '-') && buf[n - 1] == ' ';
+      if(p < 0 && after_sign) {
+        buf[n - 2] = buf[n - 2] == '+' ? '-' : '+';
+        p = -p;
+      }
+      shortest(num, sizeof(num), p);
+      n += snprintf(buf + n, size - n, p < 0 ? "(%s)" : "%s", num);
+      s += 2;
+    }
+    else {
+      buf[n++] = *s++;
+    }
+  }
+  buf[n] = '\0';
+}
+
+/*
+ * Function   : solve
+ * Author     : Leo Werneck
+ *
+ * Solves a formula with a method.
+ *
+ * Parameters : method   - Method.
+ *            : e        - Compiled formula.
+ *            : p        - Values of its parameters.
+ *            : a, b     - Interval.
+ *            : tol      - Tolerance.
+ *            : max_evals - Maximum number of evaluations.
+ *            : n_evals  - Number of evaluations (output).
+ *
+ * Returns    : The error key returned by the method.
+ */
+static roots_error_t solve(
+      roots_method method,
+      const roots_expr *e,
+      const double *p,
+      const double a,
+      const double b,
+      const double tol,
+      const unsigned max_evals,
+      unsigned *n_evals) {
+
+  roots_params r;
+  roots_params_init(&r);
+  r.tol = tol;
+  r.max_iters = 100000;
+  r.max_evals = max_evals;
+  roots_expr_params ep = { e, p };
+  method(roots_expr_f, &ep, a, b, &r);
+  *n_evals = r.n_evals;
+  return r.error_key;
+}
+
+/*
+ * Function   : cost
+ * Author     : Leo Werneck
+ *
+ * Cost of a problem for a method: the number of evaluations divided by the
+ * number bisection needs.
+ *
+ * Parameters : method   - Method.
+ *            : exprs    - Compiled formulas of the families.
+ *            : pb       - Problem.
+ *            : n_evals  - Number of evaluations (output).
+ *
+ * Returns    : The cost, -1 if the problem is not bracketed, or infinity if
+ *              the method does not converge.
+ */
+static double cost(
+      roots_method method,
+      roots_expr **exprs,
+      const problem *pb,
+      unsigned *n_evals) {
+
+  if(!(pb->a < pb->b)) {
+    return -1;
+  }
+  const roots_error_t key = solve(
+        method, exprs[pb->family], pb->p, pb->a, pb->b, pb->tol, MAX_EVALS, n_evals);
+  if(key == roots_error_root_not_bracketed) {
+    return -1;
+  }
+  if(key != roots_success) {
+    return INFINITY;
+  }
+  return *n_evals / fmax(1, log2((pb->b - pb->a) / pb->tol));
+}
+
+static void sample(problem *pb) {
+  pb->family = uniform() * N_FAMILIES;
+  for(unsigned i = 0; i < families[pb->family].n_params; i++) {
+    const double lo = families[pb->family].lo[i], hi = families[pb->family].hi[i];
+    pb->p[i] = lo > 0 ? lo * pow(hi / lo, uniform()) : lo + (hi - lo) * uniform();
+  }
+  pb->a = -20 + 20 * uniform();
+  pb->b = 20 * uniform();
+  pb->tol = pow(10, -4 - 11 * uniform());
+}
+
+static void mutate(problem *pb) {
+  const unsigned n = families[pb->family].n_params;
+  const unsigned i = uniform() * (n + 3);
+  if(i < n) {
+    const double lo = families[pb->family].lo[i], hi = families[pb->family].hi[i];
+    pb->p[i] = lo > 0 ? pb->p[i] * exp(0.3 * normal())
+                      : pb->p[i] + 0.05 * (hi - lo) * normal();
+    pb->p[i] = fmin(hi, fmax(lo, pb->p[i]));
+  }
+  else if(i == n) {
+    pb->a += 0.1 * (pb->b - pb->a) * normal();
+  }
+  else if(i == n + 1) {
+    pb->b += 0.1 * (pb->b - pb->a) * normal();
+  }
+  else {
+    pb->tol = fmin(1e-4, fmax(1e-15, pb->tol * pow(10, normal())));
+  }
+}
+
+/*
+ * Function   : minimize
+ * Author     : Leo Werneck
+ *
+ * Rounds the parameters, interval, and tolerance of a problem to as few
+ * significant digits as possible while keeping at least 90% of its cost.
+ *
+ * Parameters : method   - Method.
+ *            : exprs    - Compiled formulas of the families.
+ *            : pb       - Problem (input and output).
+ *
+ * Returns    : Nothing.
+ */
+static void minimize(roots_method method, roots_expr **exprs, problem *pb) {
+
+  unsigned n_evals;
+  const double target = 0.9 * cost(method, exprs, pb, &n_evals);
+  double *values[6] = { &pb->tol, &pb->a, &pb->b, &pb->p[0], &pb->p[1], &pb->p[2] };
+  for(unsigned v = 0; v < 3 + families[pb->family].n_params; v++) {
+    const double x = *values[v];
+    for(int k = 1; k < 17; k++) {
+      *values[v] = round_digits(x, k);
+      if(cost(method, exprs, pb, &n_evals) >= target) {
+        break;
+      }
+      *values[v] = x;
+    }
+  }
+}
+
+/*
+ * Function   : check
+ * Author     : Leo Werneck
+ *
+ * Solves the cases of a corpus and reports those that fail, and the known
+ * non-converging cases (max_evals 0) that converge now.
+ *
+ * Parameters : path     - Path to the corpus.
+ *            : output   - File to which the cases are appended with the
+ *                         budgets measured now, or NULL.
+ *
+ * Returns    : 0 if all cases pass, 2 if any fails, 1 on errors.
+ */
+static int check(const char *path, const char *output) {
+
+  FILE *fp = fopen(path, "r");
+  if(!fp) {
+    perror(path);
+    return 1;
+  }
+  FILE *out = output ? fopen(output, "a") : NULL;
+  if(output && !out) {
+    perror(output);
+    fclose(fp);
+    return 1;
+  }
+  char line[1024];
+  unsigned n_cases = 0, n_failed = 0;
+  while(fgets(line, sizeof(line), fp)) {
+    char name[64];
+    unsigned budget;
+    double tol, a, b;
+    int tail, pos;
+    if(line[0] == '#' || line[0] == '\n') {
+      continue;
+    }
+    line[strcspn(line, "\n")] = '\0';
+    if(sscanf(
+             line, " %63[^,], %u, %n%lf, %lf, %lf, %n", name, &budget, &tail, &tol, &a,
+             &b, &pos)
+       != 5) {
+      fprintf(stderr, "%s: cannot parse: %s\n", path, line);
+      n_failed++;
+      continue;
+    }
+    roots_method method = roots_method_from_name(name);
+    roots_expr *e = roots_expr_compile(line + pos, 0, NULL, NULL);
+    unsigned n_evals = 0;
+    const unsigned max_evals = budget ? budget + 1 : MAX_EVALS;
+    roots_error_t key = roots_continue;
+    if(method && e) {
+      key = solve(method, e, NULL, a, b, tol, max_evals, &n_evals);
+    }
+    if(out && method && e) {
+      if(budget && key != roots_success) {
+        key = solve(method, e, NULL, a, b, tol, MAX_EVALS, &n_evals);
+      }
+      const unsigned measured = key == roots_success ? budget_of(n_evals) : 0;
+      fprintf(out, "%s, %u, %s\n", name, measured, line + tail);
+    }
+    if(!budget && method && e) {
+      if(key == roots_success) {
+        fprintf(stderr, "%s: converges now in %u evaluations (budget %u): %s\n", path,
+                n_evals, budget_of(n_evals), line);
+      }
+    }
+    else if(key != roots_success || n_evals > budget) {
+      fprintf(stderr, "%s: %u evaluations (budget %u), error key %d: %s\n", path,
+              n_evals, budget, key, line);
+      n_failed++;
+    }
+    roots_expr_free(e);
+    n_cases++;
+  }
+  fclose(fp);
+  if(out) {
+    fclose(out);
+  }
+  printf("%u cases, %u failed\n", n_cases, n_failed);
+  return n_failed ? 2 : 0;
+}
+
+// Budget of a case (everything after the budget) in a corpus, or -1 if the
+// case is not in the corpus
+static long corpus_budget(const char *path, const char *name, const char *tail) {
+
+  FILE *fp = path ? fopen(path, "r") : NULL;
+  if(!fp) {
+    return -1;
+  }
+  char line[1024], other[64];
+  long budget = -1;
+  while(budget < 0 && fgets(line, sizeof(line), fp)) {
+    unsigned n;
+    int pos = -1;
+    line[strcspn(line, "\n")] = '\0';
+    sscanf(line, " %63[^,], %u, %n", other, &n, &pos);
+    if(pos >= 0 && !strcmp(other, name) && !strcmp(line + pos, tail)) {
+      budget = n;
+    }
+  }
+  fclose(fp);
+  return budget;
+}
+
+int main(int argc, char **argv) {
+
+  // Step 1: Parse the command line
+  const char *output = NULL, *baseline = NULL, *corpus = NULL;
+  long n_steps = 2000;
+  double min_cost = 2;
+  rng = 1;
+  int opt;
+  while((opt = getopt(argc, argv, "n:s:m:o:b:c:")) != -1) {
+    switch(opt) {
+      case 'n':
+        n_steps = atol(optarg);
+        break;
+      case 's':
+        rng = strtoull(optarg, NULL, 10);
+        break;
+      case 'm':
+        min_cost = atof(optarg);
+        break;
+      case 'o':
+        output = optarg;
+        break;
+      case 'b':
+        baseline = optarg;
+        break;
+      case 'c':
+        corpus = optarg;
+        break;
+      default:
+        fprintf(stderr,
+                "Usage: %s [-n steps] [-s seed] [-m min_cost] [-o corpus] [-b corpus] "
+                "[method ...]\n"
+                "       %s -c corpus [-o corpus]\n",
+                argv[0], argv[0]);
+        return 1;
+    }
+  }
+  if(corpus) {
+    return check(corpus, output);
+  }
+  rng = rng * 0x9e3779b97f4a7c15ULL + 1;
+
+  // Step 2: Compile the families
+  roots_expr *exprs[N_FAMILIES];
+  for(unsigned i = 0; i < N_FAMILIES; i++) {
+    exprs[i] = roots_expr_compile(families[i].formula, families[i].n_params, NULL, NULL);
+  }
+
+  // Step 3: Search every method
+  unsigned n_regressions = 0;
+  static const char *all[] = {
+    "bisection", "secant", "false_position", "illinois", "pegasus", "anderson_bjorck",
+    "dekker", "ridder", "brent", "toms748", "steffensen", "muller", "multipoint",
+    "hybrid", "bisection_fixed", "ridder_fixed", "chandrupatla_fixed"
+  };
+  const int n_methods
+        = optind < argc ? argc - optind : (int)(sizeof(all) / sizeof(*all));
+  for(int m = 0; m < n_methods; m++) {
+    const char *name = optind < argc ? argv[optind + m] : all[m];
+    roots_method method = roots_method_from_name(name);
+    if(!method) {
+      fprintf(stderr, "%s: unknown method %s\n", argv[0], name);
+      return 1;
+    }
+
+    // Step 3.a: Random sampling for the first quarter of the steps, then
+    //           hill climbing from the worst problem found
+    problem best;
+    sample(&best);
+    double best_cost = -1;
+    unsigned n_evals;
+    for(long step = 0; step < n_steps; step++) {
+      problem pb = best;
+      if(step < n_steps / 4 || best_cost < 0) {
+        sample(&pb);
+      }
+      else {
+        mutate(&pb);
+      }
+      const double c = cost(method, exprs, &pb, &n_evals);
+      if(c > best_cost) {
+        best = pb;
+        best_cost = c;
+      }
+    }
+    if(best_cost < min_cost) {
+      fprintf(stderr, "%-20s worst cost %.2f, not written\n", name, best_cost);
+      continue;
+    }
+
+    // Step 3.b: Minimize the problem, measuring the budget with the formula
+    //           as written
+    minimize(method, exprs, &best);
+    char formula[512], tol[32], a[32], b[32], tail[640];
+    substitute(&best, formula, sizeof(formula));
+    shortest(tol, sizeof(tol), best.tol);
+    shortest(a, sizeof(a), best.a);
+    shortest(b, sizeof(b), best.b);
+    snprintf(tail, sizeof(tail), "%s, %s, %s, %s", tol, a, b, formula);
+    roots_expr *e = roots_expr_compile(formula, 0, NULL, NULL);
+    if(!e) {
+      continue;
+    }
+    const roots_error_t key
+          = solve(method, e, NULL, best.a, best.b, best.tol, MAX_EVALS, &n_evals);
+    roots_expr_free(e);
+    if(key == roots_error_root_not_bracketed) {
+      continue;
+    }
+    const bool converged = key == roots_success;
+    const double bits = fmax(1, log2((best.b - best.a) / best.tol));
+    const double c = converged ? n_evals / bits : INFINITY;
+    fprintf(stderr, "%-20s worst cost %.2f (%u evaluations): %s\n", name, c, n_evals,
+            tail);
+    if(corpus_budget(output, name, tail) >= 0) {
+      continue;
+    }
+
+    // Step 3.c: Check the case against its baseline budget and write it
+    const long base = corpus_budget(baseline, name, tail);
+    if(base > 0 && (!converged || n_evals > base)) {
+      fprintf(stderr, "%-20s exceeds the baseline budget %ld, not written\n", name, base);
+      n_regressions++;
+      continue;
+    }
+    FILE *fp = output ? fopen(output, "a") : stdout;
+    if(!fp) {
+      perror(output);
+      return 1;
+    }
+    fprintf(fp, "%s, %u, %s\n", name, converged ? budget_of(n_evals) : 0, tail);
+    if(output) {
+      fclose(fp);
+    }
+  }
+  for(unsigned i = 0; i < N_FAMILIES; i++) {
+    roots_expr_free(exprs[i]);
+  }
+  return n_regressions ? 2 : 0;
+}
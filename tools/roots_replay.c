@@ -0,0 +1,137 @@
+/*
+ * roots-replay: re-runs root-finding methods on the solves recorded in a
+ * trace file (see roots_trace_open), without the original function.
+ *
+ * Usage: roots-replay [options] trace [method ...]
+ *
+ * Each method (see roots_method_from_name; default: brent) solves every
+ * recorded solve, with its recorded interval, tolerance, and bisection mode,
+ * using roots_trace_replay as the function: points that were evaluated in the
+ * original solve are served their recorded values, other points are
+ * interpolated. For each method, the total number of function evaluations and
+ * iterations, the time per solve, the largest difference between its roots
+ * and the recorded point with the smallest residual, and the fraction of
+ * evaluations that had to be interpolated are reported, next to the number of
+ * evaluations recorded in the trace. Results for interpolated evaluations are
+ * only as good as the interpolation, so methods are best compared on traces
+ * of solves that sampled the function densely enough.
+ *
+ * Options:
+ *   -t tol      Tolerance (default: the recorded one).
+ *   -i n        Maximum number of iterations (default: the recorded one).
+ *   -r n        Number of repetitions for timing (default: 1).
+ *
+ * Exit status: 0 on success, 1 on errors.
+ */
+#include <string.h>
+#include <unistd.h>
+
+#include "roots.h"
+
+// Recorded point with the smallest residual
+static double best_point(const roots_trace_solve *s) {
+
+  double x = NAN, fx = INFINITY;
+  for(unsigned i = 0; i < s->n_points; i++) {
+    if(fabs(s->fx[i]) < fx) {
+      x = s->x[i];
+      fx = fabs(s->fx[i]);
+    }
+  }
+  return x;
+}
+
+static void usage(const char *name) {
+  fprintf(
+        stderr,
+        "Usage: %s [-t tol] [-i max_iters] [-r repetitions] trace [method ...]\n",
+        name);
+}
+
+int main(int argc, char **argv) {
+
+  // Step 1: Parse the options
+  double tol = 0;
+  unsigned max_iters = 0, repetitions = 1;
+  int opt;
+  while((opt = getopt(argc, argv, "t:i:r:")) != -1) {
+    switch(opt) {
+      case 't':
+        tol = atof(optarg);
+        break;
+      case 'i':
+        max_iters = atoi(optarg);
+        break;
+      case 'r':
+        repetitions = atoi(optarg);
+        break;
+      default:
+        usage(argv[0]);
+        return 1;
+    }
+  }
+  if(optind >= argc || !repetitions) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  // Step 2: Load the trace
+  unsigned n_solves;
+  roots_trace_solve *solves = roots_trace_load(argv[optind], &n_solves);
+  if(!solves) {
+    fprintf(stderr, "%s: cannot read trace %s\n", argv[0], argv[optind]);
+    return 1;
+  }
+  unsigned long n_recorded = 0;
+  for(unsigned k = 0; k < n_solves; k++) {
+    n_recorded += solves[k].n_evals;
+  }
+  printf("%u solves, %lu recorded evaluations\n", n_solves, n_recorded);
+  printf("%-20s %12s %12s %12s %12s %12s\n",
+         "method", "evals", "iters", "us/solve", "max |dx|", "interpolated");
+
+  // Step 3: Replay the solves with every method
+  const int n_methods = argc - optind - 1;
+  for(int m = 0; m < (n_methods ? n_methods : 1); m++) {
+    const char *name = n_methods ? argv[optind + 1 + m] : "brent";
+    roots_method method = roots_method_from_name(name);
+    if(!method) {
+      fprintf(stderr, "%s: unknown method %s\n", argv[0], name);
+      roots_trace_free(solves, n_solves);
+      return 1;
+    }
+    unsigned long n_evals = 0, n_iters = 0, n_calls = 0, n_interpolated = 0;
+    double max_dx = 0;
+    const double t0 = roots_monotonic_time();
+    for(unsigned rep = 0; rep < repetitions; rep++) {
+      for(unsigned k = 0; k < n_solves; k++) {
+        roots_trace_solve *s = &solves[k];
+        s->n_replayed = s->n_interpolated = 0;
+        roots_params r;
+        roots_params_init(&r);
+        r.tol = tol > 0 ? tol : s->tol;
+        r.max_iters = max_iters ? max_iters : s->max_iters;
+        r.bisect = s->bisect;
+        method(roots_trace_replay, s, s->a, s->b, &r);
+        if(rep) {
+          continue;
+        }
+        n_evals += r.n_evals;
+        n_iters += r.n_iters;
+        n_calls += s->n_replayed;
+        n_interpolated += s->n_interpolated;
+        const double dx = fabs(r.root - best_point(s));
+        if(r.error_key == roots_success && dx > max_dx) {
+          max_dx = dx;
+        }
+      }
+    }
+    const double t = (roots_monotonic_time() - t0) / repetitions;
+    printf("%-20s %12lu %12lu %12.3f %12.3e %11.1f%%\n",
+           name, n_evals, n_iters, n_solves ? 1e6 * t / n_solves : 0.0, max_dx,
+           n_calls ? 100.0 * n_interpolated / n_calls : 0.0);
+  }
+
+  roots_trace_free(solves, n_solves);
+  return 0;
+}
@@ -0,0 +1,172 @@
+/*
+ * roots-server: node-local solver server. Processes on the same machine,
+ * e.g., the MPI ranks of a node, connect to it with roots_shm_connect and
+ * submit batches of problems through shared memory (see
+ * roots_shm_server_create); the server solves them with a pool of worker
+ * threads, using a function f loaded from a shared object.
+ *
+ * Usage: roots-server [options] plugin path
+ *
+ * The plugin must export
+ *   double roots_f(const double x, void *restrict params);
+ * where params points to the parameters of the problem, and the number of
+ * parameters is given by the option -p or by an exported
+ *   const unsigned roots_n_params;
+ * The shared memory is the file path, preferably in /dev/shm. The server runs
+ * until it receives SIGINT or SIGTERM, and reports the batches, problems,
+ * and throughput (problems per second) of every client periodically and at
+ * the end.
+ *
+ * Options:
+ *   -m method   Method name (see roots_method_from_name; default: brent).
+ *   -p n        Number of parameters per problem (default: roots_n_params,
+ *               or 0).
+ *   -t tol      Tolerance (default: 1e-12).
+ *   -i n        Maximum number of iterations (default: 1000).
+ *   -j n        Number of worker threads (default: number of online
+ *               processors).
+ *   -c n        Maximum number of clients (default: 64).
+ *   -s n        Batch slots per client (default: 4).
+ *   -n n        Maximum number of problems per batch (default: 4096).
+ *   -r seconds  Report interval; 0 reports at the end only (default: 10).
+ *
+ * Exit status: 0 on success, 1 on errors.
+ */
+#include <dlfcn.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "roots.h"
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "Usage: %s [-m method] [-p n_params] [-t tol] [-i max_iters] [-j threads] "
+          "[-c clients] [-s slots] [-n capacity] [-r seconds] plugin path\n",
+          prog);
+}
+
+// Prints the counters of the clients that have connected
+static void report(roots_shm_server *s, const unsigned n_clients) {
+  for(unsigned i = 0; i < n_clients; i++) {
+    roots_shm_stats st;
+    if(roots_shm_server_get_stats(s, i, &st)) {
+      printf("client %3u %-12s %10lu batches %12lu problems %12.4e problems/s "
+             "%10.3f s busy\n",
+             i, st.connected ? "connected" : "disconnected", (unsigned long)st.n_batches,
+             (unsigned long)st.n_problems, st.throughput, st.busy);
+    }
+  }
+  fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+
+  // Step 1: Parse the command line
+  const char *method_name = "brent";
+  long n_params = -1, n_threads = sysconf(_SC_NPROCESSORS_ONLN);
+  long n_clients = 64, n_slots = 4, capacity = 4096;
+  double interval = 10;
+  roots_params r = { 0 };
+  r.tol = 1e-12;
+  r.max_iters = 1000;
+  int opt;
+  while((opt = getopt(argc, argv, "m:p:t:i:j:c:s:n:r:")) != -1) {
+    switch(opt) {
+      case 'm':
+        method_name = optarg;
+        break;
+      case 'p':
+        n_params = atol(optarg);
+        break;
+      case 't':
+        r.tol = atof(optarg);
+        break;
+      case 'i':
+        r.max_iters = atoi(optarg);
+        break;
+      case 'j':
+        n_threads = atol(optarg);
+        break;
+      case 'c':
+        n_clients = atol(optarg);
+        break;
+      case 's':
+        n_slots = atol(optarg);
+        break;
+      case 'n':
+        capacity = atol(optarg);
+        break;
+      case 'r':
+        interval = atof(optarg);
+        break;
+      default:
+        usage(argv[0]);
+        return 1;
+    }
+  }
+  if(argc - optind != 2 || n_threads < 1 || n_clients < 1 || n_slots < 1
+     || capacity < 1) {
+    usage(argv[0]);
+    return 1;
+  }
+  const char *plugin = argv[optind], *path = argv[optind + 1];
+
+  // Step 2: Load the plugin and select the method
+  void *handle = dlopen(plugin, RTLD_NOW | RTLD_LOCAL);
+  if(!handle) {
+    fprintf(stderr, "%s: %s\n", argv[0], dlerror());
+    return 1;
+  }
+  double (*f)(const double, void *restrict)
+        = (double (*)(const double, void *restrict))dlsym(handle, "roots_f");
+  const unsigned *np = (const unsigned *)dlsym(handle, "roots_n_params");
+  if(!f) {
+    fprintf(stderr, "%s: %s does not export roots_f\n", argv[0], plugin);
+    return 1;
+  }
+  roots_method method = roots_method_from_name(method_name);
+  if(!method) {
+    fprintf(stderr, "%s: unknown method %s\n", argv[0], method_name);
+    return 1;
+  }
+
+  // Step 3: Start the server. The signals are blocked before the workers
+  //         are created, so that only sigtimedwait receives them.
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, NULL);
+  const unsigned n_problem_params = n_params >= 0 ? (unsigned)n_params : (np ? *np : 0);
+  roots_shm_server *s = roots_shm_server_create(
+        path, n_clients, n_slots, capacity, n_problem_params, n_threads, method, f, &r);
+  if(!s) {
+    fprintf(stderr, "%s: cannot create the server at %s\n", argv[0], path);
+    return 1;
+  }
+  fprintf(stderr, "%s: serving at %s with %ld threads\n", argv[0], path, n_threads);
+
+  // Step 4: Report until stopped
+  while(true) {
+    int sig;
+    if(interval > 0) {
+      const struct timespec timeout = { (time_t)interval,
+                                        (long)(1e9 * (interval - (time_t)interval)) };
+      sig = sigtimedwait(&signals, NULL, &timeout);
+    }
+    else {
+      sig = sigwaitinfo(&signals, NULL);
+    }
+    if(sig == SIGINT || sig == SIGTERM) {
+      break;
+    }
+    if(interval > 0) {
+      report(s, n_clients);
+    }
+  }
+  report(s, n_clients);
+  roots_shm_server_destroy(s);
+  dlclose(handle);
+  return 0;
+}
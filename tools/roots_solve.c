@@ -0,0 +1,619 @@
+/*
+ * roots-solve: solves f(x;p) = 0 for every row of a large input file, using a
+ * function f loaded from a shared object.
+ *
+ * Usage: roots-solve [options] plugin input output
+ *        roots-solve [options] -e formula input output
+ *
+ * The function is either a formula (see roots_expr_compile) in x and the
+ * parameters p1, ..., pn, or it comes from a plugin, which must export at
+ * least one of
+ *   double roots_f(const double x, void *restrict params);
+ *   void roots_fv(const unsigned n, const double *restrict x,
+ *                 void *restrict params, double *restrict fx);
+ * where params points to the parameters of the row (roots_f) or to those of n
+ * consecutive rows, n_params doubles per row (roots_fv). The number of
+ * parameters is given by the option -p or by an exported
+ *   const unsigned roots_n_params;
+ * Each row of the input is "a, b, p_1, ..., p_n", either as raw doubles or as
+ * comma-separated text (at most 1023 bytes per line), and each row of the
+ * output is "root, error key, function evaluations", either as a 16 byte
+ * record (double, int32, uint32) or as text. Roots of rows that do not
+ * bracket a root are NAN. Pass - as the output to write to the standard
+ * output.
+ *
+ * The input is memory-mapped and processed in chunks: the rows of a chunk are
+ * parsed and solved in parallel while a writer thread writes the results of
+ * the previous chunk, so memory use is bounded by two chunks. The number of
+ * rows solved per second is reported at the end.
+ *
+ * Options:
+ *   -m method   Method name (see roots_method_from_name), or one of
+ *               bisection_batch, ridder_batch, chandrupatla_batch (default:
+ *               brent). Batch methods solve all rows of a task in lockstep.
+ *   -p n        Number of parameters per row (default: roots_n_params, or 0).
+ *   -t tol      Tolerance (default: 1e-12).
+ *   -i n        Maximum number of iterations (default: 1000).
+ *   -j n        Number of threads (default: number of online processors).
+ *   -c n        Rows per chunk (default: 65536).
+ *   -f format   Input and output format, binary or csv (default: csv if the
+ *               input name ends in .csv, binary otherwise).
+ *   -e formula  Formula for f, used instead of a plugin.
+ *
+ * Exit status: 0 if all rows are solved, 2 if any row fails, 1 on errors.
+ */
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "roots.h"
+
+// Size of an output row: binary record, or upper bound on the text length
+#define RECORD_SIZE 16
+#define LINE_SIZE 64
+
+// Size of the buffer a text input row is parsed from; longer rows are errors
+#define MAX_LINE 1024
+
+typedef roots_error_t (*batch_method)(
+      roots_vector_function fv,
+      void *restrict params,
+      const unsigned n,
+      const double *restrict a,
+      const double *restrict b,
+      double *restrict root,
+      roots_params *restrict r);
+
+static const struct {
+  const char *name;
+  batch_method method;
+} batch_methods[] = {
+  { "bisection_batch", roots_bisection_batch },
+  { "ridder_batch", roots_ridder_batch },
+  { "chandrupatla_batch", roots_chandrupatla_batch },
+};
+
+// Results of one chunk, ready to be written
+typedef struct {
+  char *out;
+  struct iovec *iov;
+  size_t n_failed;
+  bool pending;
+} chunk_buffer;
+
+typedef struct {
+  // Plugin and solver
+  double (*f)(const double, void *restrict);
+  roots_vector_function fv;
+  roots_method method;
+  batch_method batch;
+  unsigned n_params, max_iters;
+  double tol;
+  bool csv;
+
+  // Input and current chunk
+  const char *in;
+  size_t row_size;
+  const char **lines;
+  size_t row0, n_rows;
+  unsigned n_tasks;
+  double *a, *b, *p, *root;
+  int32_t *key;
+  uint32_t *n_evals;
+  chunk_buffer *buf;
+
+  // Writer thread
+  chunk_buffer *bufs; // Both chunk buffers
+  int fd;
+  bool done, failed;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+} context;
+
+// Used to adapt the plugin function to the form required by the method
+static double (*plugin_f)(const double, void *restrict);
+static roots_vector_function plugin_fv;
+static unsigned plugin_n_params;
+static roots_expr *formula;
+
+static double formula_f(const double x, void *restrict p) {
+  roots_expr_params ep = { formula, (const double *)p };
+  return roots_expr_f(x, &ep);
+}
+
+static double scalar_from_vector(const double x, void *restrict p) {
+  double fx;
+  plugin_fv(1, &x, p, &fx);
+  return fx;
+}
+
+static void vector_from_scalar(
+      const unsigned n,
+      const double *restrict x,
+      void *restrict p,
+      double *restrict fx) {
+  for(unsigned i = 0; i < n; i++) {
+    fx[i] = plugin_f(x[i], (double *)p + (size_t)i * plugin_n_params);
+  }
+}
+
+/*
+ * Function   : parse_row
+ * Author     : Leo Werneck
+ *
+ * Reads the values of one row of the input. Missing or malformed text fields
+ * are set to NAN, which makes the row fail with an unbracketed root.
+ *
+ * Parameters : ctx      - Context.
+ *            : i        - Row index within the current chunk.
+ *            : v        - Values a, b, p_1, ..., p_n (output).
+ *
+ * Returns    : Nothing.
+ */
+static void parse_row(const context *ctx, const size_t i, double *restrict v) {
+
+  const unsigned n = 2 + ctx->n_params;
+  if(!ctx->csv) {
+    memcpy(v, ctx->in + (ctx->row0 + i) * ctx->row_size, ctx->row_size);
+    return;
+  }
+
+  // The mapped input is not NUL-terminated, so copy the line first; it fits
+  // (see next_lines)
+  char line[MAX_LINE];
+  const char *s = ctx->lines[i];
+  const char *e = memchr(s, '\n', ctx->lines[i + 1] - s);
+  const size_t len = (e ? e : ctx->lines[i + 1]) - s;
+  memcpy(line, s, len);
+  line[len] = '\0';
+
+  char *c = line;
+  for(unsigned j = 0; j < n; j++) {
+    char *end;
+    v[j] = strtod(c, &end);
+    if(end == c) {
+      v[j] = NAN;
+    }
+    c = end;
+    while(*c == ' ' || *c == '\t' || *c == ',') {
+      c++;
+    }
+  }
+}
+
+/*
+ * Function   : solve_task
+ * Author     : Leo Werneck
+ *
+ * Parses, solves, and formats one slice of the current chunk. Run by the
+ * thread pool, one task per slice.
+ *
+ * Parameters : t        - Task index.
+ *            : arg      - Context.
+ *
+ * Returns    : Nothing.
+ */
+static void solve_task(const unsigned t, void *restrict arg) {
+
+  context *ctx = (context *)arg;
+  const size_t slice = (ctx->n_rows + ctx->n_tasks - 1) / ctx->n_tasks;
+  const size_t i0 = t * slice < ctx->n_rows ? t * slice : ctx->n_rows;
+  const size_t i1 = i0 + slice < ctx->n_rows ? i0 + slice : ctx->n_rows;
+  const unsigned np = ctx->n_params;
+
+  // Step 1: Parse the rows
+  double v[2 + np];
+  for(size_t i = i0; i < i1; i++) {
+    parse_row(ctx, i, v);
+    ctx->a[i] = v[0];
+    ctx->b[i] = v[1];
+    memcpy(ctx->p + i * np, v + 2, sizeof(double) * np);
+  }
+
+  // Step 2: Solve them
+  int32_t *key = ctx->key;
+  uint32_t *n_evals = ctx->n_evals;
+  roots_params r = { 0 };
+  r.tol = ctx->tol;
+  r.max_iters = ctx->max_iters;
+  if(ctx->batch && i1 > i0) {
+    ctx->batch(ctx->fv, ctx->p + i0 * np, i1 - i0, ctx->a + i0, ctx->b + i0,
+               ctx->root + i0, &r);
+    for(size_t i = i0; i < i1; i++) {
+      key[i] = isnan(ctx->root[i]) ? roots_error_root_not_bracketed : roots_success;
+      n_evals[i] = r.n_evals;
+    }
+  }
+  else {
+    for(size_t i = i0; i < i1; i++) {
+      key[i] = ctx->method(ctx->f, ctx->p + i * np, ctx->a[i], ctx->b[i], &r);
+      ctx->root[i] = key[i] == roots_error_root_not_bracketed ? NAN : r.root;
+      n_evals[i] = r.n_evals;
+    }
+  }
+
+  // Step 3: Format the results into the slice's part of the output buffer
+  char *out = ctx->buf->out + i0 * (ctx->csv ? LINE_SIZE : RECORD_SIZE);
+  size_t len = 0, n_failed = 0;
+  for(size_t i = i0; i < i1; i++) {
+    n_failed += key[i] != roots_success;
+    if(ctx->csv) {
+      len += snprintf(out + len, LINE_SIZE, "%.17g,%d,%u\n", ctx->root[i], key[i],
+                      n_evals[i]);
+    }
+    else {
+      memcpy(out + len, &ctx->root[i], sizeof(double));
+      memcpy(out + len + 8, &key[i], sizeof(int32_t));
+      memcpy(out + len + 12, &n_evals[i], sizeof(uint32_t));
+      len += RECORD_SIZE;
+    }
+  }
+  ctx->buf->iov[t].iov_base = out;
+  ctx->buf->iov[t].iov_len = len;
+  __atomic_fetch_add(&ctx->buf->n_failed, n_failed, __ATOMIC_RELAXED);
+}
+
+/*
+ * Function   : write_all
+ * Author     : Leo Werneck
+ *
+ * Writes a list of buffers to a file descriptor, retrying partial writes.
+ *
+ * Parameters : fd       - File descriptor.
+ *            : iov      - Buffers (modified).
+ *            : n        - Number of buffers.
+ *
+ * Returns    : true on success, false on errors.
+ */
+static bool write_all(const int fd, struct iovec *iov, int n) {
+
+  while(n > 0) {
+    ssize_t w = writev(fd, iov, n);
+    if(w < 0) {
+      return false;
+    }
+    while(n > 0 && (size_t)w >= iov->iov_len) {
+      w -= iov->iov_len;
+      iov++;
+      n--;
+    }
+    if(n > 0) {
+      iov->iov_base = (char *)iov->iov_base + w;
+      iov->iov_len -= w;
+    }
+  }
+  return true;
+}
+
+/*
+ * Function   : writer
+ * Author     : Leo Werneck
+ *
+ * Main loop of the writer thread: writes the two chunk buffers alternately,
+ * as they become pending, and marks them free again.
+ *
+ * Parameters : arg      - Context.
+ *
+ * Returns    : NULL.
+ */
+static void *writer(void *arg) {
+
+  context *ctx = (context *)arg;
+  chunk_buffer *bufs = ctx->bufs;
+  for(unsigned k = 0;; k ^= 1) {
+    pthread_mutex_lock(&ctx->lock);
+    while(!bufs[k].pending && !ctx->done) {
+      pthread_cond_wait(&ctx->cond, &ctx->lock);
+    }
+    if(!bufs[k].pending) {
+      pthread_mutex_unlock(&ctx->lock);
+      break;
+    }
+    pthread_mutex_unlock(&ctx->lock);
+
+    const bool ok = write_all(ctx->fd, bufs[k].iov, ctx->n_tasks);
+
+    pthread_mutex_lock(&ctx->lock);
+    ctx->failed |= !ok;
+    bufs[k].pending = false;
+    pthread_cond_broadcast(&ctx->cond);
+    pthread_mutex_unlock(&ctx->lock);
+  }
+  return NULL;
+}
+
+/*
+ * Function   : next_lines
+ * Author     : Leo Werneck
+ *
+ * Finds the starts of up to n non-empty, non-comment (#) lines of text. The
+ * search stops at the first of these lines that does not fit in MAX_LINE
+ * bytes, without counting it.
+ *
+ * Parameters : s        - Start of the text.
+ *            : end      - End of the text.
+ *            : n        - Maximum number of lines.
+ *            : lines    - Line starts; lines[k] is set to the end of the last
+ *                         line found, k being the number of lines (output).
+ *            : too_long - Whether the search stopped at a line that is too
+ *                         long (output).
+ *
+ * Returns    : The number of lines found.
+ */
+static size_t next_lines(
+      const char *s,
+      const char *end,
+      const size_t n,
+      const char **lines,
+      bool *too_long) {
+
+  size_t k = 0;
+  *too_long = false;
+  while(k < n && s < end) {
+    const char *e = memchr(s, '\n', end - s);
+    const size_t len = (e ? e : end) - s;
+    e = e ? e + 1 : end;
+    const char *c = s;
+    while(c < e && (*c == ' ' || *c == '\t' || *c == '\r')) {
+      c++;
+    }
+    if(c < e && *c != '\n' && *c != '#') {
+      if(len >= MAX_LINE) {
+        *too_long = true;
+        break;
+      }
+      lines[k++] = s;
+    }
+    s = e;
+  }
+  lines[k] = s;
+  return k;
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "Usage: %s [-m method] [-p n_params] [-t tol] [-i max_iters] [-j threads] "
+          "[-c chunk] [-f binary|csv] (plugin | -e formula) input output\n",
+          prog);
+}
+
+int main(int argc, char **argv) {
+
+  // Step 1: Parse the command line
+  const char *method_name = "brent", *format = NULL, *expr = NULL;
+  long n_params = -1, n_threads = sysconf(_SC_NPROCESSORS_ONLN), chunk = 65536;
+  context ctx = { 0 };
+  ctx.tol = 1e-12;
+  ctx.max_iters = 1000;
+  int opt;
+  while((opt = getopt(argc, argv, "m:p:t:i:j:c:f:e:")) != -1) {
+    switch(opt) {
+      case 'm':
+        method_name = optarg;
+        break;
+      case 'p':
+        n_params = atol(optarg);
+        break;
+      case 't':
+        ctx.tol = atof(optarg);
+        break;
+      case 'i':
+        ctx.max_iters = atoi(optarg);
+        break;
+      case 'j':
+        n_threads = atol(optarg);
+        break;
+      case 'c':
+        chunk = atol(optarg);
+        break;
+      case 'f':
+        format = optarg;
+        break;
+      case 'e':
+        expr = optarg;
+        break;
+      default:
+        usage(argv[0]);
+        return 1;
+    }
+  }
+  if(argc - optind != 3 - !!expr || n_threads < 1 || chunk < 1) {
+    usage(argv[0]);
+    return 1;
+  }
+  const char *plugin = expr ? NULL : argv[optind++];
+  const char *input = argv[optind], *output = argv[optind + 1];
+  const size_t n_in = strlen(input);
+  ctx.csv = format ? !strcmp(format, "csv")
+                   : n_in > 4 && !strcmp(input + n_in - 4, ".csv");
+  if(format && !ctx.csv && strcmp(format, "binary")) {
+    fprintf(stderr, "%s: unknown format %s\n", argv[0], format);
+    return 1;
+  }
+
+  // Step 2: Compile the formula or load the plugin, and select the method
+  void *handle = NULL;
+  const unsigned *np = NULL;
+  if(expr) {
+    int pos;
+    formula = roots_expr_compile(expr, n_params > 0 ? n_params : 0, NULL, &pos);
+    if(!formula) {
+      fprintf(stderr, "%s: syntax error in formula at: %s\n", argv[0],
+              pos >= 0 ? expr + pos : "");
+      return 1;
+    }
+    plugin_f = formula_f;
+  }
+  else {
+    handle = dlopen(plugin, RTLD_NOW | RTLD_LOCAL);
+    if(!handle) {
+      fprintf(stderr, "%s: %s\n", argv[0], dlerror());
+      return 1;
+    }
+    plugin_f = (double (*)(const double, void *restrict))dlsym(handle, "roots_f");
+    plugin_fv = (roots_vector_function)dlsym(handle, "roots_fv");
+    np = (const unsigned *)dlsym(handle, "roots_n_params");
+  }
+  if(!plugin_f && !plugin_fv) {
+    fprintf(stderr, "%s: %s exports neither roots_f nor roots_fv\n", argv[0], plugin);
+    return 1;
+  }
+  plugin_n_params = ctx.n_params = n_params >= 0 ? (unsigned)n_params : (np ? *np : 0);
+  ctx.f = plugin_f ? plugin_f : scalar_from_vector;
+  ctx.fv = plugin_fv ? plugin_fv : vector_from_scalar;
+  ctx.method = roots_method_from_name(method_name);
+  for(unsigned i = 0; i < sizeof(batch_methods) / sizeof(*batch_methods); i++) {
+    if(!strcmp(method_name, batch_methods[i].name)) {
+      ctx.batch = batch_methods[i].method;
+    }
+  }
+  if(!ctx.method && !ctx.batch) {
+    fprintf(stderr, "%s: unknown method %s\n", argv[0], method_name);
+    return 1;
+  }
+
+  // Step 3: Map the input and open the output
+  const int fd_in = open(input, O_RDONLY);
+  struct stat st;
+  if(fd_in < 0 || fstat(fd_in, &st)) {
+    perror(input);
+    return 1;
+  }
+  const size_t size = st.st_size;
+  ctx.in = size ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd_in, 0) : "";
+  close(fd_in);
+  if(ctx.in == MAP_FAILED) {
+    perror(input);
+    return 1;
+  }
+  madvise((void *)ctx.in, size, MADV_SEQUENTIAL);
+  ctx.row_size = sizeof(double) * (2 + ctx.n_params);
+  if(!ctx.csv && size % ctx.row_size) {
+    fprintf(stderr, "%s: ignoring %zu trailing bytes of %s\n", argv[0],
+            size % ctx.row_size, input);
+  }
+  ctx.fd = strcmp(output, "-") ? open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644) : 1;
+  if(ctx.fd < 0) {
+    perror(output);
+    return 1;
+  }
+
+  // Step 4: Allocate the chunk arrays and the two output buffers
+  ctx.n_tasks = n_threads;
+  ctx.a = malloc(sizeof(double) * chunk);
+  ctx.b = malloc(sizeof(double) * chunk);
+  ctx.root = malloc(sizeof(double) * chunk);
+  ctx.p = malloc(sizeof(double) * (chunk * ctx.n_params + 1));
+  ctx.key = malloc(sizeof(int32_t) * chunk);
+  ctx.n_evals = malloc(sizeof(uint32_t) * chunk);
+  ctx.lines = ctx.csv ? malloc(sizeof(char *) * (chunk + 1)) : NULL;
+  chunk_buffer bufs[2];
+  for(int k = 0; k < 2; k++) {
+    bufs[k].out = malloc((size_t)chunk * (ctx.csv ? LINE_SIZE : RECORD_SIZE));
+    bufs[k].iov = malloc(sizeof(struct iovec) * ctx.n_tasks);
+    bufs[k].pending = false;
+  }
+  roots_thread_pool *pool = roots_thread_pool_create(n_threads - 1);
+  pthread_t writer_thread;
+  pthread_mutex_init(&ctx.lock, NULL);
+  pthread_cond_init(&ctx.cond, NULL);
+  ctx.bufs = bufs;
+  pthread_create(&writer_thread, NULL, writer, &ctx);
+
+  // Step 5: Solve the input chunk by chunk. While the rows of one chunk are
+  //         solved, the results of the previous one are being written.
+  const double t0 = roots_monotonic_time();
+  const size_t n_binary = size / ctx.row_size;
+  const char *s = ctx.in;
+  size_t n_total = 0, n_failed = 0;
+  bool too_long = false;
+  for(unsigned k = 0;; k ^= 1) {
+
+    // Step 5.a: Find the rows of the next chunk
+    if(ctx.csv) {
+      ctx.n_rows = next_lines(s, ctx.in + size, chunk, ctx.lines, &too_long);
+      if(too_long) {
+        fprintf(stderr, "%s: row %zu of %s is longer than %d bytes\n", argv[0],
+                n_total + ctx.n_rows + 1, input, MAX_LINE - 1);
+        break;
+      }
+    }
+    else {
+      ctx.row0 = n_total;
+      const size_t n_left = n_binary - n_total;
+      ctx.n_rows = n_left < (size_t)chunk ? n_left : (size_t)chunk;
+    }
+    if(!ctx.n_rows) {
+      break;
+    }
+
+    // Step 5.b: Wait for the buffer to be written, then solve the chunk
+    pthread_mutex_lock(&ctx.lock);
+    while(bufs[k].pending) {
+      pthread_cond_wait(&ctx.cond, &ctx.lock);
+    }
+    pthread_mutex_unlock(&ctx.lock);
+    ctx.buf = &bufs[k];
+    ctx.buf->n_failed = 0;
+    roots_thread_pool_run(pool, ctx.n_tasks, solve_task, &ctx);
+    n_total += ctx.n_rows;
+    n_failed += ctx.buf->n_failed;
+
+    // Step 5.c: Hand the buffer to the writer; release the consumed input
+    pthread_mutex_lock(&ctx.lock);
+    bufs[k].pending = true;
+    pthread_cond_broadcast(&ctx.cond);
+    pthread_mutex_unlock(&ctx.lock);
+    const char *e = ctx.csv ? ctx.lines[ctx.n_rows] : ctx.in + n_total * ctx.row_size;
+    const size_t page = sysconf(_SC_PAGESIZE);
+    const size_t from = (s - ctx.in) / page * page, to = (e - ctx.in) / page * page;
+    if(size && to > from) {
+      madvise((void *)(ctx.in + from), to - from, MADV_DONTNEED);
+    }
+    s = e;
+  }
+
+  // Step 6: Wait for the writer, then report the throughput
+  pthread_mutex_lock(&ctx.lock);
+  ctx.done = true;
+  pthread_cond_broadcast(&ctx.cond);
+  pthread_mutex_unlock(&ctx.lock);
+  pthread_join(writer_thread, NULL);
+  const double dt = roots_monotonic_time() - t0;
+  fprintf(stderr, "%s: %zu rows in %.3f s (%.4g rows/s), %zu failed\n", argv[0], n_total,
+          dt, dt > 0 ? n_total / dt : 0.0, n_failed);
+
+  // Step 7: Clean up
+  const bool failed = ctx.failed || (ctx.fd != 1 && close(ctx.fd));
+  if(failed) {
+    perror(output);
+  }
+  roots_thread_pool_destroy(pool);
+  pthread_mutex_destroy(&ctx.lock);
+  pthread_cond_destroy(&ctx.cond);
+  for(int k = 0; k < 2; k++) {
+    free(bufs[k].out);
+    free(bufs[k].iov);
+  }
+  free(ctx.lines);
+  free(ctx.n_evals);
+  free(ctx.key);
+  free(ctx.p);
+  free(ctx.root);
+  free(ctx.b);
+  free(ctx.a);
+  if(size) {
+    munmap((void *)ctx.in, size);
+  }
+  if(handle) {
+    dlclose(handle);
+  }
+  roots_expr_free(formula);
+
+  return failed || too_long ? 1 : (n_failed ? 2 : 0);
+}